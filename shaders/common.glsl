@@ -26,9 +26,13 @@ struct Material{
     float padding2;
 };
 
-layout (set=0,binding=1, std140) uniform MaterialUBO {
-   Material materials[100];
-} materialUBO;
+//  indexed by the material's CID, grows with the number of materials
+layout (set=0,binding=1, std430) readonly buffer MaterialBuffer {
+   Material materials[];
+} materialBuffer;
+
+//  map handle of a material map that isn't set or isn't resident yet
+const uint NO_TEXTURE = 0xFFFFFFFFu;
 
 layout(push_constant) uniform PushConstants {
     mat4 matM;
@@ -0,0 +1,35 @@
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) out vec4 outAlbedo;
+layout(location = 1) out vec4 outNormal;
+layout(location = 2) out uint outMeshId;
+
+
+//  every material texture, indexed by the map handles of the material
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+
+#include "common.glsl"
+
+//  shared by the push constant and the indirect variant, they only differ in where the IDs come from
+void fillGBuffer(vec3 inNormal, vec2 inTexCoord, mat3 inTBN, uint matIndex, uint meshId) {
+    Material mat = materialBuffer.materials[matIndex];
+
+    //  the handles differ between draws of one indirect call, so indexing has to be marked non uniform
+    vec3 albedo = mat.diffuseAlbedo;
+    if (mat.diffuseAlbedoMapHandle != NO_TEXTURE)
+        albedo = texture(textures[nonuniformEXT(mat.diffuseAlbedoMapHandle)], inTexCoord).rgb;
+
+    //  cooked normal maps (BC5) only store XY, Z is reconstructed for every map so that both kinds work
+    vec3 normal = inNormal;
+    if (mat.normalMapHandle != NO_TEXTURE) {
+        vec2 normalXY = texture(textures[nonuniformEXT(mat.normalMapHandle)], inTexCoord).xy * 2.0 - 1.0;
+        vec3 tangentNormal = vec3(normalXY, sqrt(max(1.0 - dot(normalXY, normalXY), 0.0)));
+        normal = normalize(inTBN * tangentNormal);
+    }
+
+
+    outAlbedo = vec4(albedo, 1.0);
+    outNormal = vec4(normal,0.0);
+    outMeshId = meshId;
+}
@@ -0,0 +1,13 @@
+#version 450
+
+layout(location = 0) in vec3 inNormal;
+layout(location = 1) in vec2 inTexCoord;
+layout(location = 2) in mat3 inTBN;
+layout(location = 5) flat in uint inMatIndex;
+layout(location = 6) flat in uint inMeshId;
+
+#include "gbuffer.glsl"
+
+void main() {
+    fillGBuffer(inNormal, inTexCoord, inTBN, inMatIndex, inMeshId);
+}
\ No newline at end of file
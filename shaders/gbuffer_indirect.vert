@@ -0,0 +1,40 @@
+#version 450
+
+layout(location = 0) out vec3 outNormal;
+layout(location = 1) out vec2 outTexCoord;
+layout(location = 2) out mat3 outTBN;
+layout(location = 5) flat out uint outMatIndex;
+layout(location = 6) flat out uint outMeshId;
+
+
+#include "common.glsl"
+#include "vertex.glsl"
+
+struct DrawData {
+    mat4 matM;
+    mat4 matN;
+    uint matIndex;
+    uint meshId;
+};
+
+//  one entry per indirect draw, firstInstance of the draw is its index
+layout (set=2, binding=0, std430) readonly buffer DrawDataBuffer {
+    DrawData draws[];
+} drawData;
+
+void main() {
+    DrawData draw = drawData.draws[gl_InstanceIndex];
+
+    gl_Position = cameraUBO.matVP * draw.matM * vec4(inPosition.xyz,1);
+
+    outNormal = normalize(mat3(draw.matN) * getVertexNormal());
+    vec3 tangent = normalize(mat3(draw.matN) * getVertexTangent());
+
+    vec3 T = normalize(tangent - dot(tangent, outNormal) * outNormal); // Gram-Schmidt
+    vec3 B = getBitangentSign() * normalize(cross(outNormal,T));
+    outTBN = mat3(T, B, outNormal);
+
+    outTexCoord = inTexCoord;
+    outMatIndex = draw.matIndex;
+    outMeshId = draw.meshId;
+}
\ No newline at end of file
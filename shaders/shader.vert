@@ -1,25 +1,21 @@
 #version 450
 
-layout(location = 0) in vec3 inPosition;
-layout(location = 1) in vec3 inNormal;
-layout(location = 2) in vec3 inTangent;
-layout(location = 3) in vec2 inTexCoord;
-
 layout(location = 0) out vec3 outNormal;
 layout(location = 1) out vec2 outTexCoord;
 layout(location = 2) out mat3 outTBN;
 
 
 #include "common.glsl"
+#include "vertex.glsl"
 
 void main() {
-    gl_Position = cameraUBO.matVP * pcs.matM * vec4(inPosition,1);
+    gl_Position = cameraUBO.matVP * pcs.matM * vec4(inPosition.xyz,1);
 
-    outNormal = normalize(mat3(pcs.matN) * inNormal);
-    vec3 tangent = normalize(mat3(pcs.matN) * inTangent);
+    outNormal = normalize(mat3(pcs.matN) * getVertexNormal());
+    vec3 tangent = normalize(mat3(pcs.matN) * getVertexTangent());
 
     vec3 T = normalize(tangent - dot(tangent, outNormal) * outNormal); // Gram-Schmidt
-    vec3 B = normalize(cross(outNormal,T));
+    vec3 B = getBitangentSign() * normalize(cross(outNormal,T));
     outTBN = mat3(T, B, outNormal);
 
     outTexCoord = inTexCoord;
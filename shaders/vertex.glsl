@@ -0,0 +1,31 @@
+//  mesh vertex inputs, the engine picks the layout and tells the shader through the specialization constant
+layout(constant_id = 0) const bool isVertexFormatPacked = false;
+
+//  w holds the bitangent sign in the packed layout, the full layout gets 1 filled in
+layout(location = 0) in vec4 inPosition;
+layout(location = 1) in vec3 inNormal;
+layout(location = 2) in vec3 inTangent;
+layout(location = 3) in vec2 inTexCoord;
+
+vec3 octDecode(vec2 e) {
+    vec3 n = vec3(e, 1.0 - abs(e.x) - abs(e.y));
+
+    //  unfold the lower hemisphere
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+
+    return normalize(n);
+}
+
+vec3 getVertexNormal() {
+    return isVertexFormatPacked ? octDecode(inNormal.xy) : inNormal;
+}
+
+vec3 getVertexTangent() {
+    return isVertexFormatPacked ? octDecode(inTangent.xy) : inTangent;
+}
+
+float getBitangentSign() {
+    return inPosition.w * 2.0 - 1.0;
+}
@@ -0,0 +1,63 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <algorithm>
+#include <limits>
+
+#include <glm/glm.hpp>
+
+/**
+ * @brief axis aligned bounding box, an empty box has min > max
+ */
+struct Aabb {
+    glm::vec3 min{std::numeric_limits<float>::max()};
+    glm::vec3 max{std::numeric_limits<float>::lowest()};
+
+    [[nodiscard]] bool isEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+
+    [[nodiscard]] glm::vec3 getCenter() const { return (min + max) * 0.5f; }
+    [[nodiscard]] glm::vec3 getExtent() const { return (max - min) * 0.5f; }
+
+    [[nodiscard]] float getSurfaceArea() const {
+        glm::vec3 size = max - min;
+        return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+    }
+
+    [[nodiscard]] bool contains(const Aabb& other) const {
+        return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::greaterThanEqual(max, other.max));
+    }
+
+    void expand(const glm::vec3& point) {
+        min = glm::min(min, point);
+        max = glm::max(max, point);
+    }
+
+    /**
+     * @brief slab test, invDirection is 1 / the ray's direction
+     * @return distance along the ray at which it enters the box (0 if it starts inside), infinity if it misses it before maxDistance
+     */
+    [[nodiscard]] float intersectRay(const glm::vec3& origin, const glm::vec3& invDirection, float maxDistance) const {
+        glm::vec3 t0 = (min - origin) * invDirection;
+        glm::vec3 t1 = (max - origin) * invDirection;
+        glm::vec3 tNear = glm::min(t0, t1);
+        glm::vec3 tFar = glm::max(t0, t1);
+
+        float entry = std::max({tNear.x, tNear.y, tNear.z, 0.0f});
+        float exit = std::min({tFar.x, tFar.y, tFar.z, maxDistance});
+        return entry <= exit ? entry : std::numeric_limits<float>::infinity();
+    }
+
+    [[nodiscard]] static Aabb merge(const Aabb& a, const Aabb& b) { return {glm::min(a.min, b.min), glm::max(a.max, b.max)}; }
+
+    /**
+     * @return the smallest box containing this box transformed by the matrix (Arvo)
+     */
+    [[nodiscard]] Aabb transform(const glm::mat4& mat) const {
+        glm::vec3 center = glm::vec3(mat * glm::vec4(getCenter(), 1.0f));
+        glm::mat3 absMat{glm::abs(glm::vec3(mat[0])), glm::abs(glm::vec3(mat[1])), glm::abs(glm::vec3(mat[2]))};
+        glm::vec3 extent = absMat * getExtent();
+        return {center - extent, center + extent};
+    }
+};
@@ -0,0 +1,124 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "benchmarkReport.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "utils.h"
+
+namespace {
+    void writeSummary(std::ostream& out, const char* name, const BenchmarkReport::Summary& summary) {
+        out << "  \"" << name << "\": {\"count\": " << summary.count << ", \"mean\": " << summary.mean << ", \"p50\": " << summary.p50
+            << ", \"p95\": " << summary.p95 << ", \"p99\": " << summary.p99 << ", \"max\": " << summary.max << "},\n";
+    }
+}
+
+void BenchmarkReport::addFrame(double frameTime, double cpuTime) {
+    frameTimes_.emplace_back(frameTime);
+    cpuTimes_.emplace_back(cpuTime);
+}
+
+void BenchmarkReport::addMemorySample(uint64_t deviceBytes) {
+    devicePeakBytes_ = std::max(devicePeakBytes_, deviceBytes);
+}
+
+void BenchmarkReport::setInfo(std::string key, std::string value) {
+    auto entry = std::ranges::find(info_, key, &std::pair<std::string, std::string>::first);
+    if (entry != info_.end())
+        entry->second = std::move(value);
+    else
+        info_.emplace_back(std::move(key), std::move(value));
+}
+
+BenchmarkReport::Summary BenchmarkReport::summarize(std::span<const double> samples) {
+    if (samples.empty())
+        return {};
+
+    std::vector<double> sorted(samples.begin(), samples.end());
+    std::ranges::sort(sorted);
+
+    //  nearest rank, the smallest sample with at least p of all samples at or below it
+    auto percentile = [&](double p) {
+        auto rank = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+        return sorted[std::clamp<size_t>(rank, 1, sorted.size()) - 1];
+    };
+
+    return {
+        .count = static_cast<uint32_t>(sorted.size()),
+        .mean = std::accumulate(sorted.begin(), sorted.end(), 0.0) / static_cast<double>(sorted.size()),
+        .p50 = percentile(0.50),
+        .p95 = percentile(0.95),
+        .p99 = percentile(0.99),
+        .max = sorted.back()
+    };
+}
+
+uint64_t BenchmarkReport::getHostPeakBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return 0;
+    return counters.PeakWorkingSetSize;
+#else
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+
+    //  kilobytes on Linux
+    return static_cast<uint64_t>(usage.ru_maxrss) * 1024;
+#endif
+}
+
+bool BenchmarkReport::writeJson(const std::string& path) const {
+    std::filesystem::path filePath{path};
+
+    std::error_code ec;
+    if (filePath.has_parent_path())
+        std::filesystem::create_directories(filePath.parent_path(), ec);
+
+    std::ofstream out(filePath, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "WARNING: failed to create benchmark report " << path << std::endl;
+        return false;
+    }
+
+    out << std::fixed << std::setprecision(4);
+    out << "{\n";
+
+    out << "  \"info\": {";
+    for (size_t i = 0; i < info_.size(); ++i)
+        out << (i > 0 ? ", " : "") << "\"" << Utils::escapeJson(info_[i].first) << "\": \"" << Utils::escapeJson(info_[i].second) << "\"";
+    out << "},\n";
+
+    writeSummary(out, "frameTimeMs", getFrameTime());
+    writeSummary(out, "cpuTimeMs", getCpuTime());
+    writeSummary(out, "gpuTimeMs", getGpuTime());
+
+    out << "  \"memory\": {\"devicePeakBytes\": " << devicePeakBytes_ << ", \"hostPeakBytes\": " << getHostPeakBytes() << "}\n";
+    out << "}\n";
+
+    out.close();
+    if (!out) {
+        std::cerr << "WARNING: failed to write benchmark report " << path << std::endl;
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,66 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <cstdint>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief per frame timings and memory samples of a benchmark run, summarized into percentiles and written as JSON
+ *
+ * Percentiles use the nearest rank, so they are always one of the measured values. The JSON is flat enough to be
+ * compared between builds by a script, one object per metric.
+ */
+class BenchmarkReport {
+public:
+    struct Summary {
+        uint32_t count{0};
+        double mean{0.0};
+        double p50{0.0};
+        double p95{0.0};
+        double p99{0.0};
+        double max{0.0};
+    };
+
+    //  all in milliseconds, the frame time spans from one frame's start to the next one's
+    void addFrame(double frameTime, double cpuTime);
+
+    //  GPU times arrive a few frames late and only with timestamp support, they are counted separately
+    void addGpuTime(double gpuTime) { gpuTimes_.emplace_back(gpuTime); }
+
+    void addMemorySample(uint64_t deviceBytes);
+
+    //  written as strings into the "info" object, e.g. the device and the resolution
+    void setInfo(std::string key, std::string value);
+
+    [[nodiscard]] Summary getFrameTime() const { return summarize(frameTimes_); }
+    [[nodiscard]] Summary getCpuTime() const { return summarize(cpuTimes_); }
+    [[nodiscard]] Summary getGpuTime() const { return summarize(gpuTimes_); }
+
+    [[nodiscard]] uint64_t getDevicePeakBytes() const { return devicePeakBytes_; }
+
+    /**
+     * @return the process' peak resident memory since it started, 0 where it can't be queried
+     */
+    [[nodiscard]] static uint64_t getHostPeakBytes();
+
+    /**
+     * @return false if the file couldn't be written
+     */
+    bool writeJson(const std::string& path) const;
+
+    [[nodiscard]] static Summary summarize(std::span<const double> samples);
+
+private:
+    std::vector<double> frameTimes_{};
+    std::vector<double> cpuTimes_{};
+    std::vector<double> gpuTimes_{};
+
+    uint64_t devicePeakBytes_{0};
+
+    std::vector<std::pair<std::string, std::string>> info_{};
+};
@@ -0,0 +1,85 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "cameraPath.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+    constexpr const char* fileTag{"dp_camera_path"};
+}
+
+Camera::Pose CameraPath::sample(float t) const {
+    if (poses_.empty())
+        return {};
+
+    float position = std::clamp(t, 0.0f, 1.0f) * static_cast<float>(poses_.size() - 1);
+    auto first = static_cast<size_t>(position);
+    size_t second = std::min(first + 1, poses_.size() - 1);
+    float weight = position - static_cast<float>(first);
+
+    //  yaw isn't wrapped by the camera, so interpolating it linearly never takes the long way around
+    const Camera::Pose& a = poses_[first];
+    const Camera::Pose& b = poses_[second];
+    return {
+        .position = glm::mix(a.position, b.position, weight),
+        .yaw = std::lerp(a.yaw, b.yaw, weight),
+        .pitch = std::lerp(a.pitch, b.pitch, weight)
+    };
+}
+
+void CameraPath::save(const std::string& path) const {
+    std::filesystem::path filePath{path};
+
+    std::error_code ec;
+    if (filePath.has_parent_path())
+        std::filesystem::create_directories(filePath.parent_path(), ec);
+
+    std::ofstream out(filePath, std::ios::trunc);
+    if (!out.is_open())
+        throw std::runtime_error("ERROR: Failed to create camera path " + path + "!");
+
+    //  enough digits to read the floats back exactly
+    out.precision(std::numeric_limits<float>::max_digits10);
+    out << fileTag << " " << version << " " << poses_.size() << "\n";
+    for (const auto& pose : poses_)
+        out << pose.position.x << " " << pose.position.y << " " << pose.position.z << " " << pose.yaw << " " << pose.pitch << "\n";
+
+    out.close();
+    if (!out)
+        throw std::runtime_error("ERROR: Failed to write camera path " + path + "!");
+}
+
+CameraPath CameraPath::load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in.is_open())
+        throw std::runtime_error("ERROR: Failed to open camera path " + path + "!");
+
+    std::string tag{};
+    uint32_t fileVersion{0};
+    size_t poseCount{0};
+    in >> tag >> fileVersion >> poseCount;
+
+    if (!in || tag != fileTag || fileVersion != version)
+        throw std::runtime_error("ERROR: " + path + " is not a camera path of version " + std::to_string(version) + "!");
+
+    //  the count isn't trusted for allocating, a damaged header only fails once the poses run out
+    CameraPath cameraPath{};
+    for (size_t i = 0; i < poseCount; ++i) {
+        Camera::Pose pose{};
+        in >> pose.position.x >> pose.position.y >> pose.position.z >> pose.yaw >> pose.pitch;
+
+        if (!in)
+            throw std::runtime_error("ERROR: camera path " + path + " is truncated!");
+
+        cameraPath.poses_.emplace_back(pose);
+    }
+
+    return cameraPath;
+}
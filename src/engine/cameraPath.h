@@ -0,0 +1,44 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <string>
+#include <vector>
+
+#include "../scene/camera.h"
+
+/**
+ * @brief camera poses recorded once per frame, replayed by frame rather than by time so that every run renders the same views
+ *
+ * Saved as text, a header line and one pose per line (position, yaw and pitch in degrees), so short paths can be
+ * written or tweaked by hand.
+ */
+class CameraPath {
+public:
+    void add(const Camera::Pose& pose) { poses_.emplace_back(pose); }
+
+    /**
+     * @brief pose at a point of the path, interpolated between the two closest recorded poses
+     * @param t 0 is the first pose and 1 the last one, clamped
+     */
+    [[nodiscard]] Camera::Pose sample(float t) const;
+
+    [[nodiscard]] bool isEmpty() const { return poses_.empty(); }
+    [[nodiscard]] uint32_t getPoseCount() const { return static_cast<uint32_t>(poses_.size()); }
+
+    /**
+     * @throws std::runtime_error if the file can't be written
+     */
+    void save(const std::string& path) const;
+
+    /**
+     * @throws std::runtime_error if the file can't be read or isn't a camera path
+     */
+    static CameraPath load(const std::string& path);
+
+    static constexpr uint32_t version{1};
+
+private:
+    std::vector<Camera::Pose> poses_{};
+};
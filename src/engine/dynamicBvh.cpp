@@ -0,0 +1,318 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "dynamicBvh.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+uint32_t DynamicBvh::insert(const Aabb& bounds, uint32_t userData) {
+    uint32_t leaf = allocateNode();
+    nodes_[leaf].bounds = fatten(bounds);
+    nodes_[leaf].userData = userData;
+    nodes_[leaf].height = 0;
+
+    insertLeaf(leaf);
+    leafCount_ += 1;
+
+    return leaf;
+}
+
+void DynamicBvh::remove(uint32_t leaf) {
+    if (leaf >= nodes_.size() || !nodes_[leaf].isLeaf() || nodes_[leaf].height != 0)
+        throw std::runtime_error("ERROR: removing a node that isn't a leaf of the BVH!");
+
+    removeLeaf(leaf);
+    freeNode(leaf);
+    leafCount_ -= 1;
+}
+
+bool DynamicBvh::update(uint32_t leaf, const Aabb& bounds) {
+    if (nodes_[leaf].bounds.contains(bounds))
+        return false;
+
+    removeLeaf(leaf);
+    nodes_[leaf].bounds = fatten(bounds);
+    insertLeaf(leaf);
+
+    return true;
+}
+
+void DynamicBvh::clear() {
+    nodes_.clear();
+    root_ = nullNode;
+    freeList_ = nullNode;
+    leafCount_ = 0;
+}
+
+void DynamicBvh::cull(const Frustum& frustum, std::vector<uint32_t>& userData) const {
+    if (root_ == nullNode)
+        return;
+
+    uint32_t stack[traversalStackSize];
+    uint32_t stackSize{0};
+    stack[stackSize++] = root_;
+
+    while (stackSize > 0) {
+        const Node& node = nodes_[stack[--stackSize]];
+
+        Frustum::Result result = frustum.test(node.bounds);
+        if (result == Frustum::Result::outside)
+            continue;
+
+        if (node.isLeaf()) {
+            userData.emplace_back(node.userData);
+        }
+        else if (result == Frustum::Result::inside || stackSize + 2 > std::size(stack)) {
+            //  nothing below has to be tested anymore, or the stack is full and the whole subtree is kept rather than dropped
+            appendLeaves(node.child1, userData);
+            appendLeaves(node.child2, userData);
+        }
+        else {
+            stack[stackSize++] = node.child2;
+            stack[stackSize++] = node.child1;
+        }
+    }
+}
+
+void DynamicBvh::intersect(const Ray& ray, float maxDistance, std::vector<uint32_t>& userData) const {
+    if (root_ == nullNode)
+        return;
+
+    const glm::vec3 invDirection = 1.0f / ray.direction;
+
+    uint32_t stack[traversalStackSize];
+    uint32_t stackSize{0};
+    stack[stackSize++] = root_;
+
+    while (stackSize > 0) {
+        const Node& node = nodes_[stack[--stackSize]];
+
+        if (node.bounds.intersectRay(ray.origin, invDirection, maxDistance) == std::numeric_limits<float>::infinity())
+            continue;
+
+        if (node.isLeaf()) {
+            userData.emplace_back(node.userData);
+        }
+        else if (stackSize + 2 > std::size(stack)) {
+            //  the stack is full, keep the whole subtree rather than dropping it, the caller tests the leaves exactly
+            appendLeaves(node.child1, userData);
+            appendLeaves(node.child2, userData);
+        }
+        else {
+            stack[stackSize++] = node.child2;
+            stack[stackSize++] = node.child1;
+        }
+    }
+}
+
+DynamicBvh::Stats DynamicBvh::getStats() const {
+    Stats stats{
+        .leafCount = leafCount_,
+        .nodeCount = leafCount_ > 0 ? 2 * leafCount_ - 1 : 0,
+        .height = root_ != nullNode ? static_cast<uint32_t>(nodes_[root_].height) : 0,
+    };
+
+    if (root_ == nullNode)
+        return stats;
+
+    float rootArea = nodes_[root_].bounds.getSurfaceArea();
+    if (rootArea <= 0.0f)
+        return stats;
+
+    float innerArea{0.0f};
+    for (const auto& node : nodes_) {
+        if (node.height > 0)
+            innerArea += node.bounds.getSurfaceArea();
+    }
+    stats.areaRatio = innerArea / rootArea;
+
+    return stats;
+}
+
+uint32_t DynamicBvh::allocateNode() {
+    if (freeList_ == nullNode) {
+        nodes_.emplace_back();
+        return static_cast<uint32_t>(nodes_.size() - 1);
+    }
+
+    uint32_t node = freeList_;
+    freeList_ = nodes_[node].parent;
+    nodes_[node] = Node{};
+    return node;
+}
+
+void DynamicBvh::freeNode(uint32_t node) {
+    nodes_[node] = Node{.parent = freeList_};
+    freeList_ = node;
+}
+
+void DynamicBvh::insertLeaf(uint32_t leaf) {
+    if (root_ == nullNode) {
+        root_ = leaf;
+        nodes_[leaf].parent = nullNode;
+        return;
+    }
+
+    //  descend towards the sibling that increases the surface area the least, every node on the way is enlarged by the leaf
+    const Aabb leafBounds = nodes_[leaf].bounds;
+    uint32_t index = root_;
+
+    while (!nodes_[index].isLeaf()) {
+        const Node& node = nodes_[index];
+
+        float area = node.bounds.getSurfaceArea();
+        float combinedArea = Aabb::merge(node.bounds, leafBounds).getSurfaceArea();
+
+        //  cost of pairing the leaf with this node and of pushing it further down
+        float cost = 2.0f * combinedArea;
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto getDescentCost = [&](uint32_t child) {
+            const Node& childNode = nodes_[child];
+            float mergedArea = Aabb::merge(childNode.bounds, leafBounds).getSurfaceArea();
+            return childNode.isLeaf() ? mergedArea + inheritanceCost : mergedArea - childNode.bounds.getSurfaceArea() + inheritanceCost;
+        };
+
+        float cost1 = getDescentCost(node.child1);
+        float cost2 = getDescentCost(node.child2);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+
+        index = cost1 < cost2 ? node.child1 : node.child2;
+    }
+
+    uint32_t sibling = index;
+    uint32_t oldParent = nodes_[sibling].parent;
+
+    //  allocating may grow the node array, no references are held across it
+    uint32_t newParent = allocateNode();
+    nodes_[newParent].parent = oldParent;
+    nodes_[newParent].bounds = Aabb::merge(leafBounds, nodes_[sibling].bounds);
+    nodes_[newParent].height = nodes_[sibling].height + 1;
+    nodes_[newParent].child1 = sibling;
+    nodes_[newParent].child2 = leaf;
+    nodes_[sibling].parent = newParent;
+    nodes_[leaf].parent = newParent;
+
+    if (oldParent == nullNode)
+        root_ = newParent;
+    else if (nodes_[oldParent].child1 == sibling)
+        nodes_[oldParent].child1 = newParent;
+    else
+        nodes_[oldParent].child2 = newParent;
+
+    //  refit and rebalance the ancestors
+    for (index = nodes_[leaf].parent; index != nullNode; index = nodes_[index].parent) {
+        index = balance(index);
+
+        Node& node = nodes_[index];
+        node.height = 1 + std::max(nodes_[node.child1].height, nodes_[node.child2].height);
+        node.bounds = Aabb::merge(nodes_[node.child1].bounds, nodes_[node.child2].bounds);
+    }
+}
+
+void DynamicBvh::removeLeaf(uint32_t leaf) {
+    if (leaf == root_) {
+        root_ = nullNode;
+        return;
+    }
+
+    uint32_t parent = nodes_[leaf].parent;
+    uint32_t grandParent = nodes_[parent].parent;
+    uint32_t sibling = nodes_[parent].child1 == leaf ? nodes_[parent].child2 : nodes_[parent].child1;
+
+    //  the sibling takes the parent's place
+    nodes_[sibling].parent = grandParent;
+    freeNode(parent);
+
+    if (grandParent == nullNode) {
+        root_ = sibling;
+        return;
+    }
+
+    if (nodes_[grandParent].child1 == parent)
+        nodes_[grandParent].child1 = sibling;
+    else
+        nodes_[grandParent].child2 = sibling;
+
+    for (uint32_t index = grandParent; index != nullNode; index = nodes_[index].parent) {
+        index = balance(index);
+
+        Node& node = nodes_[index];
+        node.height = 1 + std::max(nodes_[node.child1].height, nodes_[node.child2].height);
+        node.bounds = Aabb::merge(nodes_[node.child1].bounds, nodes_[node.child2].bounds);
+    }
+}
+
+uint32_t DynamicBvh::balance(uint32_t a) {
+    Node& nodeA = nodes_[a];
+    if (nodeA.isLeaf() || nodeA.height < 2)
+        return a;
+
+    uint32_t b = nodeA.child1;
+    uint32_t c = nodeA.child2;
+    Node& nodeB = nodes_[b];
+    Node& nodeC = nodes_[c];
+
+    int32_t imbalance = nodeC.height - nodeB.height;
+
+    //  rotate the higher child up into A's place, A takes the lower of that child's children
+    auto rotateUp = [&](uint32_t up, Node& nodeUp, Node& nodeOther, uint32_t& aSlot) {
+        uint32_t f = nodeUp.child1;
+        uint32_t g = nodeUp.child2;
+        Node& nodeF = nodes_[f];
+        Node& nodeG = nodes_[g];
+
+        nodeUp.child1 = a;
+        nodeUp.parent = nodeA.parent;
+        nodeA.parent = up;
+
+        if (nodeUp.parent == nullNode)
+            root_ = up;
+        else if (nodes_[nodeUp.parent].child1 == a)
+            nodes_[nodeUp.parent].child1 = up;
+        else
+            nodes_[nodeUp.parent].child2 = up;
+
+        bool keepF = nodeF.height > nodeG.height;
+        uint32_t kept = keepF ? f : g;
+        uint32_t moved = keepF ? g : f;
+
+        nodeUp.child2 = kept;
+        aSlot = moved;
+        nodes_[moved].parent = a;
+
+        nodeA.bounds = Aabb::merge(nodeOther.bounds, nodes_[moved].bounds);
+        nodeUp.bounds = Aabb::merge(nodeA.bounds, nodes_[kept].bounds);
+
+        nodeA.height = 1 + std::max(nodeOther.height, nodes_[moved].height);
+        nodeUp.height = 1 + std::max(nodeA.height, nodes_[kept].height);
+
+        return up;
+    };
+
+    if (imbalance > 1)
+        return rotateUp(c, nodeC, nodeB, nodeA.child2);
+    if (imbalance < -1)
+        return rotateUp(b, nodeB, nodeC, nodeA.child1);
+
+    return a;
+}
+
+void DynamicBvh::appendLeaves(uint32_t node, std::vector<uint32_t>& userData) const {
+    if (nodes_[node].isLeaf()) {
+        userData.emplace_back(nodes_[node].userData);
+        return;
+    }
+
+    appendLeaves(nodes_[node].child1, userData);
+    appendLeaves(nodes_[node].child2, userData);
+}
+
+Aabb DynamicBvh::fatten(const Aabb& bounds) {
+    glm::vec3 margin = (bounds.max - bounds.min) * fatMargin;
+    return {bounds.min - margin, bounds.max + margin};
+}
@@ -0,0 +1,109 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <cstdint>
+#include <vector>
+
+#include "aabb.h"
+#include "frustum.h"
+#include "ray.h"
+
+/**
+ * @brief bounding volume hierarchy over boxes that move, insert, remove and update are incremental
+ *
+ * Leaves store the box enlarged by a margin, moving a box only touches the tree once it leaves its enlarged box.
+ * The leaf is then removed and inserted again where it increases the surface area of the tree the least, and the
+ * ancestors are refit and rotated on the way up to keep the tree balanced (after Box2D's dynamic tree).
+ * Nodes live in a single array and are reused, leaf IDs stay valid until the leaf is removed. Not thread safe.
+ */
+class DynamicBvh {
+public:
+    struct Stats {
+        uint32_t leafCount{0};
+        uint32_t nodeCount{0};
+        uint32_t height{0};
+
+        //  summed surface area of the inner nodes relative to the root, lower is better
+        float areaRatio{0.0f};
+    };
+
+    //  balancing keeps the height below 1.44 log2 of the leaf count, 47 levels for 2^32 leaves,
+    //  deeper subtrees would be appended whole by the queries instead of being tested node by node
+    static constexpr uint32_t traversalStackSize{64};
+
+    /**
+     * @param userData returned by queries for this leaf
+     * @return ID of the leaf
+     */
+    uint32_t insert(const Aabb& bounds, uint32_t userData);
+
+    void remove(uint32_t leaf);
+
+    /**
+     * @return true if the leaf had to be reinserted, false if it still fits its enlarged box
+     */
+    bool update(uint32_t leaf, const Aabb& bounds);
+
+    void clear();
+
+    /**
+     * @brief appends the user data of all leaves overlapping the frustum, subtrees fully inside aren't tested further
+     */
+    void cull(const Frustum& frustum, std::vector<uint32_t>& userData) const;
+
+    /**
+     * @brief appends the user data of all leaves whose boxes the ray hits before maxDistance, in no particular order
+     */
+    void intersect(const Ray& ray, float maxDistance, std::vector<uint32_t>& userData) const;
+
+    [[nodiscard]] const Aabb& getFatBounds(uint32_t leaf) const { return nodes_[leaf].bounds; }
+    [[nodiscard]] uint32_t getUserData(uint32_t leaf) const { return nodes_[leaf].userData; }
+
+    [[nodiscard]] uint32_t getLeafCount() const { return leafCount_; }
+    [[nodiscard]] Stats getStats() const;
+
+    static constexpr uint32_t nullNode{~0u};
+
+    //  how much a leaf's box is enlarged, relative to its size
+    static constexpr float fatMargin{0.1f};
+
+private:
+    struct Node {
+        Aabb bounds{};
+
+        //  next free node while the node is on the free list
+        uint32_t parent{nullNode};
+        uint32_t child1{nullNode};
+        uint32_t child2{nullNode};
+
+        uint32_t userData{0};
+
+        //  leaves are 0, free nodes -1
+        int32_t height{-1};
+
+        [[nodiscard]] bool isLeaf() const { return child1 == nullNode; }
+    };
+
+    uint32_t allocateNode();
+    void freeNode(uint32_t node);
+
+    void insertLeaf(uint32_t leaf);
+    void removeLeaf(uint32_t leaf);
+
+    /**
+     * @brief rotates the node if its children's heights differ by more than one
+     * @return the node now in its place
+     */
+    uint32_t balance(uint32_t a);
+
+    void appendLeaves(uint32_t node, std::vector<uint32_t>& userData) const;
+
+    static Aabb fatten(const Aabb& bounds);
+
+    std::vector<Node> nodes_{};
+    uint32_t root_{nullNode};
+    uint32_t freeList_{nullNode};
+    uint32_t leafCount_{0};
+};
@@ -6,17 +6,33 @@
 
 #define GLFW_INCLUDE_VULKAN
 #include <GLFW/glfw3.h>
+#include <chrono>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <optional>
 
 #include <vulkan/vulkan_raii.hpp>
 #include <glm/glm.hpp>
 #include <imgui/imgui.h>
 
 #include "window.h"
+#include "benchmarkReport.h"
+#include "cameraPath.h"
 #include "../scene/camera.h"
 #include "../scene/mesh.h"
 #include "../scene/scene.h"
+#include "indirectDrawList.h"
+#include "jobSystem.h"
+#include "objectPicker.h"
+#include "textureStreamer.h"
+#include "vk/bindlessTextures.h"
+#include "vk/geometryArena.h"
+#include "vk/stagingRing.h"
 #include "vk/graphicsPipeline.h"
+#include "vk/parallelRecorder.h"
+#include "vk/pipelineCache.h"
+#include "vk/shaderLibrary.h"
 
 class Engine : public IDrawGui {
 public:
@@ -26,6 +42,35 @@ public:
     void init();
     void cleanup();
 
+    //  renders into offscreen images instead of a window's swapchain, set before init
+    inline static bool headless{false};
+    inline static vk::Extent2D headlessExtent{1280, 720};
+
+    /**
+     * @brief renders frames back to back and waits for the device to go idle, headless frames skip input and the GUI
+     * @return average time per frame in milliseconds, including the wait for the last one
+     */
+    double renderFrames(uint32_t count);
+
+    /**
+     * @brief writes the last rendered frame to a .png or .exr file, only in headless mode
+     */
+    void saveFrame(const std::string& path);
+
+    //  presents without waiting for vertical blank if the surface allows it, set before init
+    inline static bool useVsync{true};
+
+    /**
+     * @brief replays a camera path over a fixed number of frames after a few warm up frames and measures every frame
+     *
+     * Frame i shows the path at i / (frameCount - 1), so the same path renders the same views whatever the frame rate.
+     * Stops early if the window is closed.
+     */
+    BenchmarkReport runBenchmark(const CameraPath& path, uint32_t frameCount);
+
+    //  frames rendered before measuring, they compile pipelines and stream in the textures
+    static constexpr uint32_t benchmarkWarmupFrames{30};
+
     const vk::raii::Device &getDevice() const {return device_;}
 
     [[nodiscard]] const Scene& getScene() const { return *scene_; }
@@ -34,15 +79,75 @@ public:
     bool drawGUI() override;
 
     [[nodiscard]] const vk::PhysicalDeviceLimits & getDeviceLimits() const { return deviceLimits; }
+    [[nodiscard]] bool isTextureCompressionBCSupported() const { return isTextureCompressionBCSupported_; }
     [[nodiscard]] const vk::raii::DescriptorPool & getDescriptorPool() const { return descriptorPool_; }
     [[nodiscard]] const vk::raii::DescriptorSetLayout & getDescriptorSetLayoutFrame() const { return descriptorSetLayoutFrame_; }
-    [[nodiscard]] const vk::raii::DescriptorSetLayout & getDescriptorSetLayoutMaterial() const { return descriptorSetLayoutMaterial_; }
+
+    [[nodiscard]] TextureStreamer& getTextureStreamer() const { return *textureStreamer_; }
+    [[nodiscard]] StagingRing& getStagingRing() const { return *stagingRing_; }
+    [[nodiscard]] GeometryArena& getGeometryArena() const { return *geometryArena_; }
+    [[nodiscard]] BindlessTextures& getBindlessTextures() const { return *bindlessTextures_; }
+    [[nodiscard]] const PipelineCache& getPipelineCache() const { return *pipelineCache_; }
+
+    /**
+     * @brief saves the pipeline cache, then recreates it and every pipeline, to compare cold and warm pipeline creation
+     * @param loadPipelineCache start from the saved cache file instead of an empty cache
+     * @return the pipeline creation time in milliseconds
+     */
+    double recreatePipelines(bool loadPipelineCache);
 
     void setCameraUBOStorage(const CameraUBOFormat& data);
-    void setMaterialUBOStorage(uint32_t updateIndex, const MaterialUBOFormat& data);
 
-    [[nodiscard]] uint8_t* getMaterialUBO() const {return materialUBOsMapped_[frameInFlightIndex_];}
-    [[nodiscard]] const std::vector<uint8_t*>& getMaterialUBOs() const {return materialUBOsMapped_;}
+    /**
+     * @brief stores a material's constants at its index in the material buffer, safe to call from worker threads
+     * @param index the material's CID
+     */
+    void setMaterialData(uint32_t index, const MaterialUBOFormat& data);
+
+    //  layout meshes are uploaded in, the full layout keeps positions unquantized
+    static constexpr VertexFormat vertexFormat{VertexFormat::packed};
+
+    //  frame contexts that are allocated, how many of them are used is set at runtime
+    static constexpr uint32_t maxFramesInFlight{3};
+
+    /**
+     * @brief sets how many frames the CPU may record ahead of the GPU, waits for the device to go idle if initialized
+     * @param count clamped to [1, maxFramesInFlight]
+     */
+    void setFramesInFlight(uint32_t count);
+    [[nodiscard]] uint32_t getFramesInFlight() const { return framesInFlight_; }
+
+    //  smoothed timings of the last frames in milliseconds
+    struct FrameStats {
+        double frameTime{0.0};      //  between two frames starting, the inverse of throughput
+        double cpuTime{0.0};        //  frame time without the waits below
+        double waitTime{0.0};       //  CPU blocked on the frame context's fence, acquiring and presenting
+        double gpuTime{0.0};        //  between the first and last command of the frame on the GPU, 0 without timestamps
+
+        //  fraction of the shorter of CPU and GPU time that ran in parallel with the other one
+        [[nodiscard]] double getOverlap() const;
+    };
+
+    [[nodiscard]] const FrameStats& getFrameStats() const { return frameStats_; }
+
+    //  how the scene pass is recorded, the same switches the GUI offers
+    struct DrawOptions {
+        bool indirectDraws{true};
+        bool parallelRecording{true};
+        bool frustumCulling{true};
+    };
+
+    /**
+     * @brief call after init, indirect draws stay off on devices without drawIndirectFirstInstance
+     */
+    void setDrawOptions(const DrawOptions& options);
+    [[nodiscard]] DrawOptions getDrawOptions() const {
+        return {.indirectDraws = useIndirectDraws_, .parallelRecording = useParallelRecording_, .frustumCulling = useFrustumCulling_};
+    }
+
+    //  unsmoothed CPU times of the last frame's scene pass in microseconds
+    [[nodiscard]] double getLastCullTime() const { return lastCullTime_; }
+    [[nodiscard]] double getLastSceneRecordTime() const { return lastSceneRecordTime_; }
 
 private:
     friend class VkUtils;
@@ -72,11 +177,43 @@ private:
     void cleanupSwapchain();
     void recreateSwapchain();
 
+    //  one image per frame context takes the swapchain's place in headless mode
+    void initOffscreenTargets();
+    void cleanupOffscreenTargets();
+
     [[nodiscard]] vk::raii::ShaderModule createShaderModule(const std::vector<char>& code) const;
 
     void initImageViews();
     void initGraphicsPipeline();
 
+    /**
+     * @brief a pipeline together with the shaders it's made of, so that it can be rebuilt when they change
+     */
+    struct PipelineProgram {
+        GraphicsPipeline* pipeline{nullptr};
+        std::string vertexShader{};
+        std::string fragmentShader{};
+        std::function<GraphicsPipeline(std::span<const uint32_t> vertexCode, std::span<const uint32_t> fragmentCode)> create{};
+
+        //  only touched by the main thread
+        bool isRebuilding{false};
+
+        //  a shader changed again while the rebuild was running, the rebuild may have read the older source
+        bool isDirtyAgain{false};
+    };
+
+    [[nodiscard]] GraphicsPipeline buildPipeline(const PipelineProgram& program) const;
+
+    /**
+     * @brief swaps in rebuilt pipelines and starts rebuilding the ones whose shaders changed, the frame's fence has to be waited on
+     */
+    void reloadShaders();
+
+    /**
+     * @brief rebuilds the program's pipeline on the job system, reloadShaders() swaps it in once it's done
+     */
+    void rebuildPipeline(uint32_t programIndex);
+
     void initCommandPool();
     void initCommandBuffers();
 
@@ -94,6 +231,12 @@ private:
 
     void drawFrame();
 
+    //  polls the window and builds the GUI unless headless, then draws the frame
+    void runFrame();
+
+    //  records the camera's pose or moves it to the replayed one, after input so that a replay isn't overridden
+    void updateCameraPath();
+
     void processInput();
 
     struct QueueFamilyIndices{
@@ -120,8 +263,10 @@ private:
     static constexpr bool ENABLE_VALIDATION_LAYERS{true};
     #endif
 
-    static constexpr uint32_t maxFramesInFlight{1};
-    static constexpr uint32_t materialLimit{100};
+    static constexpr uint32_t maxBindlessTextures{16384};
+    static constexpr vk::DeviceSize stagingRingCapacity{64 * 1024 * 1024};
+    static constexpr uint32_t geometryBlockVertexCount{1024 * 1024};
+    static constexpr uint32_t geometryBlockIndexCount{4 * 1024 * 1024};
 
     static inline Engine* engineInstance{nullptr};
     std::unique_ptr<Window> window{nullptr};
@@ -131,16 +276,37 @@ private:
         "VK_LAYER_KHRONOS_validation"
 };
 
-    //https://nvpro-samples.github.io/vk_raytracing_tutorial_KHR/
+    //  not needed in headless mode, which then runs on anything with Vulkan 1.3 including software devices like lavapipe
     static inline const std::vector<const char*> requiredDeviceExtensions = {
-        vk::KHRSwapchainExtensionName,
+        vk::KHRSwapchainExtensionName
+};
+
+    //  the groups below are enabled as a whole when the device supports all of their extensions
+    //https://nvpro-samples.github.io/vk_raytracing_tutorial_KHR/
+    static inline const std::vector<const char*> rayTracingDeviceExtensions = {
         vk::KHRAccelerationStructureExtensionName,
         vk::KHRRayTracingPipelineExtensionName,
-        vk::KHRDeferredHostOperationsExtensionName,
+        vk::KHRDeferredHostOperationsExtensionName
+};
+
+    static inline const std::vector<const char*> memoryPriorityDeviceExtensions = {
         vk::EXTPageableDeviceLocalMemoryExtensionName,
         vk::EXTMemoryPriorityExtensionName
 };
 
+    static bool areExtensionsSupported(const std::vector<const char*>& extensions, const std::vector<vk::ExtensionProperties>& supportedExtensions);
+
+    /**
+     * @brief whether the device has Vulkan 1.3 and every feature the renderer can't run without, optional ones are checked when creating the device
+     */
+    static bool areRequiredFeaturesSupported(const vk::raii::PhysicalDevice& device);
+
+    [[nodiscard]] bool isDeviceExtensionEnabled(const char* extension) const;
+
+    std::vector<const char*> enabledDeviceExtensions_{};
+    bool isRayTracingSupported_{false};
+    bool isMemoryPrioritySupported_{false};
+
     vk::raii::Context vkContext;
     vk::raii::Instance vkInstance{nullptr};
 
@@ -160,34 +326,79 @@ private:
     vk::Extent2D swapChainExtent{};
     std::vector<vk::raii::ImageView> swapChainImageViews{};
 
+    std::vector<VkUtils::ImageAlloc> offscreenImages_{};
+    uint32_t lastImageIndex_{0};
+
     vk::raii::DescriptorSetLayout descriptorSetLayoutFrame_{nullptr};
-    vk::raii::DescriptorSetLayout descriptorSetLayoutMaterial_{nullptr};
+
+    //  persisted between runs, saved in cleanup
+    std::unique_ptr<PipelineCache> pipelineCache_{nullptr};
+    inline static const std::string pipelineCachePath{"cache/pipelines.bin"};
+    double pipelineCreationTime_{0.0};
+
+    //  shaders are compiled from the sources next to the build directory, the precompiled SPIR-V is the fallback
+    std::unique_ptr<ShaderLibrary> shaderLibrary_{nullptr};
+    inline static const std::string shaderSourceDirectory{"../shaders/"};
+    bool useShaderHotReload_{true};
+
+    std::vector<PipelineProgram> pipelinePrograms_{};
+
+    //  pipelines rebuilt on the job system, nullopt if the rebuild failed
+    std::mutex rebuiltPipelinesMutex_{};
+    std::vector<std::pair<uint32_t, std::optional<GraphicsPipeline>>> rebuiltPipelines_{};
+    JobCounter shaderReloadCounter_{};
+
+    //  replaced pipelines, kept until no frame in flight can reference them
+    struct RetiredPipeline {
+        uint64_t frameIndex{0};
+        GraphicsPipeline pipeline{};
+    };
+    std::vector<RetiredPipeline> retiredPipelines_{};
 
     GraphicsPipeline rasterPipeline_{};
     GraphicsPipeline skyboxPipeline_{};
 
     vk::raii::CommandPool graphicsCommandPool_{nullptr};
 
-    std::vector<vk::raii::CommandBuffer> commandBuffers_{};
-
-    std::vector<vk::raii::Semaphore> acquireSemaphores_;
-
+    //  present waits on these, so there is one per swapchain image rather than per frame
     std::vector<vk::raii::Semaphore> submitSemaphores_{};
 
-    std::vector<vk::raii::Fence> inFlightFences_{};
-
-    std::vector<VkUtils::BufferAlloc> cameraUBOs_{};
-    std::vector<uint8_t*> cameraUBOsMapped_{};
+    /**
+     * @brief everything a frame writes while it is recorded, the CPU only touches a context after waiting on its fence
+     *
+     * The camera and material data are kept in the engine and copied into a context when it is reused and its copy
+     * is older than the data, so no update is lost whichever frame it happened in.
+     */
+    struct FrameContext {
+        vk::raii::CommandBuffer commandBuffer{nullptr};
+        vk::raii::Fence inFlightFence{nullptr};
+        vk::raii::Semaphore acquireSemaphore{nullptr};
+
+        vk::raii::DescriptorSet descriptorSet{nullptr};
+
+        VkUtils::BufferAlloc cameraUBO{};
+        uint64_t cameraVersion{0};
+
+        //  every material's constants indexed by its CID, grown when the frame needs more room
+        VkUtils::BufferAlloc materialBuffer{};
+        uint32_t materialCapacity{0};
+        uint64_t materialVersion{0};
+
+        //  the frame wrote its timestamps and they can be read once its fence is signaled
+        bool hasTimestamps{false};
+    };
 
-    std::vector<VkUtils::BufferAlloc> materialUBOs_{};
-    std::vector<uint8_t*> materialUBOsMapped_{};
+    std::vector<FrameContext> frames_{};
+    uint32_t framesInFlight_{2};
 
     vk::raii::DescriptorPool descriptorPool_{nullptr};
-    std::vector<vk::raii::DescriptorSet> descriptorSets_{};
 
     vk::raii::DebugUtilsMessengerEXT debugMessenger{nullptr};
 
     vk::PhysicalDeviceLimits deviceLimits{};
+    bool isTextureCompressionBCSupported_{false};
+    bool isTimestampSupported_{false};
+    uint32_t bindlessTextureCapacity_{0};
 
     bool isInitialized_{false};
     bool isRunning_{false};
@@ -226,8 +437,20 @@ private:
     static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods){
         const auto app = static_cast<Engine*>(glfwGetWindowUserPointer(window));
 
-        if (button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS && app->window->getCursorMode() == Window::CursorMode::normal && !ImGui::GetIO().WantCaptureMouse)
-            app->clickSceneObject(cursorPos_);
+        if (button != GLFW_MOUSE_BUTTON_LEFT || app->window->getCursorMode() != Window::CursorMode::normal)
+            return;
+
+        //  shift and drag selects everything inside of the rectangle, a click selects the object under the cursor
+        if (action == GLFW_PRESS && !ImGui::GetIO().WantCaptureMouse) {
+            if (mods & GLFW_MOD_SHIFT)
+                app->selectionStart_ = cursorPos_;
+            else
+                app->pickSceneObjects(cursorPos_, cursorPos_);
+        }
+        else if (action == GLFW_RELEASE && app->selectionStart_.has_value()) {
+            app->pickSceneObjects(*app->selectionStart_, cursorPos_);
+            app->selectionStart_.reset();
+        }
     }
 
     std::shared_ptr<Scene> scene_{};
@@ -236,23 +459,76 @@ private:
 
     std::shared_ptr<Texture> dummy_{nullptr};
 
+    std::unique_ptr<StagingRing> stagingRing_{nullptr};
+    std::unique_ptr<TextureStreamer> textureStreamer_{nullptr};
+    std::unique_ptr<GeometryArena> geometryArena_{nullptr};
+    std::unique_ptr<BindlessTextures> bindlessTextures_{nullptr};
+
     void configureVkUtils() const;
     void updateUBOs();
 
     void cleanUBOs();
 
-    bool dirtyCameraUBO_{false}, dirtyMaterialUBO_{false};
-
     CameraUBOFormat cameraUBOStorage_{};
-    MaterialUBOFormat materialUBOStorage_{};
-    uint32_t materialUpdateIndex_{};
+    uint64_t cameraUBOVersion_{1};
+
+    std::mutex materialDataMutex_{};
+    std::vector<MaterialUBOFormat> materialData_{};
+    uint64_t materialDataVersion_{1};
+
+
+    //  reads the ID map back a few frames later instead of waiting for the GPU
+    std::unique_ptr<ObjectPicker> objectPicker_{nullptr};
+    std::optional<glm::vec<2,double>> selectionStart_{};
+    void pickSceneObjects(const glm::vec<2,double>& corner0, const glm::vec<2,double>& corner1);
 
+    //  clicks and hover are ray cast against the meshes' triangle BVHs, the ID map is then only written for rectangles
+    bool useRayCastPicking_{true};
+    std::optional<Scene::RayHit> castCursorRay(const glm::vec<2,double>& cursorPos);
+    ResourceHandle hoveredObject_{};
 
-    VkUtils::BufferAlloc idMapTransferBuffer_{};
-    void clickSceneObject(const glm::vec<2,double>& cursorPos) const;
+    //  smoothed time of the cursor ray cast in microseconds
+    double rayCastTime_{0.0};
 
     std::shared_ptr<GBuffer> gBuffer_{nullptr};
 
     GraphicsPipeline gBufferPipeline_{};
+    GraphicsPipeline gBufferIndirectPipeline_{};
+
+    std::unique_ptr<IndirectDrawList> drawList_{nullptr};
+    bool useIndirectDraws_{true};
+    bool isDrawIndirectFirstInstanceSupported_{false};
+    bool isMultiDrawIndirectSupported_{false};
+
+    bool useFrustumCulling_{true};
+
+    //  mesh by mesh draws are recorded into secondary command buffers on the job system
+    std::unique_ptr<ParallelRecorder> sceneRecorder_{nullptr};
+    bool useParallelRecording_{true};
+
+    //  smoothed CPU times of culling and recording the scene pass in microseconds
+    double cullTime_{0.0};
+    double sceneRecordTime_{0.0};
+    double lastCullTime_{0.0};
+    double lastSceneRecordTime_{0.0};
+
+    //  two timestamps per frame context, at the start and the end of its command buffer
+    vk::raii::QueryPool timestampQueryPool_{nullptr};
+    void initTimestampQueries();
+    void readTimestamps(uint32_t frameInFlightIndex);
+
+    FrameStats frameStats_{};
+    std::chrono::steady_clock::time_point lastFrameStart_{};
+
+    //  unsmoothed values of the last frame for benchmarks, the GPU time belongs to the frame whose timestamps were read last
+    double lastWaitTime_{0.0};
+    double lastGpuTime_{0.0};
+    uint64_t gpuTimeCount_{0};
+
+    std::optional<CameraPath> recordedCameraPath_{};
+    const CameraPath* replayedCameraPath_{nullptr};
+    float replayPosition_{0.0f};
+    std::string cameraPathStatus_{};
+    inline static const std::string cameraPathFile{"camera_path.txt"};
 
 };
@@ -0,0 +1,91 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "frustum.h"
+
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define DP_FRUSTUM_SSE 1
+#include <immintrin.h>
+#else
+#define DP_FRUSTUM_SSE 0
+#endif
+
+Frustum::Frustum(const glm::mat4& viewProjMat) {
+    //  Gribb and Hartmann, rows of the matrix combined, near plane is z >= 0 for [0, 1] depth
+    glm::mat4 rows = glm::transpose(viewProjMat);
+
+    std::array<glm::vec4, planeCount> planes{
+        rows[3] + rows[0],  // left
+        rows[3] - rows[0],  // right
+        rows[3] + rows[1],  // bottom
+        rows[3] - rows[1],  // top
+        rows[2],            // near
+        rows[3] - rows[2],  // far
+    };
+
+    for (uint32_t i = 0; i < paddedPlaneCount; ++i) {
+        //  padding planes, every box is in front of them
+        glm::vec4 plane{0.0f, 0.0f, 0.0f, 1e30f};
+
+        if (i < planeCount) {
+            float length = glm::length(glm::vec3(planes[i]));
+            plane = length > 0.0f ? planes[i] / length : plane;
+        }
+
+        x_[i] = plane.x;
+        y_[i] = plane.y;
+        z_[i] = plane.z;
+        w_[i] = plane.w;
+
+        absX_[i] = std::abs(plane.x);
+        absY_[i] = std::abs(plane.y);
+        absZ_[i] = std::abs(plane.z);
+    }
+}
+
+Frustum::Result Frustum::test(const Aabb& box) const {
+#if DP_FRUSTUM_SSE
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 minX = _mm_set1_ps(box.min.x), minY = _mm_set1_ps(box.min.y), minZ = _mm_set1_ps(box.min.z);
+    const __m128 maxX = _mm_set1_ps(box.max.x), maxY = _mm_set1_ps(box.max.y), maxZ = _mm_set1_ps(box.max.z);
+
+    const __m128 cx = _mm_mul_ps(_mm_add_ps(minX, maxX), half), cy = _mm_mul_ps(_mm_add_ps(minY, maxY), half), cz = _mm_mul_ps(_mm_add_ps(minZ, maxZ), half);
+    const __m128 ex = _mm_mul_ps(_mm_sub_ps(maxX, minX), half), ey = _mm_mul_ps(_mm_sub_ps(maxY, minY), half), ez = _mm_mul_ps(_mm_sub_ps(maxZ, minZ), half);
+
+    int intersecting{0};
+    for (uint32_t i = 0; i < paddedPlaneCount; i += 4) {
+        //  signed distance of the center and the box's extent projected onto the normal, four planes at a time
+        __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, _mm_load_ps(&x_[i])), _mm_mul_ps(cy, _mm_load_ps(&y_[i]))),
+                                     _mm_add_ps(_mm_mul_ps(cz, _mm_load_ps(&z_[i])), _mm_load_ps(&w_[i])));
+        __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, _mm_load_ps(&absX_[i])), _mm_mul_ps(ey, _mm_load_ps(&absY_[i]))),
+                                   _mm_mul_ps(ez, _mm_load_ps(&absZ_[i])));
+
+        //  distance < -radius
+        if (_mm_movemask_ps(_mm_cmplt_ps(_mm_add_ps(distance, radius), _mm_setzero_ps())))
+            return Result::outside;
+
+        intersecting |= _mm_movemask_ps(_mm_cmplt_ps(distance, radius));
+    }
+
+    return intersecting ? Result::intersecting : Result::inside;
+#else
+    glm::vec3 center = box.getCenter();
+    glm::vec3 extent = box.getExtent();
+
+    bool intersecting{false};
+    for (uint32_t i = 0; i < planeCount; ++i) {
+        float distance = center.x * x_[i] + center.y * y_[i] + center.z * z_[i] + w_[i];
+        float radius = extent.x * absX_[i] + extent.y * absY_[i] + extent.z * absZ_[i];
+
+        if (distance + radius < 0.0f)
+            return Result::outside;
+
+        intersecting |= distance < radius;
+    }
+
+    return intersecting ? Result::intersecting : Result::inside;
+#endif
+}
@@ -0,0 +1,53 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <array>
+#include <cstdint>
+
+#include <glm/glm.hpp>
+
+#include "aabb.h"
+
+/**
+ * @brief view frustum planes for culling bounding boxes
+ *
+ * Planes are kept as structure of arrays, four of them are tested against a box at once with SSE.
+ * The six planes are padded to eight with planes every box lies in front of.
+ */
+class Frustum {
+public:
+    enum class Result : uint8_t {
+        outside,
+        intersecting,
+        inside,
+    };
+
+    /**
+     * @param viewProjMat projection with depth in [0, 1], as set up by the camera
+     */
+    explicit Frustum(const glm::mat4& viewProjMat);
+
+    [[nodiscard]] Result test(const Aabb& box) const;
+
+    /**
+     * @return plane i as (normal, distance), points with dot(normal, p) + distance >= 0 are inside
+     */
+    [[nodiscard]] glm::vec4 getPlane(uint32_t i) const { return {x_[i], y_[i], z_[i], w_[i]}; }
+
+    static constexpr uint32_t planeCount{6};
+
+private:
+    static constexpr uint32_t paddedPlaneCount{8};
+
+    alignas(16) std::array<float, paddedPlaneCount> x_{};
+    alignas(16) std::array<float, paddedPlaneCount> y_{};
+    alignas(16) std::array<float, paddedPlaneCount> z_{};
+    alignas(16) std::array<float, paddedPlaneCount> w_{};
+
+    //  absolute values of the normals, project the box extent onto the normal
+    alignas(16) std::array<float, paddedPlaneCount> absX_{};
+    alignas(16) std::array<float, paddedPlaneCount> absY_{};
+    alignas(16) std::array<float, paddedPlaneCount> absZ_{};
+};
@@ -0,0 +1,62 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "imageWriter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <stdexcept>
+
+#include <FreeImage.h>
+
+#include "pixelConversion.h"
+#include "../scene/texture.h"
+
+void ImageWriter::writeBgra8(const std::string& path, const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t rowPitch) {
+    std::string extension = std::filesystem::path{path}.extension().string();
+    std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    Texture::initFreeImage();
+
+    FIBITMAP* bitmap{nullptr};
+    FREE_IMAGE_FORMAT format{FIF_UNKNOWN};
+
+    if (extension == ".png") {
+        //  FreeImage stores 32-bit pixels as BGRA on little endian machines, the rows only have to be flipped
+        format = FIF_PNG;
+        bitmap = FreeImage_ConvertFromRawBits(const_cast<uint8_t*>(pixels), static_cast<int>(width), static_cast<int>(height), static_cast<int>(rowPitch), 32,
+                                              FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, TRUE);
+    }
+    else if (extension == ".exr") {
+        format = FIF_EXR;
+        bitmap = FreeImage_AllocateT(FIT_RGBAF, static_cast<int>(width), static_cast<int>(height));
+
+        //  FreeImage's scanlines go bottom up
+        for (uint32_t y = 0; bitmap != nullptr && y < height; ++y) {
+            const uint8_t* src = pixels + static_cast<size_t>(y) * rowPitch;
+            auto* dst = reinterpret_cast<FIRGBAF*>(FreeImage_GetScanLine(bitmap, static_cast<int>(height - 1 - y)));
+
+            for (uint32_t x = 0; x < width; ++x) {
+                dst[x] = FIRGBAF{
+                    .red = PixelConversion::srgbToLinear(src[4 * x + 2]),
+                    .green = PixelConversion::srgbToLinear(src[4 * x + 1]),
+                    .blue = PixelConversion::srgbToLinear(src[4 * x]),
+                    .alpha = static_cast<float>(src[4 * x + 3]) / 255.0f
+                };
+            }
+        }
+    }
+    else
+        throw std::runtime_error("ERROR: unsupported image format (" + extension + "), frames are written as .png or .exr!");
+
+    if (bitmap == nullptr)
+        throw std::runtime_error("ERROR: Failed to allocate the image for " + path + "!");
+
+    bool isSaved = FreeImage_Save(format, bitmap, path.c_str(), 0);
+    FreeImage_Unload(bitmap);
+
+    if (!isSaved)
+        throw std::runtime_error("ERROR: Failed to write " + path + "!");
+}
@@ -0,0 +1,24 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief writes rendered frames to image files, the format is picked by the extension (.png or .exr)
+ *
+ * PNG files keep the sRGB encoded bytes as they are, EXR files are linear so the pixels are decoded to floats first.
+ */
+class ImageWriter {
+public:
+    ImageWriter() = delete; //static class
+
+    /**
+     * @param pixels sRGB encoded BGRA pixels, the first row is the top of the image
+     * @param rowPitch bytes between the starts of two rows
+     * @throws std::runtime_error if the extension isn't supported or the file can't be written
+     */
+    static void writeBgra8(const std::string& path, const uint8_t* pixels, uint32_t width, uint32_t height, uint32_t rowPitch);
+};
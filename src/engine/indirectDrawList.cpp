@@ -0,0 +1,200 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "indirectDrawList.h"
+
+#include <algorithm>
+#include <tuple>
+
+#include <imgui/imgui.h>
+
+#include "engine.h"
+
+IndirectDrawList::IndirectDrawList(const vk::raii::Device& device, uint32_t frameCount, bool isMultiDrawIndirectSupported) :
+    device_(device), isMultiDrawIndirectSupported_(isMultiDrawIndirectSupported) {
+
+    vk::DescriptorSetLayoutBinding drawBinding{
+        .binding = 0,
+        .descriptorType = vk::DescriptorType::eStorageBuffer,
+        .descriptorCount = 1,
+        .stageFlags = vk::ShaderStageFlagBits::eVertex
+    };
+
+    descriptorSetLayout_ = vk::raii::DescriptorSetLayout(device_, vk::DescriptorSetLayoutCreateInfo{
+        .bindingCount = 1,
+        .pBindings = &drawBinding
+    });
+
+    frames_.resize(frameCount);
+    for (auto& frame : frames_) {
+        vk::DescriptorSetAllocateInfo allocInfo{
+            .descriptorPool = Engine::getInstance().getDescriptorPool(),
+            .descriptorSetCount = 1,
+            .pSetLayouts = &*descriptorSetLayout_
+        };
+        frame.descriptorSet = std::move(device_.allocateDescriptorSets(allocInfo).front());
+    }
+}
+
+IndirectDrawList::~IndirectDrawList() {
+    for (auto& frame : frames_) {
+        VkUtils::destroyBufferVMA(std::move(frame.drawBuffer));
+        VkUtils::destroyBufferVMA(std::move(frame.indirectBuffer));
+    }
+}
+
+void IndirectDrawList::update(const std::vector<std::shared_ptr<Mesh>>& meshes, std::span<const uint32_t> visibleMeshes, uint32_t frameIndex) {
+    bool hasMeshesChanged = !std::ranges::equal(meshes, meshHandles_, {}, [](const auto& mesh) { return mesh->getHandle(); });
+    if (hasMeshesChanged)
+        rebuildDraws(meshes);
+
+    isMeshVisible_.assign(meshes.size(), 0);
+    for (uint32_t meshIndex : visibleMeshes)
+        isMeshVisible_[meshIndex] = 1;
+
+    FrameData& frame = frames_[frameIndex];
+    reserveDraws(frame, static_cast<uint32_t>(visibleMeshes.size()));
+
+    lastFrameIndex_ = frameIndex;
+    frame.batches.clear();
+    frame.drawCount = 0;
+
+    //  both buffers are write combined, fill them front to back and never read from them
+    auto* draws = static_cast<DrawDataFormat*>(frame.drawBuffer.allocationInfo.pMappedData);
+    auto* commands = static_cast<vk::DrawIndexedIndirectCommand*>(frame.indirectBuffer.allocationInfo.pMappedData);
+
+    //  walking the sorted draws keeps the visible ones grouped by block and index type
+    for (uint32_t meshIndex : drawOrder_) {
+        if (!isMeshVisible_[meshIndex])
+            continue;
+
+        Mesh& mesh = *meshes[meshIndex];
+        const GeometryArena::Allocation& geometry = mesh.getGeometry();
+        const uint32_t drawIndex = frame.drawCount++;
+
+        draws[drawIndex] = DrawDataFormat{
+            .modelMat = mesh.getDrawModelMat(),
+            .normalMat = mesh.getTransform().getNormalMat(),
+            .materialId = mesh.getMaterial()->getCID(),
+            .meshId = mesh.getHandle().value
+        };
+
+        //  the geometry already lives in the arena, the draw's firstInstance is its index into the draw data
+        commands[drawIndex] = vk::DrawIndexedIndirectCommand{
+            .indexCount = geometry.indexCount,
+            .instanceCount = 1,
+            .firstIndex = geometry.firstIndex,
+            .vertexOffset = static_cast<int32_t>(geometry.firstVertex),
+            .firstInstance = drawIndex
+        };
+
+        auto& batches = frame.batches;
+        bool isNewBatch = batches.empty() || batches.back().block != geometry.block || batches.back().indexType != geometry.indexType;
+        if (isNewBatch)
+            batches.emplace_back(DrawBatch{.block = geometry.block, .indexType = geometry.indexType, .firstDraw = drawIndex});
+        batches.back().drawCount += 1;
+    }
+}
+
+void IndirectDrawList::recordDrawCommands(vk::raii::CommandBuffer& cmdBuf, const vk::raii::PipelineLayout& pipelineLayout, uint32_t frameIndex) const {
+    const FrameData& frame = frames_[frameIndex];
+    if (frame.batches.empty())
+        return;
+
+    const GeometryArena& arena = Engine::getInstance().getGeometryArena();
+
+    cmdBuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout, descriptorSetIndex, *frame.descriptorSet, nullptr);
+
+    constexpr uint32_t stride{sizeof(vk::DrawIndexedIndirectCommand)};
+    const uint32_t maxDrawCount = isMultiDrawIndirectSupported_ ? Engine::getInstance().getDeviceLimits().maxDrawIndirectCount : 1;
+
+    for (const auto& batch : frame.batches) {
+        //  every batch is a different block or index type, the buffers change only a few times per frame
+        arena.bindBlock(cmdBuf, batch.block, batch.indexType);
+
+        //  without multi draw indirect every draw is its own call, still no per draw state has to be set
+        for (uint32_t first = 0; first < batch.drawCount; first += maxDrawCount) {
+            uint32_t drawCount = std::min(batch.drawCount - first, maxDrawCount);
+            cmdBuf.drawIndexedIndirect(frame.indirectBuffer.buffer, static_cast<vk::DeviceSize>(batch.firstDraw + first) * stride, drawCount, stride);
+        }
+    }
+}
+
+uint32_t IndirectDrawList::getDrawCallCount() const {
+    if (!isMultiDrawIndirectSupported_)
+        return getDrawCount();
+
+    const uint32_t maxDrawCount = Engine::getInstance().getDeviceLimits().maxDrawIndirectCount;
+
+    uint32_t drawCallCount{0};
+    for (const auto& batch : frames_[lastFrameIndex_].batches)
+        drawCallCount += (batch.drawCount + maxDrawCount - 1) / maxDrawCount;
+    return drawCallCount;
+}
+
+bool IndirectDrawList::drawGUI() {
+    if (ImGui::CollapsingHeader("Indirect draws")) {
+        ImGui::Indent();
+        ImGui::Text("Draws: %u of %u in %u calls", getDrawCount(), static_cast<uint32_t>(drawOrder_.size()), getDrawCallCount());
+        ImGui::Text("Batches: %u", static_cast<uint32_t>(frames_[lastFrameIndex_].batches.size()));
+        ImGui::Text("Rebuilds: %u", rebuildCount_);
+        ImGui::Text("Multi draw indirect: %s", isMultiDrawIndirectSupported_ ? "yes" : "no");
+        ImGui::Unindent();
+    }
+
+    return false;
+}
+
+void IndirectDrawList::rebuildDraws(const std::vector<std::shared_ptr<Mesh>>& meshes) {
+    meshHandles_.clear();
+    for (const auto& mesh : meshes)
+        meshHandles_.emplace_back(mesh->getHandle());
+
+    //  group draws by arena block and index type, materials are kept together within them for texture locality
+    //  meshes without geometry aren't drawn at all
+    drawOrder_.clear();
+    for (uint32_t i = 0; i < meshes.size(); ++i) {
+        if (meshes[i]->getGeometry().isValid())
+            drawOrder_.emplace_back(i);
+    }
+    std::ranges::stable_sort(drawOrder_, {}, [&](uint32_t i) {
+        const GeometryArena::Allocation& geometry = meshes[i]->getGeometry();
+        return std::tuple{geometry.block, geometry.indexType, meshes[i]->getMaterial()->getCID()};
+    });
+
+    rebuildCount_ += 1;
+}
+
+void IndirectDrawList::reserveDraws(FrameData& frame, uint32_t drawCount) {
+    if (drawCount <= frame.capacity)
+        return;
+
+    //  the frame's fence was waited on, nothing reads the old buffers anymore
+    VkUtils::destroyBufferVMA(std::move(frame.drawBuffer));
+    VkUtils::destroyBufferVMA(std::move(frame.indirectBuffer));
+
+    frame.capacity = std::max({drawCount, frame.capacity * 2, 1024u});
+
+    auto allocationCreateFlags = VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT;
+    frame.drawBuffer = VkUtils::createBufferVMA(frame.capacity * sizeof(DrawDataFormat), vk::BufferUsageFlagBits::eStorageBuffer, allocationCreateFlags);
+    frame.indirectBuffer = VkUtils::createBufferVMA(frame.capacity * sizeof(vk::DrawIndexedIndirectCommand), vk::BufferUsageFlagBits::eIndirectBuffer,
+                                                    allocationCreateFlags);
+
+    vk::DescriptorBufferInfo bufferInfo{
+        .buffer = frame.drawBuffer.buffer,
+        .offset = 0,
+        .range = vk::WholeSize
+    };
+
+    vk::WriteDescriptorSet writeDescriptorSet{
+        .dstSet = frame.descriptorSet,
+        .dstBinding = 0,
+        .dstArrayElement = 0,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eStorageBuffer,
+        .pBufferInfo = &bufferInfo
+    };
+
+    device_.updateDescriptorSets(writeDescriptorSet, {});
+}
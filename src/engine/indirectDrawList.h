@@ -0,0 +1,94 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include "iDrawGui.h"
+#include "uboFormat.h"
+#include "vk/vkUtils.h"
+#include "../scene/mesh.h"
+
+/**
+ * @brief draws all meshes of a scene with a handful of indirect draw calls
+ *
+ * Geometry is read in place from the engine's geometry arena, per draw data (transforms and IDs) lives in a
+ * storage buffer indexed by gl_InstanceIndex. Materials are looked up in the shaders, so the only state changing
+ * between draws is the arena block and index type, every such batch is drawn with a single multi draw indirect call.
+ * Draws are still sorted by material within a batch for texture locality. The draw commands are written every frame
+ * for the visible meshes only.
+ */
+class IndirectDrawList : public IDrawGui {
+public:
+    IndirectDrawList(const vk::raii::Device& device, uint32_t frameCount, bool isMultiDrawIndirectSupported);
+    ~IndirectDrawList() override;
+
+    IndirectDrawList(const IndirectDrawList&) = delete;
+    IndirectDrawList& operator=(const IndirectDrawList&) = delete;
+
+    /**
+     * @brief resorts the draws if the meshes changed and writes the draw commands and per draw data of the frame
+     * @param visibleMeshes indices into meshes of the meshes to draw, in any order
+     */
+    void update(const std::vector<std::shared_ptr<Mesh>>& meshes, std::span<const uint32_t> visibleMeshes, uint32_t frameIndex);
+
+    /**
+     * @brief binds the arena blocks and the draw data and records the draws, the pipeline has to be bound already
+     */
+    void recordDrawCommands(vk::raii::CommandBuffer& cmdBuf, const vk::raii::PipelineLayout& pipelineLayout, uint32_t frameIndex) const;
+
+    [[nodiscard]] const vk::raii::DescriptorSetLayout& getDescriptorSetLayout() const { return descriptorSetLayout_; }
+
+    //  of the last updated frame
+    [[nodiscard]] uint32_t getDrawCount() const { return frames_[lastFrameIndex_].drawCount; }
+    [[nodiscard]] uint32_t getDrawCallCount() const;
+
+    bool drawGUI() override;
+
+    //  set the per draw data lives in, after the frame and bindless texture sets
+    static constexpr uint32_t descriptorSetIndex{2};
+
+private:
+    struct DrawBatch {
+        uint32_t block{0};
+        vk::IndexType indexType{vk::IndexType::eUint32};
+        uint32_t firstDraw{0};
+        uint32_t drawCount{0};
+    };
+
+    struct FrameData {
+        VkUtils::BufferAlloc drawBuffer{};
+        VkUtils::BufferAlloc indirectBuffer{};
+        uint32_t capacity{0};
+        vk::raii::DescriptorSet descriptorSet{nullptr};
+
+        std::vector<DrawBatch> batches{};
+        uint32_t drawCount{0};
+    };
+
+    void rebuildDraws(const std::vector<std::shared_ptr<Mesh>>& meshes);
+    void reserveDraws(FrameData& frame, uint32_t drawCount);
+
+    const vk::raii::Device& device_;
+    bool isMultiDrawIndirectSupported_{false};
+
+    vk::raii::DescriptorSetLayout descriptorSetLayout_{nullptr};
+    std::vector<FrameData> frames_{};
+
+    //  handles of the meshes the draws were built from, in scene order
+    std::vector<ResourceHandle> meshHandles_{};
+
+    //  scene mesh index of every drawable mesh, meshes of one block and material are next to each other
+    std::vector<uint32_t> drawOrder_{};
+
+    //  per scene mesh, set for the meshes visible in the frame being updated
+    std::vector<uint8_t> isMeshVisible_{};
+
+    uint32_t lastFrameIndex_{0};
+    uint32_t rebuildCount_{0};
+};
@@ -0,0 +1,215 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "jobSystem.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+
+JobSystem::JobSystem(uint32_t workerCount) {
+    start(workerCount);
+}
+
+JobSystem::~JobSystem() {
+    shutdown();
+}
+
+uint32_t JobSystem::defaultWorkerCount() {
+    //  DP_WORKER_THREADS sets the total amount of threads doing work, including the one waiting for the results
+    if (const char* env = std::getenv("DP_WORKER_THREADS"); env != nullptr) {
+        int threadCount = std::atoi(env);
+        if (threadCount > 0)
+            return static_cast<uint32_t>(threadCount - 1);
+    }
+
+    uint32_t hardwareThreads = std::thread::hardware_concurrency();
+    return hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+}
+
+void JobSystem::start(uint32_t workerCount) {
+    //  queue 0 belongs to threads outside of the pool, queue i to worker i
+    queues_.clear();
+    for (uint32_t i = 0; i < workerCount + 1; ++i)
+        queues_.emplace_back(std::make_unique<WorkerQueue>());
+
+    running_ = true;
+
+    workers_.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i)
+        workers_.emplace_back(&JobSystem::workerLoop, this, i + 1);
+}
+
+void JobSystem::shutdown() {
+    if (!running_)
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        running_ = false;
+    }
+    sleepCondition_.notify_all();
+
+    for (auto& worker : workers_)
+        worker.join();
+
+    workers_.clear();
+
+    //  nobody is left to run whatever is still queued, so run it here rather than dropping it
+    while (tryRunOne(true)) {}
+}
+
+void JobSystem::resize(uint32_t workerCount) {
+    shutdown();
+    start(workerCount);
+}
+
+void JobSystem::submit(Job job, JobCounter& counter, JobPriority priority) {
+    counter.pending_.fetch_add(1, std::memory_order_relaxed);
+
+    if (priority == JobPriority::background) {
+        std::lock_guard<std::mutex> lock(backgroundQueue_.mutex);
+        backgroundQueue_.items.emplace_back(WorkItem{.job = std::move(job), .counter = &counter});
+    }
+    else {
+        //  workers keep their own jobs local, everybody else spreads them over the workers
+        uint32_t queueIndex = threadIndex_;
+        if (queueIndex == 0 && !workers_.empty())
+            queueIndex = 1 + nextQueue_.fetch_add(1, std::memory_order_relaxed) % getWorkerCount();
+
+        auto& queue = *queues_[queueIndex];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        queue.items.emplace_back(WorkItem{.job = std::move(job), .counter = &counter});
+    }
+
+    queuedJobs_.fetch_add(1, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+    }
+    sleepCondition_.notify_one();
+}
+
+void JobSystem::wait(JobCounter& counter) {
+    while (!counter.isDone()) {
+        //  background jobs can take tens of milliseconds, a waiting thread only helps with them when nobody else can
+        if (!tryRunOne(workers_.empty()))
+            std::this_thread::yield();
+    }
+
+    std::exception_ptr exception{nullptr};
+    {
+        std::lock_guard<std::mutex> lock(counter.exceptionMutex_);
+        std::swap(exception, counter.exception_);
+    }
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+
+void JobSystem::parallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t begin, uint32_t end)>& body) {
+    if (count == 0)
+        return;
+
+    //  by default aim for a few chunks per thread so that stealing can even out uneven chunks
+    if (grainSize == 0)
+        grainSize = std::max(1u, count / (getThreadCount() * 4));
+
+    JobCounter counter{};
+    for (uint32_t begin = 0; begin < count; begin += grainSize) {
+        uint32_t end = std::min(count, begin + grainSize);
+        submit([&body, begin, end] { body(begin, end); }, counter);
+    }
+
+    wait(counter);
+}
+
+void JobSystem::workerLoop(uint32_t workerIndex) {
+    threadIndex_ = workerIndex;
+
+    while (true) {
+        if (tryRunOne(true))
+            continue;
+
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleepCondition_.wait(lock, [this] { return queuedJobs_.load(std::memory_order_acquire) > 0 || !running_; });
+
+        if (!running_ && queuedJobs_.load(std::memory_order_acquire) == 0)
+            break;
+    }
+
+    threadIndex_ = 0;
+}
+
+bool JobSystem::tryPop(uint32_t queueIndex, WorkItem& item) {
+    auto& queue = *queues_[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+
+    if (queue.items.empty())
+        return false;
+
+    item = std::move(queue.items.back());
+    queue.items.pop_back();
+    queuedJobs_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::trySteal(uint32_t thiefIndex, WorkItem& item) {
+    auto queueCount = static_cast<uint32_t>(queues_.size());
+
+    for (uint32_t i = 1; i < queueCount; ++i) {
+        auto& queue = *queues_[(thiefIndex + i) % queueCount];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+
+        if (queue.items.empty())
+            continue;
+
+        //  steal the oldest job, it is the one least likely to have its data in the owner's cache
+        item = std::move(queue.items.front());
+        queue.items.pop_front();
+        queuedJobs_.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+    return false;
+}
+
+bool JobSystem::tryPopBackground(WorkItem& item) {
+    std::lock_guard<std::mutex> lock(backgroundQueue_.mutex);
+
+    if (backgroundQueue_.items.empty())
+        return false;
+
+    item = std::move(backgroundQueue_.items.front());
+    backgroundQueue_.items.pop_front();
+    queuedJobs_.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool JobSystem::tryRunOne(bool includeBackground) {
+    if (queuedJobs_.load(std::memory_order_acquire) == 0)
+        return false;
+
+    WorkItem item{};
+    uint32_t ownQueue = threadIndex_ < queues_.size() ? threadIndex_ : 0;
+
+    //  normal jobs first, somebody is usually waiting for them
+    if (!tryPop(ownQueue, item) && !trySteal(ownQueue, item) && !(includeBackground && tryPopBackground(item)))
+        return false;
+
+    execute(item);
+    return true;
+}
+
+void JobSystem::execute(WorkItem& item) {
+    try {
+        item.job();
+    }
+    catch (...) {
+        std::lock_guard<std::mutex> lock(item.counter->exceptionMutex_);
+        if (!item.counter->exception_)
+            item.counter->exception_ = std::current_exception();
+    }
+
+    item.counter->pending_.fetch_sub(1, std::memory_order_acq_rel);
+}
@@ -0,0 +1,136 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief tracks a group of submitted jobs, waiting on it rethrows the first exception thrown by any of them
+ */
+class JobCounter {
+public:
+    [[nodiscard]] bool isDone() const { return pending_.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> pending_{0};
+
+    std::mutex exceptionMutex_;
+    std::exception_ptr exception_{nullptr};
+};
+
+/**
+ * @brief background jobs are run only by the workers and only when they have nothing else to do
+ */
+enum class JobPriority : uint8_t {
+    normal,
+    background
+};
+
+/**
+ * @brief work-stealing thread pool shared by the whole engine
+ *
+ * Every worker owns a deque, it pops its own jobs from the back and steals from the front of the others.
+ * Jobs submitted from outside of the pool are distributed round-robin. A thread waiting on a counter keeps
+ * executing jobs instead of blocking, so waiting from inside a job cannot deadlock and a pool with zero
+ * workers degenerates into running everything on the waiting thread.
+ *
+ * Long jobs that nobody waits for right away (texture decodes, shader rebuilds) are submitted as background jobs.
+ * They go to a queue of their own that waiting threads never take from, so a frame waiting on its culling or
+ * recording jobs doesn't end up decoding a texture. Only with zero workers do waiting threads run them.
+ */
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    static JobSystem& getInstance(){
+        //  magic static, safe to call first from any thread
+        static JobSystem* instance = new JobSystem(defaultWorkerCount());
+        return *instance;
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    ~JobSystem();
+
+    void submit(Job job, JobCounter& counter, JobPriority priority = JobPriority::normal);
+
+    /**
+     * @brief runs normal jobs until all jobs tracked by the counter are finished
+     */
+    void wait(JobCounter& counter);
+
+    /**
+     * @brief splits [0, count) into chunks of at most grainSize elements and runs body(begin, end) on them in parallel, blocks until done
+     */
+    void parallelFor(uint32_t count, uint32_t grainSize, const std::function<void(uint32_t begin, uint32_t end)>& body);
+
+    /**
+     * @brief stops the workers and restarts the pool with a different amount of them, used to measure scaling
+     */
+    void resize(uint32_t workerCount);
+
+    void shutdown();
+
+    [[nodiscard]] uint32_t getWorkerCount() const { return static_cast<uint32_t>(workers_.size()); }
+
+    //  threads taking part in the work (workers + the waiting thread)
+    [[nodiscard]] uint32_t getThreadCount() const { return getWorkerCount() + 1; }
+
+    /**
+     * @return 0 for threads outside of the pool, 1..N for the workers
+     */
+    static uint32_t getThreadIndex() { return threadIndex_; }
+
+private:
+    explicit JobSystem(uint32_t workerCount);
+
+    struct WorkItem {
+        Job job{};
+        JobCounter* counter{nullptr};
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<WorkItem> items;
+    };
+
+    static uint32_t defaultWorkerCount();
+
+    void start(uint32_t workerCount);
+    void workerLoop(uint32_t workerIndex);
+
+    bool tryPop(uint32_t queueIndex, WorkItem& item);
+    bool trySteal(uint32_t thiefIndex, WorkItem& item);
+    bool tryPopBackground(WorkItem& item);
+    bool tryRunOne(bool includeBackground);
+
+    static void execute(WorkItem& item);
+
+    inline static thread_local uint32_t threadIndex_{0};
+
+    std::vector<std::thread> workers_{};
+    std::vector<std::unique_ptr<WorkerQueue>> queues_{};
+
+    //  shared by all workers, first in first out
+    WorkerQueue backgroundQueue_{};
+
+    std::atomic<uint32_t> nextQueue_{0};
+    std::atomic<uint32_t> queuedJobs_{0};
+    std::atomic<bool> running_{false};
+
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCondition_;
+};
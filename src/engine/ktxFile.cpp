@@ -0,0 +1,326 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "ktxFile.h"
+
+#include <charconv>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+#include <vulkan/vulkan_core.h>
+
+#include "utils.h"
+
+//  layout: [Header][LevelIndex * levelCount][data format descriptor][key/value data][levels, smallest first]
+//  every level starts at a multiple of its block size, see the KTX2 specification
+
+namespace {
+    //  Khronos data format descriptor values, see the Khronos Data Format Specification 1.3
+    constexpr uint32_t dfdModelBC1A{128};
+    constexpr uint32_t dfdModelBC5{132};
+    constexpr uint32_t dfdModelBC7{134};
+    constexpr uint32_t dfdPrimariesBT709{1};
+    constexpr uint32_t dfdTransferLinear{1};
+    constexpr uint32_t dfdTransferSRGB{2};
+
+    bool isSrgbFormat(uint32_t vkFormat) {
+        return vkFormat == VK_FORMAT_BC1_RGB_SRGB_BLOCK || vkFormat == VK_FORMAT_BC7_SRGB_BLOCK;
+    }
+}
+
+std::optional<KtxFile> KtxFile::open(std::string_view path) {
+    MappedFile file{path};
+
+    if (!file.isOpen() || file.getSize() < sizeof(Header))
+        return std::nullopt;
+
+    const auto& header = *reinterpret_cast<const Header*>(file.getData());
+
+    if (header.identifier != identifier || header.supercompressionScheme != 0 || header.pixelDepth != 0 ||
+        header.layerCount > 1 || header.faceCount != 1 || header.pixelWidth == 0 || header.pixelHeight == 0) {
+        std::cerr << "WARNING: unsupported KTX2 file " << path << std::endl;
+        return std::nullopt;
+    }
+
+    uint32_t blockSize = getBlockSize(header.vkFormat);
+    if (blockSize == 0) {
+        std::cerr << "WARNING: unsupported format " << header.vkFormat << " in KTX2 file " << path << std::endl;
+        return std::nullopt;
+    }
+
+    uint32_t levelCount = std::max(header.levelCount, 1u);
+    if (sizeof(Header) + levelCount * sizeof(LevelIndex) > file.getSize() ||
+        static_cast<uint64_t>(header.kvdByteOffset) + header.kvdByteLength > file.getSize())
+        return std::nullopt;
+
+    KtxFile ktx{std::move(file)};
+
+    //  make sure no level points outside of the file or is smaller than its blocks before handing out spans
+    for (uint32_t i = 0; i < levelCount; ++i) {
+        const auto& levelIndex = ktx.getLevelIndex(i);
+        uint32_t width = std::max(header.pixelWidth >> i, 1u);
+        uint32_t height = std::max(header.pixelHeight >> i, 1u);
+        uint64_t expectedSize = static_cast<uint64_t>((width + 3) / 4) * ((height + 3) / 4) * blockSize;
+
+        if (levelIndex.byteOffset + levelIndex.byteLength > ktx.file_.getSize() || levelIndex.byteLength < expectedSize ||
+            levelIndex.byteOffset % blockSize != 0) {
+            std::cerr << "WARNING: corrupted KTX2 file " << path << std::endl;
+            return std::nullopt;
+        }
+    }
+
+    return ktx;
+}
+
+bool KtxFile::write(std::string_view path, uint32_t vkFormat, uint32_t width, uint32_t height, std::span<const std::vector<uint8_t>> levels,
+                    std::optional<uint64_t> sourceHash) {
+    uint32_t blockSize = getBlockSize(vkFormat);
+    if (blockSize == 0)
+        throw std::runtime_error("ERROR: unsupported KTX2 format " + std::to_string(vkFormat) + "!");
+
+    std::vector<uint32_t> dfd = createDataFormatDescriptor(vkFormat);
+
+    //  keys have to be sorted, every entry is padded to 4 bytes
+    std::vector<uint8_t> kvd{};
+    auto addKeyValue = [&kvd](std::string_view key, std::string_view value) {
+        auto length = static_cast<uint32_t>(key.size() + 1 + value.size() + 1);
+        kvd.insert(kvd.end(), reinterpret_cast<const uint8_t*>(&length), reinterpret_cast<const uint8_t*>(&length) + sizeof(length));
+        kvd.insert(kvd.end(), key.begin(), key.end());
+        kvd.emplace_back(0);
+        kvd.insert(kvd.end(), value.begin(), value.end());
+        kvd.emplace_back(0);
+        kvd.resize((kvd.size() + 3) & ~static_cast<size_t>(3), 0);
+    };
+    //  rows are stored bottom up the same way FreeImage hands them out
+    addKeyValue("KTXorientation", "ru");
+    addKeyValue("KTXwriter", "dp texcook");
+
+    //  sorts after the KTX keys, upper case letters come before lower case ones
+    if (sourceHash.has_value()) {
+        std::array<char, 16> hex{};
+        auto [end, error] = std::to_chars(hex.data(), hex.data() + hex.size(), *sourceHash, 16);
+        addKeyValue(sourceHashKey, std::string_view{hex.data(), static_cast<size_t>(end - hex.data())});
+    }
+
+    Header header{
+        .identifier = identifier,
+        .vkFormat = vkFormat,
+        .typeSize = 1,
+        .pixelWidth = width,
+        .pixelHeight = height,
+        .pixelDepth = 0,
+        .layerCount = 0,
+        .faceCount = 1,
+        .levelCount = static_cast<uint32_t>(levels.size()),
+        .supercompressionScheme = 0,
+    };
+    header.dfdByteOffset = static_cast<uint32_t>(sizeof(Header) + levels.size() * sizeof(LevelIndex));
+    header.dfdByteLength = static_cast<uint32_t>(dfd.size() * sizeof(uint32_t));
+    header.kvdByteOffset = header.dfdByteOffset + header.dfdByteLength;
+    header.kvdByteLength = static_cast<uint32_t>(kvd.size());
+
+    auto alignUp = [blockSize](uint64_t value) { return (value + blockSize - 1) / blockSize * blockSize; };
+
+    //  the smallest level comes first in the file
+    std::vector<LevelIndex> levelIndices(levels.size());
+    uint64_t offset = header.kvdByteOffset + header.kvdByteLength;
+    for (size_t i = levels.size(); i-- > 0;) {
+        offset = alignUp(offset);
+        levelIndices[i] = LevelIndex{
+            .byteOffset = offset,
+            .byteLength = levels[i].size(),
+            .uncompressedByteLength = levels[i].size()
+        };
+        offset += levels[i].size();
+    }
+
+    //  write into a temporary file first so that an interrupted write never leaves a valid looking texture behind
+    std::filesystem::path finalPath{path};
+    std::filesystem::path tempPath{finalPath};
+    tempPath += ".tmp";
+
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "WARNING: failed to create " << finalPath.string() << std::endl;
+        return false;
+    }
+
+    auto pad = [&out](uint64_t targetOffset) {
+        static constexpr std::array<char, 16> zeros{};
+        auto current = static_cast<uint64_t>(out.tellp());
+        out.write(zeros.data(), static_cast<std::streamsize>(targetOffset - current));
+    };
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(levelIndices.data()), static_cast<std::streamsize>(levelIndices.size() * sizeof(LevelIndex)));
+    out.write(reinterpret_cast<const char*>(dfd.data()), header.dfdByteLength);
+    out.write(reinterpret_cast<const char*>(kvd.data()), header.kvdByteLength);
+
+    for (size_t i = levels.size(); i-- > 0;) {
+        pad(levelIndices[i].byteOffset);
+        out.write(reinterpret_cast<const char*>(levels[i].data()), static_cast<std::streamsize>(levels[i].size()));
+    }
+
+    out.close();
+
+    std::error_code ec;
+    if (!out) {
+        std::cerr << "WARNING: failed to write " << finalPath.string() << std::endl;
+        std::filesystem::remove(tempPath, ec);
+        return false;
+    }
+
+    std::filesystem::rename(tempPath, finalPath, ec);
+    if (ec) {
+        std::cerr << "WARNING: failed to finalize " << finalPath.string() << " (" << ec.message() << ")" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+std::optional<uint64_t> KtxFile::hashSource(std::string_view sourcePath) {
+    MappedFile file{sourcePath};
+    if (!file.isOpen())
+        return std::nullopt;
+
+    return Utils::hash64(file.getData(), file.getSize());
+}
+
+std::optional<uint64_t> KtxFile::getSourceHash() const {
+    auto value = findValue(sourceHashKey);
+    if (!value)
+        return std::nullopt;
+
+    uint64_t hash{0};
+    auto [end, error] = std::from_chars(value->data(), value->data() + value->size(), hash, 16);
+    if (error != std::errc{} || end != value->data() + value->size())
+        return std::nullopt;
+
+    return hash;
+}
+
+bool KtxFile::isCookedFrom(std::string_view sourcePath) const {
+    //  shipping only the cooked files is fine, there is nothing they could be out of date with
+    auto sourceHash = hashSource(sourcePath);
+    if (!sourceHash)
+        return true;
+
+    return getSourceHash() == sourceHash;
+}
+
+std::optional<std::string_view> KtxFile::findValue(std::string_view key) const {
+    const Header& header = getHeader();
+    const auto* data = reinterpret_cast<const char*>(file_.getData()) + header.kvdByteOffset;
+
+    //  every entry is [uint32 length][key\0][value\0] padded to 4 bytes, the length covers the key and the value
+    for (uint32_t offset = 0; offset + sizeof(uint32_t) <= header.kvdByteLength;) {
+        uint32_t length{0};
+        std::memcpy(&length, data + offset, sizeof(length));
+        offset += sizeof(uint32_t);
+
+        if (length > header.kvdByteLength - offset)
+            return std::nullopt;
+
+        std::string_view entry{data + offset, length};
+        offset += (length + 3) & ~3u;
+
+        size_t keyEnd = entry.find('\0');
+        if (keyEnd == std::string_view::npos || entry.substr(0, keyEnd) != key)
+            continue;
+
+        std::string_view value = entry.substr(keyEnd + 1);
+        if (!value.empty() && value.back() == '\0')
+            value.remove_suffix(1);
+        return value;
+    }
+
+    return std::nullopt;
+}
+
+KtxFile::Level KtxFile::getLevel(uint32_t level) const {
+    const auto& levelIndex = getLevelIndex(level);
+    return Level{
+        .data = file_.getBytes().subspan(levelIndex.byteOffset, levelIndex.byteLength),
+        .width = std::max(getWidth() >> level, 1u),
+        .height = std::max(getHeight() >> level, 1u)
+    };
+}
+
+uint32_t KtxFile::getBlockSize(uint32_t vkFormat) {
+    switch (vkFormat) {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            return 8;
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            return 16;
+        default:
+            return 0;
+    }
+}
+
+const KtxFile::Header& KtxFile::getHeader() const {
+    return *reinterpret_cast<const Header*>(file_.getData());
+}
+
+const KtxFile::LevelIndex& KtxFile::getLevelIndex(uint32_t level) const {
+    return reinterpret_cast<const LevelIndex*>(file_.getData() + sizeof(Header))[level];
+}
+
+std::vector<uint32_t> KtxFile::createDataFormatDescriptor(uint32_t vkFormat) {
+    struct Sample {
+        uint32_t bitOffset{};
+        uint32_t bitLength{};
+        uint32_t channelId{};
+    };
+
+    uint32_t colorModel{};
+    std::vector<Sample> samples{};
+
+    switch (vkFormat) {
+        case VK_FORMAT_BC1_RGB_UNORM_BLOCK:
+        case VK_FORMAT_BC1_RGB_SRGB_BLOCK:
+            colorModel = dfdModelBC1A;
+            samples = {{.bitOffset = 0, .bitLength = 64, .channelId = 0}};
+            break;
+        case VK_FORMAT_BC5_UNORM_BLOCK:
+            colorModel = dfdModelBC5;
+            samples = {{.bitOffset = 0, .bitLength = 64, .channelId = 0}, {.bitOffset = 64, .bitLength = 64, .channelId = 1}};
+            break;
+        case VK_FORMAT_BC7_UNORM_BLOCK:
+        case VK_FORMAT_BC7_SRGB_BLOCK:
+            colorModel = dfdModelBC7;
+            samples = {{.bitOffset = 0, .bitLength = 128, .channelId = 0}};
+            break;
+        default:
+            throw std::runtime_error("ERROR: unsupported KTX2 format " + std::to_string(vkFormat) + "!");
+    }
+
+    auto blockSize = static_cast<uint32_t>(24 + 16 * samples.size());
+    uint32_t transfer = isSrgbFormat(vkFormat) ? dfdTransferSRGB : dfdTransferLinear;
+
+    std::vector<uint32_t> dfd{
+        4 + blockSize,                                              // dfdTotalSize
+        0,                                                          // vendorId = Khronos, descriptorType = basic
+        2 | blockSize << 16,                                        // versionNumber, descriptorBlockSize
+        colorModel | dfdPrimariesBT709 << 8 | transfer << 16,       // colorModel, colorPrimaries, transferFunction, flags
+        3 | 3 << 8,                                                 // 4x4x1x1 texel blocks, stored as size - 1
+        getBlockSize(vkFormat),                                     // bytesPlane0
+        0                                                           // bytesPlane4-7
+    };
+
+    for (const auto& sample : samples) {
+        dfd.emplace_back(sample.bitOffset | (sample.bitLength - 1) << 16 | sample.channelId << 24);
+        dfd.emplace_back(0);            // sample position
+        dfd.emplace_back(0);            // sampleLower
+        dfd.emplace_back(UINT32_MAX);   // sampleUpper
+    }
+
+    return dfd;
+}
@@ -0,0 +1,117 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "mappedFile.h"
+
+/**
+ * @brief minimal KTX2 container for cooked 2D textures
+ *
+ * Supports a single layer and face with a full or partial mip chain and no supercompression, which is all the
+ * texture cooker writes. Level data is read in place from the mapped file. The cooker stores the hash of the source
+ * image in the key/value data, so that a cooked file is only used while it matches its source.
+ */
+class KtxFile {
+public:
+
+    struct Level {
+        std::span<const std::byte> data{};
+        uint32_t width{};
+        uint32_t height{};
+    };
+
+    /**
+     * @brief opens and validates a KTX2 file
+     * @return the file or nothing if it is missing, corrupted or uses features that aren't supported
+     */
+    static std::optional<KtxFile> open(std::string_view path);
+
+    /**
+     * @brief writes a block compressed texture, levels start at the base level
+     * @param vkFormat one of the BC1 RGB, BC5 or BC7 formats
+     * @param sourceHash hashSource() of the image the levels were made from
+     * @return false if the file couldn't be written
+     */
+    static bool write(std::string_view path, uint32_t vkFormat, uint32_t width, uint32_t height, std::span<const std::vector<uint8_t>> levels,
+                      std::optional<uint64_t> sourceHash = std::nullopt);
+
+    /**
+     * @return hash of the file's contents, nothing if it can't be read
+     */
+    static std::optional<uint64_t> hashSource(std::string_view sourcePath);
+
+    /**
+     * @return the source hash the file was written with, nothing for files written without one
+     */
+    [[nodiscard]] std::optional<uint64_t> getSourceHash() const;
+
+    /**
+     * @return true if the file was cooked from the source as it is now, or if the source isn't there to compare with
+     */
+    [[nodiscard]] bool isCookedFrom(std::string_view sourcePath) const;
+
+    [[nodiscard]] uint32_t getVkFormat() const { return getHeader().vkFormat; }
+    [[nodiscard]] uint32_t getWidth() const { return getHeader().pixelWidth; }
+    [[nodiscard]] uint32_t getHeight() const { return getHeader().pixelHeight; }
+    [[nodiscard]] uint32_t getLevelCount() const { return std::max(getHeader().levelCount, 1u); }
+
+    [[nodiscard]] Level getLevel(uint32_t level) const;
+
+    //  bytes per 4x4 block, 0 for formats the writer doesn't support
+    static uint32_t getBlockSize(uint32_t vkFormat);
+
+private:
+    struct Header {
+        std::array<uint8_t, 12> identifier{};
+        uint32_t vkFormat{};
+        uint32_t typeSize{};
+        uint32_t pixelWidth{};
+        uint32_t pixelHeight{};
+        uint32_t pixelDepth{};
+        uint32_t layerCount{};
+        uint32_t faceCount{};
+        uint32_t levelCount{};
+        uint32_t supercompressionScheme{};
+        uint32_t dfdByteOffset{};
+        uint32_t dfdByteLength{};
+        uint32_t kvdByteOffset{};
+        uint32_t kvdByteLength{};
+        uint64_t sgdByteOffset{};
+        uint64_t sgdByteLength{};
+    };
+
+    struct LevelIndex {
+        uint64_t byteOffset{};
+        uint64_t byteLength{};
+        uint64_t uncompressedByteLength{};
+    };
+
+    static constexpr std::array<uint8_t, 12> identifier{0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+    explicit KtxFile(MappedFile&& file) : file_(std::move(file)) {}
+
+    [[nodiscard]] const Header& getHeader() const;
+    [[nodiscard]] const LevelIndex& getLevelIndex(uint32_t level) const;
+
+    /**
+     * @return the value stored under key in the key/value data, without its terminating zero
+     */
+    [[nodiscard]] std::optional<std::string_view> findValue(std::string_view key) const;
+
+    //  application specific keys must not start with KTX
+    static constexpr std::string_view sourceHashKey{"dpSourceHash"};
+
+    static std::vector<uint32_t> createDataFormatDescriptor(uint32_t vkFormat);
+
+    MappedFile file_{};
+};
@@ -8,6 +8,33 @@
 
 class ManagedResource;
 
+/**
+ * @brief generational handle of a registered resource, the index is the resource's CID
+ *
+ * The generation changes every time the slot of the index is freed, so handles of freed resources are
+ * detected without touching the resource. Fits into 32 bits so that it can be written into the object ID buffer.
+ * A slot is retired once its generation reaches generationMask, so a handle never becomes valid again.
+ */
+struct ResourceHandle {
+    static constexpr uint32_t indexBits{24};
+    static constexpr uint32_t indexMask{(1u << indexBits) - 1};
+    static constexpr uint32_t generationMask{(1u << (32 - indexBits)) - 1};
+
+    uint32_t value{0};
+
+    static ResourceHandle make(uint32_t index, uint32_t generation) {
+        return ResourceHandle{(generation & generationMask) << indexBits | (index & indexMask)};
+    }
+
+    [[nodiscard]] uint32_t getIndex() const { return value & indexMask; }
+    [[nodiscard]] uint32_t getGeneration() const { return value >> indexBits; }
+
+    //  index 0 is reserved as invalid
+    [[nodiscard]] bool isValid() const { return getIndex() != 0; }
+
+    bool operator==(const ResourceHandle&) const = default;
+};
+
 template <typename T>
 concept ManagedResourceConcept = std::is_base_of_v<ManagedResource,T>;
 template <ManagedResourceConcept T, typename Derived>
@@ -22,6 +49,10 @@ public:
         return categoryId_;
     };
 
+    [[nodiscard]] ResourceHandle getHandle() const {
+        return ResourceHandle::make(categoryId_, generation_);
+    }
+
     [[nodiscard]] virtual uint32_t getGID() const {
         return globalId_;
     };
@@ -50,6 +81,7 @@ protected:
 
     uint32_t globalId_{0};
     uint32_t categoryId_{0};
+    uint32_t generation_{0};
 
     std::string resourceName_;
     std::string fileName_;
@@ -3,9 +3,14 @@
 //
 
 #pragma once
+#include <array>
+#include <atomic>
+#include <future>
 #include <memory>
+#include <shared_mutex>
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <iostream>
 
 #include "managedResource.h"
@@ -20,86 +25,140 @@ class ResourceManager : public ResourceManagerBase {
 public:
 
     static Derived* getInstance(){
-        if (instance_ == nullptr)
-            instance_ = new Derived();
-        return static_cast<Derived*>(instance_);
+        //  magic static, safe to call first from any thread
+        static Derived* instance = new Derived();
+        return instance;
     }
 
     std::shared_ptr<T>  getResource(std::string_view resourceName) {
-        auto it = nameToIdMap_.find(std::string{resourceName});
-        if (it != nameToIdMap_.end()) {
-            return getResource(it->second);
+        auto& shard = getNameShard(resourceName);
+
+        ResourceHandle handle{};
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.nameToHandleMap.find(resourceName);
+            if (it == shard.nameToHandleMap.end())
+                return nullptr;
+            handle = it->second;
         }
-        return nullptr;
+        return getResource(handle);
     }
 
-    std::shared_ptr<T>  getResource(uint32_t resourceId) {
-        auto it = idToResourceMap_.find(resourceId);
-        if (it != idToResourceMap_.end()) {
-            return it->second.lock();
-        }
-        return nullptr;
+    std::shared_ptr<T>  getResource(ResourceHandle handle) {
+        const Slot* slot = findSlot(handle);
+        if (slot == nullptr)
+            return nullptr;
+
+        std::shared_lock<std::shared_mutex> lock(slotMutex_);
+        //  the slot could have been freed between the generation check and taking the lock
+        if (slot->generation.load(std::memory_order_relaxed) != handle.getGeneration())
+            return nullptr;
+        return slot->weak.lock();
+    }
+
+    /**
+     * @brief lock free lookup that neither allocates nor touches the reference count
+     *
+     * Stale handles resolve to nullptr. The pointer is borrowed, it only stays valid while somebody else
+     * keeps the resource alive, which is the case for anything referenced by the scene being drawn.
+     */
+    T* resolve(ResourceHandle handle) const {
+        const Slot* slot = findSlot(handle.getIndex());
+        if (slot == nullptr)
+            return nullptr;
+
+        //  pointer first, generation second: a resource published into a reused slot was stored after the generation
+        //  was bumped, so seeing its pointer means seeing the new generation and the stale handle is rejected
+        T* resource = slot->resource.load(std::memory_order_acquire);
+        if (slot->generation.load(std::memory_order_acquire) != handle.getGeneration())
+            return nullptr;
+        return resource;
     }
 
     std::shared_ptr<T> registerResource(T* resource, std::string_view resourceName) {
+        std::unique_ptr<T> ownedResource{resource};
+        auto& shard = getNameShard(resourceName);
 
-        if (getResource(resourceName) != nullptr)
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        if (isRegistered(shard, resourceName) || shard.pendingResources.contains(resourceName))
             throw std::runtime_error("ERROR: Resource with name " + std::string{resourceName} + " is already registered!");
 
-        auto newResource = std::shared_ptr<T>(resource, ResourceDeleter{});
-
-        uint32_t newCID = assignCategoryId();
-        uint32_t newGID = ResourceManagerBase::getInstance()->assignGlobalId();
-        newResource->categoryId_ = newCID;
-        newResource->globalId_ = newGID;
-        newResource->resourceName_ = resourceName;
-        newResource->isRegistered_ = true;
-
-        nameToIdMap_[std::string{resourceName}] = newCID;
-        idToResourceMap_[newCID] = newResource;
-
-        return newResource;
+        return insertResource(shard, std::move(ownedResource), resourceName);
     }
 
     template <typename... Args>
     std::shared_ptr<T> registerResource(std::string_view resourceName, Args&&... args) {
+        return registerResource(new T(std::forward<Args>(args)...), resourceName);
+    }
 
-        if (getResource(resourceName) != nullptr)
-            throw std::runtime_error("ERROR: Resource with name " + std::string{resourceName} + " is already registered!");
+    /**
+     * @brief atomically returns the resource registered under the name or creates and registers it
+     *
+     * The resource is constructed outside of any lock. Concurrent callers asking for the same name wait for
+     * the first one and receive the same resource (or its exception) instead of racing on the registration.
+     */
+    template <typename... Args>
+    std::shared_ptr<T> getOrRegisterResource(std::string_view resourceName, Args&&... args) {
+        auto& shard = getNameShard(resourceName);
 
-        auto newResource = std::shared_ptr<T>(new T(std::forward<Args>(args)...), ResourceDeleter{});
+        std::shared_future<std::shared_ptr<T>> inFlight{};
+        std::promise<std::shared_ptr<T>> promise{};
+        {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
 
-        uint32_t newCId = assignCategoryId();
-        uint32_t newGId = ResourceManagerBase::getInstance()->assignGlobalId();
-        newResource->categoryId_ = newCId;
-        newResource->globalId_ = newGId;
-        newResource->resourceName_ = resourceName;
-        newResource->isRegistered_ = true;
+            if (auto it = shard.nameToHandleMap.find(resourceName); it != shard.nameToHandleMap.end()) {
+                if (auto existing = getResource(it->second))
+                    return existing;
+            }
 
-        nameToIdMap_[std::string{resourceName}] = newCId;
-        idToResourceMap_[newCId] = newResource;
+            if (auto it = shard.pendingResources.find(resourceName); it != shard.pendingResources.end())
+                inFlight = it->second;
+            else
+                shard.pendingResources.emplace(std::string{resourceName}, promise.get_future().share());
+        }
 
-        return newResource;
-    }
+        if (inFlight.valid())
+            return inFlight.get();
 
-    void deleterFunction(const T& resource) {
+        try {
+            std::unique_ptr<T> newResource{new T(std::forward<Args>(args)...)};
 
-        std::cout << "Resource [" << resource.getResourceType() << "]: " << resource.getResourceName() << " (cID: " << resource.getCID() << " | gID: " << resource.getGID()  << ")" << " freed" << std::endl;
-        nameToIdMap_.erase(resource.getResourceName());
-        idToResourceMap_.erase(resource.getCID());
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            shard.pendingResources.erase(shard.pendingResources.find(resourceName));
+            auto registered = insertResource(shard, std::move(newResource), resourceName);
+            lock.unlock();
+
+            promise.set_value(registered);
+            return registered;
+        }
+        catch (...) {
+            {
+                std::unique_lock<std::shared_mutex> lock(shard.mutex);
+                if (auto it = shard.pendingResources.find(resourceName); it != shard.pendingResources.end())
+                    shard.pendingResources.erase(it);
+            }
+            promise.set_exception(std::current_exception());
+            throw;
+        }
     }
 
-    uint32_t assignCategoryId() {
-        std::lock_guard<std::mutex> lock(cidMutex_);
-        uint32_t newId = ++cidCounter_;
+    void deleterFunction(const T& resource) {
 
-        if (newId == std::numeric_limits<uint32_t>::min())
-            throw std::runtime_error("ERROR: invalid CID reached!");
+        std::cout << "Resource [" << resource.getResourceType() << "]: " << resource.getResourceName() << " (cID: " << resource.getCID() << " | gID: " << resource.getGID()  << ")" << " freed" << std::endl;
 
-        return newId;
+        //  the slot and the name shard are locked one after another, never nested, as this can run on any thread
+        freeSlot(resource.getCID());
+        {
+            //  the name could have been registered again in the meantime, possibly even into the same slot,
+            //  only remove it if it still maps to this resource
+            auto& shard = getNameShard(resource.getResourceName());
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            auto it = shard.nameToHandleMap.find(resource.getResourceName());
+            if (it != shard.nameToHandleMap.end() && it->second == resource.getHandle())
+                shard.nameToHandleMap.erase(it);
+        }
     }
 
-
     struct ResourceDeleter {
         void operator()(const T* t) const {
             if (t) {
@@ -113,15 +172,144 @@ protected:
 
     ResourceManager() = default;
 
+    ~ResourceManager() override {
+        for (auto& chunk : slotChunks_)
+            delete chunk.load(std::memory_order_relaxed);
+    }
+
     constexpr static const char* assetPathPrefix{"../assets/"};
 
-    inline static ResourceManagerBase* instance_{nullptr};
+    //  lookups by name take a shared lock on one shard only, so readers never contend on a single global lock
+    static constexpr uint32_t shardCount{16};
+
+    struct StringHash {
+        using is_transparent = void;
+        size_t operator()(std::string_view str) const { return std::hash<std::string_view>{}(str); }
+    };
+
+    struct NameShard {
+        std::shared_mutex mutex;
+        std::unordered_map<std::string, ResourceHandle, StringHash, std::equal_to<>> nameToHandleMap{};
+        std::unordered_map<std::string, std::shared_future<std::shared_ptr<T>>, StringHash, std::equal_to<>> pendingResources{};
+    };
+
+    //  CIDs are dense indices into chunked slots, chunks are never freed or moved so that reads don't need a lock
+    static constexpr uint32_t slotChunkBits{10};
+    static constexpr uint32_t slotChunkSize{1u << slotChunkBits};
+    static constexpr uint32_t maxSlotChunks{(ResourceHandle::indexMask + 1) / slotChunkSize};
+
+    struct Slot {
+        std::atomic<T*> resource{nullptr};
+        std::atomic<uint32_t> generation{0};
+
+        //  only accessed under slotMutex_
+        std::weak_ptr<T> weak{};
+    };
+
+    using SlotChunk = std::array<Slot, slotChunkSize>;
 
-    uint32_t cidCounter_{0}; // id = 0 is reserved as invalid id
-    std::mutex cidMutex_;
+    NameShard& getNameShard(std::string_view resourceName) { return nameShards_[StringHash{}(resourceName) % shardCount]; }
 
-    std::unordered_map<uint32_t,std::weak_ptr<T>> idToResourceMap_{};
-    std::unordered_map<std::string,uint32_t> nameToIdMap_{};
+    const Slot* findSlot(uint32_t index) const {
+        if (index == 0 || index > ResourceHandle::indexMask)
+            return nullptr;
+
+        const SlotChunk* chunk = slotChunks_[index >> slotChunkBits].load(std::memory_order_acquire);
+        return chunk != nullptr ? &(*chunk)[index & (slotChunkSize - 1)] : nullptr;
+    }
+
+    const Slot* findSlot(ResourceHandle handle) const {
+        const Slot* slot = findSlot(handle.getIndex());
+        if (slot == nullptr || slot->generation.load(std::memory_order_acquire) != handle.getGeneration())
+            return nullptr;
+        return slot;
+    }
+
+    Slot& getSlot(uint32_t index) {
+        return (*slotChunks_[index >> slotChunkBits].load(std::memory_order_relaxed))[index & (slotChunkSize - 1)];
+    }
+
+    /**
+     * @brief reuses a freed slot or appends a new one, expects slotMutex_ to be locked by the caller
+     */
+    uint32_t allocateSlot() {
+        if (!freeSlots_.empty()) {
+            uint32_t index = freeSlots_.back();
+            freeSlots_.pop_back();
+            return index;
+        }
+
+        uint32_t index = ++slotCount_; // index 0 is reserved as invalid
+        if (index > ResourceHandle::indexMask)
+            throw std::runtime_error("ERROR: invalid CID reached!");
+
+        auto& chunk = slotChunks_[index >> slotChunkBits];
+        if (chunk.load(std::memory_order_relaxed) == nullptr)
+            chunk.store(new SlotChunk(), std::memory_order_release);
+
+        return index;
+    }
+
+    void freeSlot(uint32_t index) {
+        std::unique_lock<std::shared_mutex> lock(slotMutex_);
+        Slot& slot = getSlot(index);
+
+        //  bumping the generation first makes every outstanding handle stale before the pointer goes away
+        const uint32_t generation = slot.generation.load(std::memory_order_relaxed) + 1;
+        slot.generation.store(generation, std::memory_order_release);
+        slot.resource.store(nullptr, std::memory_order_release);
+        slot.weak.reset();
+
+        //  the last generation is never handed out, the slot is retired instead of wrapping around to handles that were issued before
+        if (generation < ResourceHandle::generationMask)
+            freeSlots_.push_back(index);
+    }
+
+    /**
+     * @brief expects the name shard to be locked by the caller
+     */
+    bool isRegistered(NameShard& shard, std::string_view resourceName) {
+        auto it = shard.nameToHandleMap.find(resourceName);
+        if (it == shard.nameToHandleMap.end())
+            return false;
+
+        //  only check for expiry, locking the pointer here could run the deleter while the shard is locked
+        std::shared_lock<std::shared_mutex> lock(slotMutex_);
+        const Slot* slot = findSlot(it->second);
+        return slot != nullptr && !slot->weak.expired();
+    }
+
+    /**
+     * @brief assigns ids and publishes the resource, expects the name shard to be locked by the caller
+     */
+    std::shared_ptr<T> insertResource(NameShard& shard, std::unique_ptr<T>&& resource, std::string_view resourceName) {
+        std::unique_lock<std::shared_mutex> slotLock(slotMutex_);
+        uint32_t newCID = allocateSlot();
+        Slot& slot = getSlot(newCID);
+
+        resource->categoryId_ = newCID;
+        resource->generation_ = slot.generation.load(std::memory_order_relaxed);
+        resource->globalId_ = ResourceManagerBase::getInstance()->assignGlobalId();
+        resource->resourceName_ = resourceName;
+        resource->isRegistered_ = true;
+
+        auto newResource = std::shared_ptr<T>(resource.release(), ResourceDeleter{});
+
+        slot.weak = newResource;
+        slot.resource.store(newResource.get(), std::memory_order_release);
+        slotLock.unlock();
+
+        shard.nameToHandleMap.insert_or_assign(std::string{resourceName}, newResource->getHandle());
+
+        return newResource;
+    }
+
+    std::array<NameShard, shardCount> nameShards_{};
+
+    std::shared_mutex slotMutex_;
+    std::array<std::atomic<SlotChunk*>, maxSlotChunks> slotChunks_{};
+    std::vector<uint32_t> freeSlots_{};
+    uint32_t slotCount_{0};
 };
 
 class Mesh;
@@ -151,24 +339,9 @@ class GBufferManager : public ResourceManager<GBuffer, GBufferManager> {
 
 public:
 
+    //  GBuffer needs its own name to prefix its attachments
     template <typename... Args>
     std::shared_ptr<GBuffer> registerResource(std::string_view resourceName, Args&&... args) {
-
-        if (getResource(resourceName) != nullptr)
-            throw std::runtime_error("ERROR: Resource with name " + std::string{resourceName} + " is already registered!");
-
-        auto newResource = std::shared_ptr<GBuffer>(new GBuffer(resourceName, std::forward<Args>(args)...), ResourceDeleter{});
-
-        uint32_t newCId = assignCategoryId();
-        uint32_t newGId = ResourceManagerBase::getInstance()->assignGlobalId();
-        newResource->categoryId_ = newCId;
-        newResource->globalId_ = newGId;
-        newResource->resourceName_ = resourceName;
-        newResource->isRegistered_ = true;
-
-        nameToIdMap_[std::string{resourceName}] = newCId;
-        idToResourceMap_[newCId] = newResource;
-
-        return newResource;
+        return ResourceManager::registerResource(new GBuffer(resourceName, std::forward<Args>(args)...), resourceName);
     }
-};
\ No newline at end of file
+};
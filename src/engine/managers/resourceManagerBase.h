@@ -3,22 +3,19 @@
 //
 
 #pragma once
+#include <atomic>
 #include <cstdint>
-#include <mutex>
 
 class ResourceManagerBase {
 public:
     static ResourceManagerBase* getInstance(){
-
-        if (instance_ == nullptr) {
-            instance_ = new ResourceManagerBase();
-        }
-        return instance_;
+        //  magic static, safe to call first from any thread
+        static ResourceManagerBase* instance = new ResourceManagerBase();
+        return instance;
     }
 
     uint32_t assignGlobalId() {
-        std::lock_guard<std::mutex> lock(counterMutex_);
-        return ++globalIdCounter_;
+        return globalIdCounter_.fetch_add(1, std::memory_order_relaxed) + 1;
     }
 
     virtual ~ResourceManagerBase() = default;
@@ -27,7 +24,5 @@ protected:
     ResourceManagerBase() = default;
 
 private:
-    inline static ResourceManagerBase* instance_{nullptr};
-    uint32_t globalIdCounter_{0};
-    std::mutex counterMutex_;
+    std::atomic<uint32_t> globalIdCounter_{0};
 };
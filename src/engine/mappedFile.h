@@ -0,0 +1,42 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+/**
+ * @brief read-only memory mapping of a whole file, the mapping lives as long as the object
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    explicit MappedFile(std::string_view path);
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    [[nodiscard]] bool isOpen() const { return data_ != nullptr; }
+    [[nodiscard]] const std::byte* getData() const { return data_; }
+    [[nodiscard]] size_t getSize() const { return size_; }
+    [[nodiscard]] std::span<const std::byte> getBytes() const { return {data_, size_}; }
+
+private:
+    void close();
+
+    const std::byte* data_{nullptr};
+    size_t size_{0};
+
+#ifdef _WIN32
+    void* fileHandle_{nullptr};
+    void* mappingHandle_{nullptr};
+#endif
+};
@@ -0,0 +1,316 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "meshCache.h"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "utils.h"
+
+//  layout: [Header][MeshRecord * meshCount][MaterialRecord * materialCount][strings][vertices][indices][meshlets]
+//  vertex, index and meshlet blocks are aligned to dataAlignment so that they can be read in place from the mapping
+
+std::optional<MeshCache> MeshCache::open(std::string_view cachePath, uint64_t sourceHash, uint32_t importerFlags) {
+    MappedFile file{cachePath};
+
+    if (!file.isOpen() || file.getSize() < sizeof(Header))
+        return std::nullopt;
+
+    const auto& header = *reinterpret_cast<const Header*>(file.getData());
+
+    if (header.magic != magic || header.version != version || header.vertexStride != sizeof(Vertex3D) || header.fileSize != file.getSize())
+        return std::nullopt;
+
+    if (header.sourceHash != sourceHash || header.importerFlags != importerFlags)
+        return std::nullopt;
+
+    uint64_t recordsEnd = sizeof(Header) + header.meshCount * sizeof(MeshRecord) + header.materialCount * sizeof(MaterialRecord);
+    if (recordsEnd > header.stringsOffset || header.stringsOffset + header.stringsSize > header.verticesOffset ||
+        header.verticesOffset > header.indicesOffset || header.indicesOffset > header.meshletsOffset || header.meshletsOffset > header.fileSize)
+        return std::nullopt;
+
+    MeshCache cache{std::move(file)};
+
+    //  make sure no record points outside of its block before handing out spans, written so that garbage can't overflow
+    auto isInRange = [](uint64_t first, uint64_t count, uint64_t capacity) { return count <= capacity && first <= capacity - count; };
+    auto isStringInRange = [&](const StringRef& ref) { return isInRange(ref.offset, ref.length, header.stringsSize); };
+
+    uint64_t vertexCapacity = (header.indicesOffset - header.verticesOffset) / sizeof(Vertex3D);
+    uint64_t indexCapacity = (header.meshletsOffset - header.indicesOffset) / sizeof(uint32_t);
+    uint64_t meshletCapacity = (header.fileSize - header.meshletsOffset) / sizeof(Meshlet);
+
+    for (uint32_t i = 0; i < header.meshCount; ++i) {
+        const auto& record = cache.getMeshRecord(i);
+        if (!isInRange(record.firstVertex, record.vertexCount, vertexCapacity) || !isInRange(record.firstIndex, record.indexCount, indexCapacity) ||
+            !isInRange(record.firstMeshlet, record.meshletCount, meshletCapacity) ||
+            !isStringInRange(record.name) || record.materialIndex >= header.materialCount)
+            return std::nullopt;
+
+        //  indices go to the GPU as they are, one past the mesh's vertices would read another mesh's or unwritten memory
+        std::span<const uint32_t> indices = cache.getIndices(i);
+        if (std::ranges::any_of(indices, [&record](uint32_t index) { return index >= record.vertexCount; }))
+            return std::nullopt;
+    }
+
+    auto materialRecords = reinterpret_cast<const MaterialRecord*>(cache.file_.getData() + sizeof(Header) + header.meshCount * sizeof(MeshRecord));
+    for (uint32_t i = 0; i < header.materialCount; ++i) {
+        const auto& record = materialRecords[i];
+        if (!isStringInRange(record.name) || !std::ranges::all_of(record.textureNames, isStringInRange))
+            return std::nullopt;
+    }
+
+    return cache;
+}
+
+void MeshCache::write(std::string_view cachePath, uint64_t sourceHash, uint32_t importerFlags, std::span<const MeshData> meshes,
+                      std::span<const MaterialData> materials) {
+
+    std::string strings{};
+    auto addString = [&strings](std::string_view str) {
+        StringRef ref{.offset = static_cast<uint32_t>(strings.size()), .length = static_cast<uint32_t>(str.size())};
+        strings.append(str);
+        return ref;
+    };
+
+    auto alignUp = [](uint64_t value) { return (value + dataAlignment - 1) & ~(dataAlignment - 1); };
+
+    std::vector<MeshRecord> meshRecords{};
+    meshRecords.reserve(meshes.size());
+
+    uint64_t vertexCount{0}, indexCount{0}, meshletCount{0};
+    for (const auto& mesh : meshes) {
+        meshRecords.emplace_back(MeshRecord{
+            .name = addString(mesh.name),
+            .materialIndex = mesh.materialIndex,
+            .firstVertex = vertexCount,
+            .vertexCount = mesh.vertices.size(),
+            .firstIndex = indexCount,
+            .indexCount = mesh.indices.size(),
+            .firstMeshlet = meshletCount,
+            .meshletCount = mesh.meshlets.size(),
+        });
+        vertexCount += mesh.vertices.size();
+        indexCount += mesh.indices.size();
+        meshletCount += mesh.meshlets.size();
+    }
+
+    std::vector<MaterialRecord> materialRecords{};
+    materialRecords.reserve(materials.size());
+
+    for (const auto& material : materials) {
+        MaterialRecord record{
+            .name = addString(material.name),
+            .diffuseAlbedo = {material.diffuseAlbedo.x, material.diffuseAlbedo.y, material.diffuseAlbedo.z},
+            .specularAlbedo = {material.specularAlbedo.x, material.specularAlbedo.y, material.specularAlbedo.z},
+            .emission = {material.emission.x, material.emission.y, material.emission.z},
+            .attenuation = {material.attenuation.x, material.attenuation.y, material.attenuation.z},
+            .shininess = material.shininess,
+            .ior = material.ior,
+        };
+        for (uint32_t i = 0; i < material.textureNames.size(); ++i)
+            record.textureNames[i] = addString(material.textureNames[i]);
+
+        materialRecords.emplace_back(record);
+    }
+
+    Header header{
+        .magic = magic,
+        .version = version,
+        .sourceHash = sourceHash,
+        .importerFlags = importerFlags,
+        .vertexStride = sizeof(Vertex3D),
+        .meshCount = static_cast<uint32_t>(meshRecords.size()),
+        .materialCount = static_cast<uint32_t>(materialRecords.size()),
+    };
+    header.stringsOffset = sizeof(Header) + meshRecords.size() * sizeof(MeshRecord) + materialRecords.size() * sizeof(MaterialRecord);
+    header.stringsSize = strings.size();
+    header.verticesOffset = alignUp(header.stringsOffset + header.stringsSize);
+    header.indicesOffset = alignUp(header.verticesOffset + vertexCount * sizeof(Vertex3D));
+    header.meshletsOffset = alignUp(header.indicesOffset + indexCount * sizeof(uint32_t));
+    header.fileSize = header.meshletsOffset + meshletCount * sizeof(Meshlet);
+
+    //  write into a temporary file first so that an interrupted write never leaves a valid looking cache behind
+    std::filesystem::path finalPath{cachePath};
+    std::filesystem::path tempPath{finalPath};
+    tempPath += ".tmp";
+
+    std::error_code ec;
+    if (finalPath.has_parent_path())
+        std::filesystem::create_directories(finalPath.parent_path(), ec);
+
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "WARNING: failed to create mesh cache " << finalPath.string() << std::endl;
+        return;
+    }
+
+    auto pad = [&out](uint64_t targetOffset) {
+        static constexpr std::array<char, dataAlignment> zeros{};
+        auto current = static_cast<uint64_t>(out.tellp());
+        out.write(zeros.data(), static_cast<std::streamsize>(targetOffset - current));
+    };
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(meshRecords.data()), static_cast<std::streamsize>(meshRecords.size() * sizeof(MeshRecord)));
+    out.write(reinterpret_cast<const char*>(materialRecords.data()), static_cast<std::streamsize>(materialRecords.size() * sizeof(MaterialRecord)));
+    out.write(strings.data(), static_cast<std::streamsize>(strings.size()));
+
+    pad(header.verticesOffset);
+    for (const auto& mesh : meshes)
+        out.write(reinterpret_cast<const char*>(mesh.vertices.data()), static_cast<std::streamsize>(mesh.vertices.size() * sizeof(Vertex3D)));
+
+    pad(header.indicesOffset);
+    for (const auto& mesh : meshes)
+        out.write(reinterpret_cast<const char*>(mesh.indices.data()), static_cast<std::streamsize>(mesh.indices.size() * sizeof(uint32_t)));
+
+    pad(header.meshletsOffset);
+    for (const auto& mesh : meshes)
+        out.write(reinterpret_cast<const char*>(mesh.meshlets.data()), static_cast<std::streamsize>(mesh.meshlets.size() * sizeof(Meshlet)));
+
+    out.close();
+
+    if (!out) {
+        std::cerr << "WARNING: failed to write mesh cache " << finalPath.string() << std::endl;
+        std::filesystem::remove(tempPath, ec);
+        return;
+    }
+
+    std::filesystem::rename(tempPath, finalPath, ec);
+    if (ec)
+        std::cerr << "WARNING: failed to finalize mesh cache " << finalPath.string() << " (" << ec.message() << ")" << std::endl;
+}
+
+uint64_t MeshCache::hashFile(std::string_view path) {
+    MappedFile file{path};
+
+    if (!file.isOpen())
+        throw std::runtime_error("ERROR: failed to open " + std::string{path} + " for hashing!");
+
+    return Utils::hash64(file.getData(), file.getSize());
+}
+
+uint64_t MeshCache::hashSource(std::string_view path) {
+    MappedFile file{path};
+
+    if (!file.isOpen())
+        throw std::runtime_error("ERROR: failed to open " + std::string{path} + " for hashing!");
+
+    uint64_t hash = Utils::hash64(file.getData(), file.getSize());
+
+    std::filesystem::path sourcePath{path};
+    std::string extension = sourcePath.extension().string();
+    std::ranges::transform(extension, extension.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+
+    if (extension != ".obj")
+        return hash;
+
+    //  like the importer, the rest of an mtllib line is a single file name relative to the model
+    std::string_view text{reinterpret_cast<const char*>(file.getData()), file.getSize()};
+    constexpr std::string_view keyword{"mtllib"};
+
+    for (size_t lineStart = 0; lineStart < text.size();) {
+        size_t lineEnd = std::min(text.find('\n', lineStart), text.size());
+        std::string_view line = text.substr(lineStart, lineEnd - lineStart);
+        lineStart = lineEnd + 1;
+
+        if (!line.starts_with(keyword) || line.size() == keyword.size() || !std::isspace(static_cast<unsigned char>(line[keyword.size()])))
+            continue;
+
+        line.remove_prefix(keyword.size());
+        while (!line.empty() && std::isspace(static_cast<unsigned char>(line.front())))
+            line.remove_prefix(1);
+        while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back())))
+            line.remove_suffix(1);
+
+        //  the name goes into the hash too, so that adding a library that doesn't exist yet is noticed once it does
+        hash = Utils::hash64(line.data(), line.size(), hash);
+
+        MappedFile library{(sourcePath.parent_path() / line).string()};
+        if (library.isOpen())
+            hash = Utils::hash64(library.getData(), library.getSize(), hash);
+    }
+
+    return hash;
+}
+
+uint32_t MeshCache::getMeshCount() const {
+    return getHeader().meshCount;
+}
+
+std::string_view MeshCache::getMeshName(uint32_t meshIndex) const {
+    return getString(getMeshRecord(meshIndex).name);
+}
+
+uint32_t MeshCache::getMaterialIndex(uint32_t meshIndex) const {
+    return getMeshRecord(meshIndex).materialIndex;
+}
+
+std::span<const Vertex3D> MeshCache::getVertices(uint32_t meshIndex) const {
+    const auto& record = getMeshRecord(meshIndex);
+    auto vertices = reinterpret_cast<const Vertex3D*>(file_.getData() + getHeader().verticesOffset);
+    return {vertices + record.firstVertex, record.vertexCount};
+}
+
+std::span<const uint32_t> MeshCache::getIndices(uint32_t meshIndex) const {
+    const auto& record = getMeshRecord(meshIndex);
+    auto indices = reinterpret_cast<const uint32_t*>(file_.getData() + getHeader().indicesOffset);
+    return {indices + record.firstIndex, record.indexCount};
+}
+
+std::span<const Meshlet> MeshCache::getMeshlets(uint32_t meshIndex) const {
+    const auto& record = getMeshRecord(meshIndex);
+    auto meshlets = reinterpret_cast<const Meshlet*>(file_.getData() + getHeader().meshletsOffset);
+    return {meshlets + record.firstMeshlet, record.meshletCount};
+}
+
+std::vector<MeshCache::MaterialData> MeshCache::readMaterials() const {
+    const auto& header = getHeader();
+    auto records = reinterpret_cast<const MaterialRecord*>(file_.getData() + sizeof(Header) + header.meshCount * sizeof(MeshRecord));
+
+    std::vector<MaterialData> materials{};
+    materials.reserve(header.materialCount);
+
+    for (uint32_t i = 0; i < header.materialCount; ++i) {
+        const auto& record = records[i];
+
+        MaterialData material{
+            .name = std::string{getString(record.name)},
+            .diffuseAlbedo = {record.diffuseAlbedo[0], record.diffuseAlbedo[1], record.diffuseAlbedo[2]},
+            .specularAlbedo = {record.specularAlbedo[0], record.specularAlbedo[1], record.specularAlbedo[2]},
+            .emission = {record.emission[0], record.emission[1], record.emission[2]},
+            .attenuation = {record.attenuation[0], record.attenuation[1], record.attenuation[2]},
+            .shininess = record.shininess,
+            .ior = record.ior,
+        };
+        for (uint32_t j = 0; j < record.textureNames.size(); ++j)
+            material.textureNames[j] = getString(record.textureNames[j]);
+
+        materials.emplace_back(std::move(material));
+    }
+
+    return materials;
+}
+
+const MeshCache::Header& MeshCache::getHeader() const {
+    return *reinterpret_cast<const Header*>(file_.getData());
+}
+
+const MeshCache::MeshRecord& MeshCache::getMeshRecord(uint32_t meshIndex) const {
+    if (meshIndex >= getHeader().meshCount)
+        throw std::runtime_error("ERROR: mesh index out of range of the mesh cache!");
+
+    return reinterpret_cast<const MeshRecord*>(file_.getData() + sizeof(Header))[meshIndex];
+}
+
+std::string_view MeshCache::getString(const StringRef& ref) const {
+    const auto& header = getHeader();
+    if (static_cast<uint64_t>(ref.offset) + ref.length > header.stringsSize)
+        throw std::runtime_error("ERROR: string reference out of range of the mesh cache!");
+
+    return {reinterpret_cast<const char*>(file_.getData() + header.stringsOffset + ref.offset), ref.length};
+}
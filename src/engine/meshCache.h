@@ -0,0 +1,136 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <array>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "mappedFile.h"
+#include "meshOptimizer.h"
+#include "../scene/Vertex.h"
+
+/**
+ * @brief versioned binary cache of an imported model
+ *
+ * Stores the final (optimized) vertex and index arrays, meshlets, mesh names, material bindings and material parameters so that
+ * warm starts only have to map the file instead of running the importer again. The cache is only used when
+ * both the source hash (see hashSource) and the importer flags match the ones it was written with.
+ */
+class MeshCache {
+public:
+
+    struct MaterialData {
+        std::string name{};
+
+        glm::vec3 diffuseAlbedo{};
+        glm::vec3 specularAlbedo{};
+        glm::vec3 emission{};
+        glm::vec3 attenuation{};
+
+        float shininess{};
+        float ior{};
+
+        //  texture file names relative to the model directory, indexed by Material::TextureMapSlot, empty if unused
+        std::array<std::string, 4> textureNames{};
+    };
+
+    struct MeshData {
+        std::string name{};
+        std::vector<Vertex3D> vertices{};
+        std::vector<uint32_t> indices{};
+        std::vector<Meshlet> meshlets{};
+        uint32_t materialIndex{};
+    };
+
+    /**
+     * @brief opens and validates a cache file
+     * @return the cache or nothing if the file is missing, stale or corrupted
+     */
+    static std::optional<MeshCache> open(std::string_view cachePath, uint64_t sourceHash, uint32_t importerFlags);
+
+    static void write(std::string_view cachePath, uint64_t sourceHash, uint32_t importerFlags,
+                      std::span<const MeshData> meshes, std::span<const MaterialData> materials);
+
+    static uint64_t hashFile(std::string_view path);
+
+    /**
+     * @brief hashes the model file together with the files the importer reads alongside it, the material libraries of OBJ files
+     *
+     * Material parameters and texture names are cached too, so editing only the .mtl has to invalidate the cache as well.
+     */
+    static uint64_t hashSource(std::string_view path);
+
+    [[nodiscard]] uint32_t getMeshCount() const;
+    [[nodiscard]] std::string_view getMeshName(uint32_t meshIndex) const;
+    [[nodiscard]] uint32_t getMaterialIndex(uint32_t meshIndex) const;
+    [[nodiscard]] std::span<const Vertex3D> getVertices(uint32_t meshIndex) const;
+    [[nodiscard]] std::span<const uint32_t> getIndices(uint32_t meshIndex) const;
+    [[nodiscard]] std::span<const Meshlet> getMeshlets(uint32_t meshIndex) const;
+
+    [[nodiscard]] std::vector<MaterialData> readMaterials() const;
+
+    // bump whenever the layout of any record, of Vertex3D or of Meshlet changes, or the optimization pass does
+    static constexpr uint32_t version{2};
+
+private:
+    struct Header {
+        std::array<char, 4> magic{};
+        uint32_t version{};
+        uint64_t sourceHash{};
+        uint32_t importerFlags{};
+        uint32_t vertexStride{};
+        uint32_t meshCount{};
+        uint32_t materialCount{};
+        uint64_t stringsOffset{};
+        uint64_t stringsSize{};
+        uint64_t verticesOffset{};
+        uint64_t indicesOffset{};
+        uint64_t meshletsOffset{};
+        uint64_t fileSize{};
+    };
+
+    struct StringRef {
+        uint32_t offset{};
+        uint32_t length{};
+    };
+
+    struct MeshRecord {
+        StringRef name{};
+        uint32_t materialIndex{};
+        uint32_t padding{};
+        uint64_t firstVertex{};
+        uint64_t vertexCount{};
+        uint64_t firstIndex{};
+        uint64_t indexCount{};
+        uint64_t firstMeshlet{};
+        uint64_t meshletCount{};
+    };
+
+    struct MaterialRecord {
+        StringRef name{};
+        std::array<float, 3> diffuseAlbedo{};
+        std::array<float, 3> specularAlbedo{};
+        std::array<float, 3> emission{};
+        std::array<float, 3> attenuation{};
+        float shininess{};
+        float ior{};
+        std::array<StringRef, 4> textureNames{};
+    };
+
+    static constexpr std::array<char, 4> magic{'D', 'P', 'M', 'C'};
+    static constexpr uint64_t dataAlignment{16};
+
+    explicit MeshCache(MappedFile&& file) : file_(std::move(file)) {}
+
+    [[nodiscard]] const Header& getHeader() const;
+    [[nodiscard]] const MeshRecord& getMeshRecord(uint32_t meshIndex) const;
+    [[nodiscard]] std::string_view getString(const StringRef& ref) const;
+
+    MappedFile file_{};
+};
@@ -0,0 +1,414 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "meshOptimizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+
+namespace {
+    constexpr uint32_t invalidIndex{~0u};
+
+    //  triangles referencing each vertex, triangles of vertex v are triangles[offsets[v]] to triangles[offsets[v + 1]]
+    struct Adjacency {
+        std::vector<uint32_t> offsets{};
+        std::vector<uint32_t> triangles{};
+    };
+
+    Adjacency buildAdjacency(std::span<const uint32_t> indices, uint32_t vertexCount) {
+        Adjacency adjacency{};
+        adjacency.offsets.assign(vertexCount + 1, 0);
+
+        for (uint32_t index : indices)
+            adjacency.offsets[index + 1] += 1;
+        std::partial_sum(adjacency.offsets.begin(), adjacency.offsets.end(), adjacency.offsets.begin());
+
+        adjacency.triangles.resize(indices.size());
+        std::vector<uint32_t> fill(adjacency.offsets.begin(), adjacency.offsets.end() - 1);
+        for (uint32_t i = 0; i < indices.size(); ++i)
+            adjacency.triangles[fill[indices[i]]++] = i / 3;
+
+        return adjacency;
+    }
+
+    //  vertex v is in the FIFO cache if fewer than cacheSize vertices were inserted after it, time counts insertions
+    class CacheModel {
+    public:
+        CacheModel(uint32_t vertexCount, uint32_t cacheSize) : insertionTimes_(vertexCount, 0), time_(cacheSize + 1), cacheSize_(cacheSize) {}
+
+        [[nodiscard]] bool contains(uint32_t vertex) const { return time_ - insertionTimes_[vertex] <= cacheSize_; }
+        [[nodiscard]] uint32_t getAge(uint32_t vertex) const { return time_ - insertionTimes_[vertex]; }
+
+        /**
+         * @return true on a cache miss
+         */
+        bool reference(uint32_t vertex) {
+            if (contains(vertex))
+                return false;
+
+            insertionTimes_[vertex] = time_++;
+            return true;
+        }
+
+        uint32_t referenceTriangle(std::span<const uint32_t> indices, uint32_t triangle) {
+            return reference(indices[triangle * 3 + 0]) + reference(indices[triangle * 3 + 1]) + reference(indices[triangle * 3 + 2]);
+        }
+
+        void flush() { time_ += cacheSize_ + 1; }
+
+    private:
+        std::vector<uint32_t> insertionTimes_;
+        uint32_t time_;
+        uint32_t cacheSize_;
+    };
+
+    glm::vec3 getTriangleNormal(std::span<const Vertex3D> vertices, std::span<const uint32_t> indices, uint32_t triangle) {
+        const glm::vec3& p0 = vertices[indices[triangle * 3 + 0]].position;
+        const glm::vec3& p1 = vertices[indices[triangle * 3 + 1]].position;
+        const glm::vec3& p2 = vertices[indices[triangle * 3 + 2]].position;
+
+        //  not normalized, its length is twice the area
+        return glm::cross(p1 - p0, p2 - p0);
+    }
+
+    void computeMeshletBounds(Meshlet& meshlet, std::span<const Vertex3D> vertices, std::span<const uint32_t> indices) {
+        const uint32_t firstTriangle = meshlet.firstIndex / 3;
+
+        glm::vec3 boundsMin{vertices[indices[meshlet.firstIndex]].position};
+        glm::vec3 boundsMax{boundsMin};
+        for (uint32_t i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.triangleCount * 3; ++i) {
+            boundsMin = glm::min(boundsMin, vertices[indices[i]].position);
+            boundsMax = glm::max(boundsMax, vertices[indices[i]].position);
+        }
+
+        meshlet.center = (boundsMin + boundsMax) * 0.5f;
+        meshlet.radius = 0.0f;
+        for (uint32_t i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.triangleCount * 3; ++i)
+            meshlet.radius = std::max(meshlet.radius, glm::length(vertices[indices[i]].position - meshlet.center));
+
+        //  the cone has to contain the normals of all triangles, degenerate ones don't face anywhere
+        std::vector<glm::vec3> normals{};
+        normals.reserve(meshlet.triangleCount);
+
+        glm::vec3 axis{0.0f};
+        for (uint32_t i = firstTriangle; i < firstTriangle + meshlet.triangleCount; ++i) {
+            glm::vec3 normal = getTriangleNormal(vertices, indices, i);
+            float length = glm::length(normal);
+            if (length == 0.0f)
+                continue;
+
+            normals.emplace_back(normal / length);
+            axis += normals.back();
+        }
+
+        float axisLength = glm::length(axis);
+        if (normals.empty() || axisLength == 0.0f)
+            return;
+
+        meshlet.coneAxis = axis / axisLength;
+
+        float minDot{1.0f};
+        for (const auto& normal : normals)
+            minDot = std::min(minDot, glm::dot(meshlet.coneAxis, normal));
+
+        //  wider than about 84 degrees the cone culls next to nothing
+        meshlet.coneCutoff = minDot <= 0.1f ? 1.0f : std::sqrt(1.0f - minDot * minDot);
+    }
+}
+
+MeshOptimizer::Report MeshOptimizer::optimize(std::vector<Vertex3D>& vertices, std::vector<uint32_t>& indices, std::vector<Meshlet>& meshlets) {
+    if (std::ranges::any_of(indices, [&](uint32_t index) { return index >= vertices.size(); }))
+        throw std::runtime_error("ERROR: mesh index out of range of its vertices!");
+
+    Report report{.before = analyzeVertexCache(indices, static_cast<uint32_t>(vertices.size()))};
+
+    //  lines and points left over by the importer don't form triangles, leave such meshes alone
+    if (indices.size() % 3 != 0) {
+        std::cerr << "WARNING: mesh isn't a triangle list, skipping optimization" << std::endl;
+        report.after = report.before;
+        meshlets.clear();
+        return report;
+    }
+
+    optimizeVertexCache(indices, static_cast<uint32_t>(vertices.size()));
+    optimizeOverdraw(indices, vertices);
+    optimizeVertexFetch(vertices, indices);
+
+    report.after = analyzeVertexCache(indices, static_cast<uint32_t>(vertices.size()));
+
+    meshlets = buildMeshlets(vertices, indices);
+    report.meshletCount = static_cast<uint32_t>(meshlets.size());
+
+    return report;
+}
+
+void MeshOptimizer::optimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize) {
+    const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triangleCount == 0)
+        return;
+
+    //  Tipsify, Sander et al. 2007: fan out of a vertex, then continue with the neighbour that is still in the
+    //  cache and will stay there until its remaining triangles are emitted
+    Adjacency adjacency = buildAdjacency(indices, vertexCount);
+
+    std::vector<uint32_t> liveTriangles(vertexCount);
+    for (uint32_t v = 0; v < vertexCount; ++v)
+        liveTriangles[v] = adjacency.offsets[v + 1] - adjacency.offsets[v];
+
+    std::vector<bool> isEmitted(triangleCount, false);
+    std::vector<uint32_t> deadEnds{};
+    std::vector<uint32_t> candidates{};
+
+    std::vector<uint32_t> result{};
+    result.reserve(indices.size());
+
+    CacheModel cache{vertexCount, cacheSize};
+    uint32_t cursor{0};
+
+    //  recently used vertices first, then whatever is left in input order
+    auto skipDeadEnd = [&]() -> uint32_t {
+        while (!deadEnds.empty()) {
+            uint32_t vertex = deadEnds.back();
+            deadEnds.pop_back();
+            if (liveTriangles[vertex] > 0)
+                return vertex;
+        }
+
+        for (; cursor < vertexCount; ++cursor) {
+            if (liveTriangles[cursor] > 0)
+                return cursor;
+        }
+
+        return invalidIndex;
+    };
+
+    uint32_t fan = skipDeadEnd();
+    while (fan != invalidIndex) {
+        candidates.clear();
+
+        for (uint32_t i = adjacency.offsets[fan]; i < adjacency.offsets[fan + 1]; ++i) {
+            uint32_t triangle = adjacency.triangles[i];
+            if (isEmitted[triangle])
+                continue;
+
+            for (uint32_t k = 0; k < 3; ++k) {
+                uint32_t vertex = indices[triangle * 3 + k];
+                result.emplace_back(vertex);
+                deadEnds.emplace_back(vertex);
+                candidates.emplace_back(vertex);
+                liveTriangles[vertex] -= 1;
+                cache.reference(vertex);
+            }
+
+            isEmitted[triangle] = true;
+        }
+
+        //  prefer the oldest vertex that is still cached after all of its remaining triangles are emitted
+        uint32_t next{invalidIndex};
+        int64_t bestPriority{-1};
+        for (uint32_t vertex : candidates) {
+            if (liveTriangles[vertex] == 0)
+                continue;
+
+            int64_t priority{0};
+            if (cache.getAge(vertex) + 2 * liveTriangles[vertex] <= cacheSize)
+                priority = cache.getAge(vertex);
+
+            if (priority > bestPriority) {
+                bestPriority = priority;
+                next = vertex;
+            }
+        }
+
+        fan = next != invalidIndex ? next : skipDeadEnd();
+    }
+
+    std::ranges::copy(result, indices.begin());
+}
+
+void MeshOptimizer::optimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex3D> vertices, float threshold, uint32_t cacheSize) {
+    const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triangleCount == 0)
+        return;
+
+    //  Sander et al. 2007: the vertex cache order is cut into clusters that are then sorted by how much they face
+    //  away from the center of the mesh, outer surfaces get drawn first and occlude the inner ones
+    CacheModel cache{static_cast<uint32_t>(vertices.size()), cacheSize};
+
+    //  missing all three vertices means the cache order jumped to a new fan, cutting there costs nothing
+    std::vector<uint32_t> hardBoundaries{};
+    for (uint32_t i = 0; i < triangleCount; ++i) {
+        if (cache.referenceTriangle(indices, i) == 3 || i == 0)
+            hardBoundaries.emplace_back(i);
+    }
+    hardBoundaries.emplace_back(triangleCount);
+
+    //  cut the clusters further for as long as the ACMR stays within threshold of the uncut cluster
+    std::vector<uint32_t> clusterStarts{};
+    for (uint32_t c = 0; c + 1 < hardBoundaries.size(); ++c) {
+        uint32_t start = hardBoundaries[c], end = hardBoundaries[c + 1];
+
+        cache.flush();
+        uint32_t clusterMisses{0};
+        for (uint32_t i = start; i < end; ++i)
+            clusterMisses += cache.referenceTriangle(indices, i);
+
+        float clusterThreshold = threshold * static_cast<float>(clusterMisses) / static_cast<float>(end - start);
+
+        cache.flush();
+        clusterStarts.emplace_back(start);
+
+        uint32_t runningMisses{0}, runningTriangles{0};
+        for (uint32_t i = start; i < end; ++i) {
+            runningMisses += cache.referenceTriangle(indices, i);
+            runningTriangles += 1;
+
+            if (static_cast<float>(runningMisses) <= clusterThreshold * static_cast<float>(runningTriangles) && i + 1 < end) {
+                clusterStarts.emplace_back(i + 1);
+                cache.flush();
+                runningMisses = runningTriangles = 0;
+            }
+        }
+    }
+    clusterStarts.emplace_back(triangleCount);
+
+    glm::vec3 meshCenter{0.0f};
+    for (const auto& vertex : vertices)
+        meshCenter += vertex.position;
+    meshCenter = meshCenter / static_cast<float>(std::max<size_t>(vertices.size(), 1));
+
+    const auto clusterCount = static_cast<uint32_t>(clusterStarts.size() - 1);
+    std::vector<float> sortKeys(clusterCount);
+
+    for (uint32_t c = 0; c < clusterCount; ++c) {
+        glm::vec3 centroid{0.0f}, normal{0.0f};
+        float area{0.0f};
+
+        for (uint32_t i = clusterStarts[c]; i < clusterStarts[c + 1]; ++i) {
+            glm::vec3 triangleNormal = getTriangleNormal(vertices, indices, i);
+            float triangleArea = glm::length(triangleNormal);
+
+            glm::vec3 triangleCenter = (vertices[indices[i * 3]].position + vertices[indices[i * 3 + 1]].position + vertices[indices[i * 3 + 2]].position) / 3.0f;
+
+            centroid += triangleCenter * triangleArea;
+            normal += triangleNormal;
+            area += triangleArea;
+        }
+
+        float normalLength = glm::length(normal);
+        if (area == 0.0f || normalLength == 0.0f)
+            continue;
+
+        sortKeys[c] = glm::dot(centroid / area - meshCenter, normal / normalLength);
+    }
+
+    std::vector<uint32_t> clusterOrder(clusterCount);
+    std::iota(clusterOrder.begin(), clusterOrder.end(), 0);
+    std::ranges::stable_sort(clusterOrder, std::greater{}, [&](uint32_t c) { return sortKeys[c]; });
+
+    std::vector<uint32_t> result{};
+    result.reserve(indices.size());
+    for (uint32_t c : clusterOrder)
+        result.insert(result.end(), indices.begin() + clusterStarts[c] * 3, indices.begin() + clusterStarts[c + 1] * 3);
+
+    std::ranges::copy(result, indices.begin());
+}
+
+void MeshOptimizer::optimizeVertexFetch(std::vector<Vertex3D>& vertices, std::span<uint32_t> indices) {
+    std::vector<uint32_t> remap(vertices.size(), invalidIndex);
+
+    uint32_t vertexCount{0};
+    for (uint32_t& index : indices) {
+        if (remap[index] == invalidIndex)
+            remap[index] = vertexCount++;
+        index = remap[index];
+    }
+
+    std::vector<Vertex3D> reordered(vertexCount);
+    for (uint32_t i = 0; i < vertices.size(); ++i) {
+        if (remap[i] != invalidIndex)
+            reordered[remap[i]] = vertices[i];
+    }
+
+    vertices = std::move(reordered);
+}
+
+std::vector<Meshlet> MeshOptimizer::buildMeshlets(std::span<const Vertex3D> vertices, std::span<const uint32_t> indices) {
+    std::vector<Meshlet> meshlets{};
+
+    const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triangleCount == 0)
+        return meshlets;
+
+    //  meshlet a vertex was last counted in, saves clearing a set for every meshlet
+    std::vector<uint32_t> vertexMeshlet(vertices.size(), invalidIndex);
+
+    Meshlet current{};
+    uint32_t currentVertexCount{0};
+
+    auto finish = [&] {
+        computeMeshletBounds(current, vertices, indices);
+        meshlets.emplace_back(current);
+    };
+
+    for (uint32_t i = 0; i < triangleCount; ++i) {
+        auto meshletIndex = static_cast<uint32_t>(meshlets.size());
+
+        uint32_t newVertexCount{0};
+        for (uint32_t k = 0; k < 3; ++k) {
+            uint32_t vertex = indices[i * 3 + k];
+            bool isDuplicate = (k > 0 && vertex == indices[i * 3]) || (k > 1 && vertex == indices[i * 3 + 1]);
+            if (vertexMeshlet[vertex] != meshletIndex && !isDuplicate)
+                newVertexCount += 1;
+        }
+
+        //  the meshlets follow the optimized triangle order, neighbouring triangles already share most vertices
+        if (current.triangleCount == maxMeshletTriangles || currentVertexCount + newVertexCount > maxMeshletVertices) {
+            finish();
+            current = Meshlet{.firstIndex = i * 3};
+            currentVertexCount = 0;
+            meshletIndex += 1;
+        }
+
+        for (uint32_t k = 0; k < 3; ++k) {
+            uint32_t vertex = indices[i * 3 + k];
+            if (vertexMeshlet[vertex] != meshletIndex) {
+                vertexMeshlet[vertex] = meshletIndex;
+                currentVertexCount += 1;
+            }
+        }
+
+        current.triangleCount += 1;
+    }
+
+    finish();
+    return meshlets;
+}
+
+MeshOptimizer::CacheStats MeshOptimizer::analyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize) {
+    const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triangleCount == 0)
+        return {};
+
+    CacheModel cache{vertexCount, cacheSize};
+    std::vector<bool> isReferenced(vertexCount, false);
+
+    uint32_t misses{0}, referencedCount{0};
+    for (uint32_t index : indices) {
+        misses += cache.reference(index);
+
+        if (!isReferenced[index]) {
+            isReferenced[index] = true;
+            referencedCount += 1;
+        }
+    }
+
+    return CacheStats{
+        .acmr = static_cast<float>(misses) / static_cast<float>(triangleCount),
+        .atvr = static_cast<float>(misses) / static_cast<float>(referencedCount)
+    };
+}
@@ -0,0 +1,94 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "../scene/Vertex.h"
+
+/**
+ * @brief cluster of up to maxMeshletVertices vertices and maxMeshletTriangles triangles, a contiguous range of the mesh's index buffer
+ *
+ * The bounds are in object space. The cluster is back facing as a whole (and can be culled) when
+ * dot(center - cameraPosition, coneAxis) >= coneCutoff * length(center - cameraPosition) + radius.
+ */
+struct Meshlet {
+    uint32_t firstIndex{0};
+    uint32_t triangleCount{0};
+
+    glm::vec3 center{0.0f};
+    float radius{0.0f};
+
+    glm::vec3 coneAxis{0.0f};
+
+    //  sine of the cone's half angle, 1 if the triangles face too many directions to ever cull the cluster
+    float coneCutoff{1.0f};
+};
+
+static_assert(sizeof(Meshlet) == 40);
+
+/**
+ * @brief reorders the geometry of imported meshes for the GPU
+ *
+ * Triangles are first reordered for the post transform vertex cache (Tipsify), then clusters of them are
+ * sorted to draw outward facing parts first and reduce overdraw, and finally vertices are renumbered in the
+ * order they are first referenced so that vertex fetch walks memory linearly. The result is split into meshlets
+ * for later cluster culling.
+ */
+class MeshOptimizer {
+public:
+    MeshOptimizer() = delete; //static class
+
+    struct CacheStats {
+        //  average cache miss ratio, transformed vertices per triangle (0.5 is ideal on large grids, 3 is the worst)
+        float acmr{0.0f};
+
+        //  average transformed vertex ratio, transformed vertices per vertex (1 is ideal)
+        float atvr{0.0f};
+    };
+
+    struct Report {
+        CacheStats before{};
+        CacheStats after{};
+        uint32_t meshletCount{0};
+    };
+
+    /**
+     * @brief runs the whole pipeline, unreferenced vertices are dropped
+     */
+    static Report optimize(std::vector<Vertex3D>& vertices, std::vector<uint32_t>& indices, std::vector<Meshlet>& meshlets);
+
+    /**
+     * @brief reorders triangles for a FIFO vertex cache of cacheSize entries
+     */
+    static void optimizeVertexCache(std::span<uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = defaultCacheSize);
+
+    /**
+     * @brief sorts clusters of an already cache optimized index buffer front to back from the outside of the mesh
+     * @param threshold how much worse than the vertex cache optimized order the ACMR may get, 1.05 allows 5 %
+     */
+    static void optimizeOverdraw(std::span<uint32_t> indices, std::span<const Vertex3D> vertices, float threshold = 1.05f, uint32_t cacheSize = defaultCacheSize);
+
+    /**
+     * @brief renumbers vertices in the order of first use and drops the unreferenced ones
+     */
+    static void optimizeVertexFetch(std::vector<Vertex3D>& vertices, std::span<uint32_t> indices);
+
+    static std::vector<Meshlet> buildMeshlets(std::span<const Vertex3D> vertices, std::span<const uint32_t> indices);
+
+    /**
+     * @brief simulates a FIFO vertex cache, ATVR is relative to the vertices referenced by the indices
+     */
+    static CacheStats analyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertexCount, uint32_t cacheSize = defaultCacheSize);
+
+    static constexpr uint32_t defaultCacheSize{16};
+
+    //  what mesh shading hardware is typically tuned for
+    static constexpr uint32_t maxMeshletVertices{64};
+    static constexpr uint32_t maxMeshletTriangles{124};
+};
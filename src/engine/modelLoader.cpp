@@ -3,238 +3,380 @@
 //
 
 #include "modelLoader.h"
+#include <array>
+#include <chrono>
+#include <iomanip>
 #include <iostream>
 #include <set>
-#include <thread>
+#include <unordered_map>
 
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 
 
-#include "utils.h"
+#include "engine.h"
+#include "jobSystem.h"
+#include "meshOptimizer.h"
+#include "pixelConversion.h"
+#include "profiler.h"
 
 #include "managers/resourceManager.h"
 
 std::vector<std::shared_ptr<Mesh>> ModelLoader::loadModel(std::string_view path, bool multithread) {
-    std::string fullPath{ModelLoader::modelPathPrefix + std::string{path}};
-
-    Assimp::Importer importer;
+    Profiler::Scope scope{"ModelLoader::loadModel"};
+    auto loadStart = std::chrono::steady_clock::now();
 
-    const aiScene* scene = importer.ReadFile(fullPath.c_str(),
-                                             aiProcess_Triangulate |
-                                             //aiProcess_GenSmoothNormals |
-                                             aiProcess_JoinIdenticalVertices |
-                                             aiProcess_OptimizeGraph |
-                                             aiProcess_OptimizeMeshes |
-                                             aiProcess_CalcTangentSpace);
-
-    if (scene == nullptr)
-        throw std::runtime_error(importer.GetErrorString());
+    std::string fullPath{ModelLoader::modelPathPrefix + std::string{path}};
 
     auto lastSlashPos = std::string{ fullPath }.find_last_of('/');
     std::string directory{fullPath};
     directory = directory.substr(0, lastSlashPos + 1);
 
+    //  try the mesh cache first, the importer only runs if it is missing or stale
+    //  shared as the meshes read their geometry straight from its mapping until they are uploaded
+    std::shared_ptr<const MeshCache> cache{};
+    uint64_t sourceHash{0};
 
-    std::vector<std::shared_ptr<Mesh>> meshes{};
-    std::vector<std::shared_ptr<Material>> materials{};
-
-    uint32_t workerCount = std::thread::hardware_concurrency();
-    uint32_t numMaterials =  scene->mNumMaterials;
-    uint32_t chunkSize = numMaterials / workerCount;
+    if (useMeshCache) {
+        sourceHash = MeshCache::hashSource(fullPath);
+        if (auto openedCache = MeshCache::open(getCachePath(path), sourceHash, importerFlags))
+            cache = std::make_shared<const MeshCache>(std::move(*openedCache));
+    }
 
-    std::vector<std::thread> workers{};
-    workers.reserve(workerCount);
+    std::vector<MeshCache::MeshData> importedMeshes{};
+    std::vector<MeshCache::MaterialData> materialData{};
 
+    if (cache)
+        materialData = cache->readMaterials();
+    else {
+        importModel(fullPath, importedMeshes, materialData);
+        optimizeMeshes(importedMeshes, multithread);
 
-    if (multithread) {
-        for (int i = 0; i < workerCount; ++i) {
-            std::thread thread(loadMaterials,directory,std::ref(*scene), i* chunkSize, chunkSize, std::ref(materials));
-            workers.emplace_back(std::move(thread));
-        }
-        for (auto& worker : workers) {
-            worker.join();
-        }
+        if (useMeshCache)
+            MeshCache::write(getCachePath(path), sourceHash, importerFlags, importedMeshes, materialData);
     }
-    else
-        loadMaterials(directory, *scene, 0, scene->mNumMaterials, materials);
 
-    //  in mesh
-    uint32_t stagingBufferSize{0};
+    uint32_t meshCount = cache ? cache->getMeshCount() : static_cast<uint32_t>(importedMeshes.size());
 
-    for (uint32_t i = 0; i < scene->mNumMeshes; ++i) {
-        const auto& mesh = scene->mMeshes[i];
+    //  every texture and mesh of the model is uploaded in a single batch
+    StagingRing& stagingRing = Engine::getInstance().getStagingRing();
+    StagingRing::Stats stagingStatsBefore = stagingRing.getStats();
+    UploadBatch uploadBatch{stagingRing};
 
-        //  load vertices
-        std::vector<Vertex3D> vertices{};
-        vertices.reserve(mesh->mNumVertices);
-        for (uint32_t j = 0; j < mesh->mNumVertices; ++j) {
-            aiVector3D position_{}, normal_{}, tangent_{}, texCoord_{};
-            glm::vec3 position{}, normal{}, tangent{};
-            glm::vec2 texCoord{};
-
-            if (mesh->mVertices) {
-                position_ = mesh->mVertices[j];
-                position = {position_.x, position_.y, position_.z};
-            }
-            if (mesh->mNormals) {
-                normal_ = mesh->mNormals[j];
-                normal = {normal_.x, normal_.y, normal_.z};
-            }
-            if (mesh->mTangents) {
-                tangent_ = mesh->mTangents[j];
-                tangent = {tangent_.x, tangent_.y, tangent_.z};
-            }
-            if (mesh->mTextureCoords[0]) {
-                texCoord_ = mesh->mTextureCoords[0][j];
-                texCoord = {texCoord_.x, texCoord_.y};
-            }
-            vertices.emplace_back(position, normal, tangent, texCoord);
-        }
-
-        //  load indices
-        std::vector<uint32_t> indices{};
-        indices.reserve(mesh->mNumFaces);
-        for (uint32_t j = 0; j < mesh->mNumFaces; ++j) {
-            const auto& face = mesh->mFaces[j];
+    std::vector<std::shared_ptr<Mesh>> meshes{};
+    std::vector<std::shared_ptr<Material>> materials = loadMaterials(directory, materialData, multithread, uploadBatch);
 
-            for (uint32_t k = 0; k < face.mNumIndices; ++k)
-                indices.push_back(face.mIndices[k]);
-        }
+    for (uint32_t i = 0; i < meshCount; ++i) {
+        std::string meshName{cache ? cache->getMeshName(i) : importedMeshes[i].name};
+        uint32_t materialIndex = cache ? cache->getMaterialIndex(i) : importedMeshes[i].materialIndex;
 
         //load material
-        std::shared_ptr<Material> material = materials.at(mesh->mMaterialIndex);
+        std::shared_ptr<Material> material = materials.at(materialIndex);
+
+        //  cached geometry is staged straight from the mapped file, the meshes keep the mapping alive
+        std::shared_ptr<Mesh> parsedMesh{nullptr};
+        if (cache)
+            parsedMesh = MeshManager::getInstance()->getOrRegisterResource(meshName, cache->getVertices(i), cache->getIndices(i), material, cache->getMeshlets(i),
+                                                                           std::shared_ptr<const void>{cache});
+        else
+            parsedMesh = MeshManager::getInstance()->getOrRegisterResource(meshName, std::move(importedMeshes[i].vertices),std::move(importedMeshes[i].indices),material,
+                                                                           std::move(importedMeshes[i].meshlets));
+
+        parsedMesh->stage(uploadBatch);
+        meshes.emplace_back(parsedMesh);
+    }
 
-        std::shared_ptr<Mesh> parsedMesh = MeshManager::getInstance()->getResource(mesh->mName.C_Str());
+    auto uploadStart = std::chrono::steady_clock::now();
+    uploadBatch.submitAndWait();
+    auto uploadTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - uploadStart);
 
-        if (parsedMesh == nullptr)
-            parsedMesh = MeshManager::getInstance()->registerResource(mesh->mName.C_Str(), std::move(vertices),std::move(indices),material);
+    const StagingRing::Stats& stagingStats = stagingRing.getStats();
+    double uploadedMB = static_cast<double>(stagingStats.stagedBytes - stagingStatsBefore.stagedBytes) / (1024.0 * 1024.0);
 
-        //  if this mesh is larger than current largest mesh, update the value so that the staging buffer can later contain all the data
-        uint32_t verticesSize = parsedMesh->getVertices().size() * sizeof(parsedMesh->getVertices()[0]);
-        uint32_t indicesSize = parsedMesh->getIndices().size() * sizeof(parsedMesh->getIndices()[0]);
-        if (verticesSize > stagingBufferSize)
-            stagingBufferSize = verticesSize;
-        if (indicesSize > stagingBufferSize)
-            stagingBufferSize = indicesSize;
+    auto loadTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - loadStart);
+    std::cout << "Loaded model " << path << " in " << loadTime.count() << " ms (" << (cache ? "mesh cache hit" : "imported") << ")" << std::endl;
+    std::cout << "  uploaded " << uploadedMB << " MB in " << stagingStats.submissions - stagingStatsBefore.submissions << " submission(s), "
+              << (uploadTime.count() > 0.0 ? uploadedMB / uploadTime.count() : 0.0) << " MB/s" << std::endl;
 
+    return meshes;
+}
 
-        meshes.emplace_back(parsedMesh);
-    }
+void ModelLoader::importModel(const std::string& fullPath, std::vector<MeshCache::MeshData>& meshes, std::vector<MeshCache::MaterialData>& materials) {
+    Assimp::Importer importer;
 
-    VkUtils::BufferAlloc stagingBuffer = VkUtils::createBufferVMA(stagingBufferSize,vk::BufferUsageFlagBits::eTransferSrc,VkUtils::stagingAllocFlagsVMA);
+    const aiScene* scene = importer.ReadFile(fullPath.c_str(), importerFlags);
 
-    for (auto& mesh : meshes) {
-        mesh->stage(stagingBuffer);
-    }
-    // destroy staging buffer
-    VkUtils::destroyBufferVMA(std::move(stagingBuffer));
+    if (scene == nullptr)
+        throw std::runtime_error(importer.GetErrorString());
 
-    return meshes;
+    materials.reserve(scene->mNumMaterials);
+    for (uint32_t i = 0; i < scene->mNumMaterials; ++i)
+        materials.emplace_back(convertMaterial(*scene->mMaterials[i]));
+
+    meshes.reserve(scene->mNumMeshes);
+    for (uint32_t i = 0; i < scene->mNumMeshes; ++i)
+        meshes.emplace_back(convertMesh(*scene->mMeshes[i]));
 }
 
-void ModelLoader::loadMaterials(const std::string& directory, const aiScene& scene, uint32_t startIndex, uint32_t materialCount,
-                                std::vector<std::shared_ptr<Material> >& materials) {
+void ModelLoader::optimizeMeshes(std::vector<MeshCache::MeshData>& meshes, bool multithread) {
+    std::vector<MeshOptimizer::Report> reports(meshes.size());
 
+    auto optimizeRange = [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i)
+            reports[i] = MeshOptimizer::optimize(meshes[i].vertices, meshes[i].indices, meshes[i].meshlets);
+    };
 
-    // used to identify textures for staging
-    std::set<std::string> textureNames{};
-    uint32_t stagingBufferSize{0};
+    if (multithread)
+        JobSystem::getInstance().parallelFor(static_cast<uint32_t>(meshes.size()), 1, optimizeRange);
+    else
+        optimizeRange(0, static_cast<uint32_t>(meshes.size()));
 
-    //first load material data into ram
-    for (uint32_t i = startIndex; i < startIndex + materialCount && i < scene.mNumMaterials; ++i){
-        const aiMaterial* const assimpMaterial = scene.mMaterials[i];
+    uint64_t triangleCount{0};
+    double missesBefore{0.0}, missesAfter{0.0};
 
-        aiString name;
+    std::cout << "Optimized " << meshes.size() << " mesh(es) (ACMR / ATVR before -> after):" << std::endl;
+    for (uint32_t i = 0; i < meshes.size(); ++i) {
+        const auto& report = reports[i];
+        auto meshTriangles = static_cast<uint32_t>(meshes[i].indices.size() / 3);
 
-        //skip material if it doesn't have a name
-        if (assimpMaterial->Get(AI_MATKEY_NAME, name) != aiReturn_SUCCESS)
-            continue;
+        std::cout << std::fixed << std::setprecision(3)
+                  << "  " << meshes[i].name << ": " << report.before.acmr << " / " << report.before.atvr << " -> "
+                  << report.after.acmr << " / " << report.after.atvr << ", " << report.meshletCount << " meshlets" << std::endl;
 
-        std::shared_ptr<Material> mat = MaterialManager::getInstance()->getResource(name.C_Str());
+        triangleCount += meshTriangles;
+        missesBefore += static_cast<double>(report.before.acmr) * meshTriangles;
+        missesAfter += static_cast<double>(report.after.acmr) * meshTriangles;
+    }
 
-        if (mat == nullptr)
-            mat = MaterialManager::getInstance()->registerResource(name.C_Str());
+    if (triangleCount > 0)
+        std::cout << "  total ACMR: " << missesBefore / static_cast<double>(triangleCount) << " -> " << missesAfter / static_cast<double>(triangleCount) << std::endl;
+    std::cout << std::defaultfloat;
+}
 
-        //====================================================
-        //gamma correctable values first
-        if (aiColor3D aiDiffuse{}; assimpMaterial->Get(AI_MATKEY_COLOR_DIFFUSE, aiDiffuse) == aiReturn_SUCCESS) {
-            mat->setDiffuseAlbedo({ aiDiffuse.r,aiDiffuse.g,aiDiffuse.b });
-            if (ModelLoader::gammaCorrectOnLoad)
-                mat->setDiffuseAlbedo(Utils::expand(mat->getDiffuseAlbedo()));
+MeshCache::MeshData ModelLoader::convertMesh(const aiMesh& mesh) {
+    MeshCache::MeshData meshData{
+        .name = mesh.mName.C_Str(),
+        .materialIndex = mesh.mMaterialIndex
+    };
+
+    //  load vertices
+    auto& vertices = meshData.vertices;
+    vertices.reserve(mesh.mNumVertices);
+    for (uint32_t j = 0; j < mesh.mNumVertices; ++j) {
+        aiVector3D position_{}, normal_{}, tangent_{}, texCoord_{};
+        glm::vec3 position{}, normal{}, tangent{};
+        glm::vec2 texCoord{};
+
+        if (mesh.mVertices) {
+            position_ = mesh.mVertices[j];
+            position = {position_.x, position_.y, position_.z};
         }
-
-        if (aiColor3D aiSpecular{}; assimpMaterial->Get(AI_MATKEY_COLOR_SPECULAR, aiSpecular) == aiReturn_SUCCESS) {
-            mat->setSpecularAlbedo({ aiSpecular.r,aiSpecular.g,aiSpecular.b });
-            if (ModelLoader::gammaCorrectOnLoad)
-                mat->setSpecularAlbedo(Utils::expand(mat->getSpecularAlbedo()));
+        if (mesh.mNormals) {
+            normal_ = mesh.mNormals[j];
+            normal = {normal_.x, normal_.y, normal_.z};
+        }
+        if (mesh.mTangents) {
+            tangent_ = mesh.mTangents[j];
+            tangent = {tangent_.x, tangent_.y, tangent_.z};
         }
-        //====================================================
+        if (mesh.mTextureCoords[0]) {
+            texCoord_ = mesh.mTextureCoords[0][j];
+            texCoord = {texCoord_.x, texCoord_.y};
+        }
+        vertices.emplace_back(position, normal, tangent, texCoord);
+    }
 
-        //====================================================
-        //remaining material_ attributes
-        if (aiColor3D aiEmissive{}; assimpMaterial->Get(AI_MATKEY_COLOR_EMISSIVE, aiEmissive) == aiReturn_SUCCESS)
-            mat->setEmission({ aiEmissive.r,aiEmissive.g,aiEmissive.b });
+    //  load indices
+    auto& indices = meshData.indices;
+    indices.reserve(mesh.mNumFaces * 3);
+    for (uint32_t j = 0; j < mesh.mNumFaces; ++j) {
+        const auto& face = mesh.mFaces[j];
 
-        if (float aiShininess{}; assimpMaterial->Get(AI_MATKEY_SHININESS, aiShininess) == aiReturn_SUCCESS)
-            mat->setShininess(aiShininess);
+        for (uint32_t k = 0; k < face.mNumIndices; ++k)
+            indices.push_back(face.mIndices[k]);
+    }
+
+    return meshData;
+}
+
+MeshCache::MaterialData ModelLoader::convertMaterial(const aiMaterial& assimpMaterial) {
+    MeshCache::MaterialData materialData{};
 
-        if (float aiIOR{}; assimpMaterial->Get(AI_MATKEY_REFRACTI, aiIOR) == aiReturn_SUCCESS)
-            mat->setIor(aiIOR);
+    //  materials without a name keep an empty one, loadMaterials names them after the model directory and their index
+    if (aiString name; assimpMaterial.Get(AI_MATKEY_NAME, name) == aiReturn_SUCCESS)
+        materialData.name = name.C_Str();
 
-        if (aiColor3D aiAttenuation{}; assimpMaterial->Get(AI_MATKEY_COLOR_TRANSPARENT, aiAttenuation) == aiReturn_SUCCESS)
-            mat->setAttenuation({ aiAttenuation.r, aiAttenuation.g, aiAttenuation.b });
+    if (aiColor3D aiDiffuse{}; assimpMaterial.Get(AI_MATKEY_COLOR_DIFFUSE, aiDiffuse) == aiReturn_SUCCESS)
+        materialData.diffuseAlbedo = { aiDiffuse.r,aiDiffuse.g,aiDiffuse.b };
 
-        //====================================================
+    if (aiColor3D aiSpecular{}; assimpMaterial.Get(AI_MATKEY_COLOR_SPECULAR, aiSpecular) == aiReturn_SUCCESS)
+        materialData.specularAlbedo = { aiSpecular.r,aiSpecular.g,aiSpecular.b };
 
-        //====================================================
-        //textures
-        aiString texName;
+    if (aiColor3D aiEmissive{}; assimpMaterial.Get(AI_MATKEY_COLOR_EMISSIVE, aiEmissive) == aiReturn_SUCCESS)
+        materialData.emission = { aiEmissive.r,aiEmissive.g,aiEmissive.b };
 
-        for (uint32_t j = 0; j < textureTypes.size(); ++j) {
-            auto texType = ModelLoader::textureTypes[j];
-            auto slot = ModelLoader::slots[j];
+    if (float aiShininess{}; assimpMaterial.Get(AI_MATKEY_SHININESS, aiShininess) == aiReturn_SUCCESS)
+        materialData.shininess = aiShininess;
 
-            if (assimpMaterial->Get(AI_MATKEY_TEXTURE(texType, 0), texName) == AI_SUCCESS){
+    if (float aiIOR{}; assimpMaterial.Get(AI_MATKEY_REFRACTI, aiIOR) == aiReturn_SUCCESS)
+        materialData.ior = aiIOR;
 
-                std::string fullName{ directory + std::string{texName.C_Str()}};
-                auto texture = TextureManager::getInstance()->getResource(fullName);
+    if (aiColor3D aiAttenuation{}; assimpMaterial.Get(AI_MATKEY_COLOR_TRANSPARENT, aiAttenuation) == aiReturn_SUCCESS)
+        materialData.attenuation = { aiAttenuation.r, aiAttenuation.g, aiAttenuation.b };
 
-                if (texture == nullptr) {
-                    bool isSrgb = slot != Material::TextureMapSlot::normalMapSlot;
-                    texture  = TextureManager::getInstance()->registerResource(fullName, fullName, isSrgb);
+    for (uint32_t j = 0; j < textureTypes.size(); ++j) {
+        if (aiString texName; assimpMaterial.Get(AI_MATKEY_TEXTURE(textureTypes[j], 0), texName) == AI_SUCCESS)
+            materialData.textureNames[static_cast<uint8_t>(slots[j])] = texName.C_Str();
+    }
+
+    return materialData;
+}
 
-                    //  this is a new texture, so mark it for staging
-                    textureNames.insert(texture->getResourceName());
-                }
-                mat->setTexture(texture,slot);
+std::string ModelLoader::getCachePath(std::string_view path) {
+    return modelCachePathPrefix + std::string{path} + ".dpmc";
+}
 
-                uint32_t texSize = texture->getTotalSize();
-                if (texSize > stagingBufferSize) stagingBufferSize = texSize;
+std::vector<std::shared_ptr<Material>> ModelLoader::loadMaterials(const std::string& directory, const std::vector<MeshCache::MaterialData>& materialData, bool multithread, UploadBatch& batch) {
+    auto& jobSystem = JobSystem::getInstance();
+
+    auto forEach = [&jobSystem, multithread](uint32_t count, uint32_t grainSize, const std::function<void(uint32_t, uint32_t)>& body) {
+        if (multithread)
+            jobSystem.parallelFor(count, grainSize, body);
+        else
+            body(0, count);
+    };
+
+    //====================================================
+    //  collect every texture that isn't loaded yet, shared textures are decoded only once
+    struct TextureRequest {
+        std::string fullName{};
+        bool isSrgb{};
+        std::shared_ptr<Texture> texture{nullptr};
+    };
+
+    std::vector<TextureRequest> textureRequests{};
+    std::set<std::string> requestedNames{};
+
+    for (const auto& data : materialData) {
+        for (auto slot : ModelLoader::slots) {
+            const auto& texName = data.textureNames[static_cast<uint8_t>(slot)];
+            if (texName.empty())
+                continue;
+
+            std::string fullName{ directory + texName};
+            if (requestedNames.insert(fullName).second && TextureManager::getInstance()->getResource(fullName) == nullptr) {
+                bool isSrgb = slot != Material::TextureMapSlot::normalMapSlot;
+                textureRequests.emplace_back(TextureRequest{.fullName = fullName, .isSrgb = isSrgb});
             }
         }
+    }
+
+    //====================================================
+    //  streamed textures are decoded and uploaded in the background, material maps stay unset until then
+    if (streamTextures) {
+        for (auto& request : textureRequests)
+            request.texture = Engine::getInstance().getTextureStreamer().request(request.fullName, request.isSrgb);
+    }
+    else {
+        //  decode textures in parallel, one texture per task as they differ a lot in size
+        auto decodeStart = std::chrono::steady_clock::now();
+
+        forEach(textureRequests.size(), 1, [&textureRequests](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                auto& request = textureRequests[i];
+                request.texture = TextureManager::getInstance()->getOrRegisterResource(request.fullName, request.fullName, request.isSrgb);
+            }
+        });
 
-        // finish material setup
-        mat->recordDescriptorSet();
-        mat->updateUBONow();
+        auto decodeTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - decodeStart);
+        std::cout << "Decoded " << textureRequests.size() << " textures on " << (multithread ? jobSystem.getThreadCount() : 1) << " thread(s) in " << decodeTime.count() << " ms" << std::endl;
+    }
+
+    //====================================================
+    //  set up materials, the result is indexed the same way as the source materials so that meshes can refer to them positionally
+    std::vector<std::shared_ptr<Material>> materials(materialData.size());
+
+    //  materials sharing a name resolve to the same resource, only the first one of them is set up
+    std::vector<uint32_t> uniqueMaterials{};
+    std::vector<uint32_t> firstOccurrence(materialData.size());
+    std::unordered_map<std::string, uint32_t> nameToIndex{};
+
+    auto getMaterialName = [&](uint32_t index) {
+        //  unnamed materials still need an entry, otherwise the mesh material indices would be shifted
+        if (materialData[index].name.empty())
+            return directory + "material_" + std::to_string(index);
+        return materialData[index].name;
+    };
+
+    for (uint32_t i = 0; i < materialData.size(); ++i) {
+        auto [it, inserted] = nameToIndex.try_emplace(getMaterialName(i), i);
+        firstOccurrence[i] = it->second;
+        if (inserted)
+            uniqueMaterials.push_back(i);
+    }
 
-        {
-            std::lock_guard<std::mutex> lockGuard(materialVectorMutex_);
-            materials.emplace_back(mat);
+    forEach(uniqueMaterials.size(), 0, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i) {
+            uint32_t materialIndex = uniqueMaterials[i];
+            materials[materialIndex] = setupMaterial(directory, getMaterialName(materialIndex), materialData[materialIndex]);
         }
+    });
+
+    for (uint32_t i = 0; i < materialData.size(); ++i)
+        materials[i] = materials[firstOccurrence[i]];
+
+    //====================================================
+    //  record the new textures into the model's batch, recording stays on this thread as the batch isn't thread safe
+    //  streamed textures are uploaded by the streamer instead
+    if (streamTextures)
+        return materials;
+
+    for (const auto& request : textureRequests) {
+        if (request.texture->getUploadSize() != 0)
+            request.texture->stage(batch);
     }
 
-    // only stage if there's something to stage
-    if (!textureNames.empty() && stagingBufferSize != 0) {
+    return materials;
+}
 
-        VkUtils::BufferAlloc stagingBuffer = VkUtils::createBufferVMA(stagingBufferSize,vk::BufferUsageFlagBits::eTransferSrc,VkUtils::stagingAllocFlagsVMA);
+std::shared_ptr<Material> ModelLoader::setupMaterial(const std::string& directory, const std::string& name, const MeshCache::MaterialData& data) {
+    std::shared_ptr<Material> mat = MaterialManager::getInstance()->getOrRegisterResource(name);
 
-        //  now stage all marked textures
-        for (const auto & textureName : textureNames) {
-            auto texture = TextureManager::getInstance()->getResource(textureName);
-            texture->stage(stagingBuffer);
-        }
-        // destroy staging buffer
-        VkUtils::destroyBufferVMA(std::move(stagingBuffer));
+    //====================================================
+    //gamma correctable values first
+    glm::vec3 diffuseAlbedo = data.diffuseAlbedo;
+    glm::vec3 specularAlbedo = data.specularAlbedo;
+    if (ModelLoader::gammaCorrectOnLoad) {
+        //  same conversion as the texture texels, so colors and maps of a material agree
+        std::array albedos{diffuseAlbedo.r, diffuseAlbedo.g, diffuseAlbedo.b, specularAlbedo.r, specularAlbedo.g, specularAlbedo.b};
+        PixelConversion::srgbToLinear(albedos, false);
+
+        diffuseAlbedo = {albedos[0], albedos[1], albedos[2]};
+        specularAlbedo = {albedos[3], albedos[4], albedos[5]};
+    }
+    mat->setDiffuseAlbedo(diffuseAlbedo);
+    mat->setSpecularAlbedo(specularAlbedo);
+    //====================================================
+
+    //====================================================
+    //remaining material_ attributes
+    mat->setEmission(data.emission);
+    mat->setShininess(data.shininess);
+    mat->setIor(data.ior);
+    mat->setAttenuation(data.attenuation);
+    //====================================================
+
+    //====================================================
+    //textures, all of them are registered by now
+    for (auto slot : ModelLoader::slots) {
+        const auto& texName = data.textureNames[static_cast<uint8_t>(slot)];
+
+        if (!texName.empty())
+            mat->setTexture(TextureManager::getInstance()->getResource(directory + texName), slot);
     }
+
+    // finish material setup, the map handles were set along with the textures
+    mat->updateUBO();
+
+    return mat;
 }
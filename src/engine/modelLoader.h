@@ -5,9 +5,10 @@
 #pragma once
 #include <string>
 #include <memory>
-#include <mutex>
 #include <assimp/scene.h>
+#include <assimp/postprocess.h>
 
+#include "meshCache.h"
 #include "../scene/material.h"
 #include "../scene/mesh.h"
 
@@ -15,16 +16,49 @@ class ModelLoader {
 public:
     static std::vector<std::shared_ptr<Mesh>> loadModel(std::string_view path, bool multithread = true);
 
+    //  converts the importer's output into the cacheable representation, public so that generated scenes can be fed to them
+    static MeshCache::MeshData convertMesh(const aiMesh& mesh);
+    static MeshCache::MaterialData convertMaterial(const aiMaterial& material);
+
+    /**
+     * @brief decodes the textures and sets up the materials in parallel, public so that its scaling can be measured
+     * @return materials indexed the same way as materialData
+     */
+    static std::vector<std::shared_ptr<Material>> loadMaterials(const std::string& directory, const std::vector<MeshCache::MaterialData>& materialData, bool multithread, UploadBatch& batch);
+
+    //  decode textures in the background instead of while loading, off makes loadMaterials decode and stage them itself
+    inline static bool streamTextures{true};
+
 private:
-    static void loadMaterials(const std::string& directory, const aiScene& scene, uint32_t startIndex, uint32_t materialCount,
-                              std::vector<std::shared_ptr<Material> >& materials);
+
+    static std::shared_ptr<Material> setupMaterial(const std::string& directory, const std::string& name, const MeshCache::MaterialData& data);
+
+    /**
+     * @brief runs the importer on the source file and converts its output into the cacheable representation
+     */
+    static void importModel(const std::string& fullPath, std::vector<MeshCache::MeshData>& meshes, std::vector<MeshCache::MaterialData>& materials);
+
+    /**
+     * @brief reorders the imported geometry for the vertex cache, overdraw and vertex fetch and builds the meshlets,
+     * prints the ACMR and ATVR of every mesh before and after
+     */
+    static void optimizeMeshes(std::vector<MeshCache::MeshData>& meshes, bool multithread);
+
+    static std::string getCachePath(std::string_view path);
 
     inline static bool gammaCorrectOnLoad{false};
+    inline static bool useMeshCache{true};
 
     inline static const std::string modelPathPrefix{"../assets/models/"};
+    inline static const std::string modelCachePathPrefix{"cache/models/"};
+
+    static constexpr uint32_t importerFlags{aiProcess_Triangulate |
+                                            //aiProcess_GenSmoothNormals |
+                                            aiProcess_JoinIdenticalVertices |
+                                            aiProcess_OptimizeGraph |
+                                            aiProcess_OptimizeMeshes |
+                                            aiProcess_CalcTangentSpace};
 
     static constexpr std::array textureTypes = {aiTextureType_SPECULAR, aiTextureType_SHININESS, aiTextureType_NORMALS, aiTextureType_DIFFUSE, };
     static constexpr std::array slots = {Material::TextureMapSlot::specularMapSlot,Material::TextureMapSlot::shininessMapSlot,Material::TextureMapSlot::normalMapSlot, Material::TextureMapSlot::diffuseMapSlot,};
-
-    inline static std::mutex materialVectorMutex_{};
-};
\ No newline at end of file
+};
@@ -0,0 +1,184 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "objectPicker.h"
+
+#include <algorithm>
+
+#include "../scene/texture.h"
+
+ObjectPicker::ObjectPicker(uint32_t frameCount) {
+    frames_.resize(frameCount);
+}
+
+ObjectPicker::~ObjectPicker() {
+    for (auto& frame : frames_) {
+        if (frame.capacity > 0)
+            VkUtils::destroyBufferVMA(std::move(frame.buffer));
+    }
+}
+
+void ObjectPicker::pick(glm::ivec2 position, Callback callback) {
+    pickRect(position, position, std::move(callback));
+}
+
+void ObjectPicker::pickRect(glm::ivec2 corner0, glm::ivec2 corner1, Callback callback) {
+    glm::ivec2 min = glm::min(corner0, corner1);
+    glm::ivec2 max = glm::max(corner0, corner1);
+
+    pendingQueries_.emplace_back(Query{
+        .offset = {.x = min.x, .y = min.y},
+        .extent = {.width = static_cast<uint32_t>(max.x - min.x + 1), .height = static_cast<uint32_t>(max.y - min.y + 1)},
+        .callback = std::move(callback),
+        .queuedFrame = frameCounter_
+    });
+}
+
+void ObjectPicker::beginFrame(uint32_t frameIndex) {
+    resolve(frames_[frameIndex]);
+}
+
+void ObjectPicker::flush() {
+    for (auto& frame : frames_)
+        resolve(frame);
+}
+
+void ObjectPicker::record(vk::raii::CommandBuffer& cmdBuf, uint32_t frameIndex, const Texture& idMap, vk::Extent2D extent) {
+    FrameReadback& frame = frames_[frameIndex];
+    frameCounter_ += 1;
+
+    if (hoverPosition_.has_value())
+        pendingQueries_.emplace_back(Query{
+            .offset = {.x = hoverPosition_->x, .y = hoverPosition_->y},
+            .extent = {.width = 1, .height = 1},
+            .queuedFrame = frameCounter_ - 1,
+            .isHover = true
+        });
+
+    if (pendingQueries_.empty())
+        return;
+
+    //  the window may have been resized since the queries were made, clip them to the ID map
+    std::vector<vk::BufferImageCopy> regions{};
+    vk::DeviceSize size{0};
+
+    for (auto& query : pendingQueries_) {
+        int32_t x0 = std::clamp(query.offset.x, 0, static_cast<int32_t>(extent.width));
+        int32_t y0 = std::clamp(query.offset.y, 0, static_cast<int32_t>(extent.height));
+        int32_t x1 = std::clamp(query.offset.x + static_cast<int32_t>(query.extent.width), 0, static_cast<int32_t>(extent.width));
+        int32_t y1 = std::clamp(query.offset.y + static_cast<int32_t>(query.extent.height), 0, static_cast<int32_t>(extent.height));
+
+        query.offset = vk::Offset2D{.x = x0, .y = y0};
+        query.extent = vk::Extent2D{.width = static_cast<uint32_t>(x1 - x0), .height = static_cast<uint32_t>(y1 - y0)};
+        query.bufferOffset = size;
+
+        //  queries outside of the window still get their (empty) result
+        if (query.extent.width == 0 || query.extent.height == 0)
+            continue;
+
+        regions.emplace_back(vk::BufferImageCopy{
+            .bufferOffset = query.bufferOffset,
+            .imageSubresource = {
+                .aspectMask = vk::ImageAspectFlagBits::eColor,
+                .mipLevel = 0,
+                .baseArrayLayer = 0,
+                .layerCount = 1,
+            },
+            .imageOffset = {.x = x0, .y = y0, .z = 0},
+            .imageExtent = {.width = query.extent.width, .height = query.extent.height, .depth = 1}
+        });
+
+        size += static_cast<vk::DeviceSize>(query.extent.width) * query.extent.height * sizeof(uint32_t);
+    }
+
+    //  the frame's previous queries were resolved in beginFrame, its buffer is free
+    reserve(frame, size);
+    frame.queries = std::move(pendingQueries_);
+    pendingQueries_.clear();
+
+    if (regions.empty())
+        return;
+
+    VkUtils::transitionImageLayout(idMap.getVkImage().image,
+                                   vk::ImageLayout::eColorAttachmentOptimal,
+                                   vk::ImageLayout::eTransferSrcOptimal,
+                                   vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                                   vk::AccessFlagBits2::eColorAttachmentWrite,
+                                   vk::PipelineStageFlagBits2::eCopy,
+                                   vk::AccessFlagBits2::eTransferRead,
+                                   vk::ImageAspectFlagBits::eColor,
+                                   cmdBuf);
+
+    cmdBuf.copyImageToBuffer(idMap.getVkImage().image, vk::ImageLayout::eTransferSrcOptimal, frame.buffer.buffer, regions);
+
+    //  the next frame clears the ID map as an attachment
+    VkUtils::transitionImageLayout(idMap.getVkImage().image,
+                                   vk::ImageLayout::eTransferSrcOptimal,
+                                   vk::ImageLayout::eColorAttachmentOptimal,
+                                   vk::PipelineStageFlagBits2::eCopy,
+                                   vk::AccessFlagBits2::eTransferRead,
+                                   vk::PipelineStageFlagBits2::eColorAttachmentOutput,
+                                   vk::AccessFlagBits2::eColorAttachmentWrite,
+                                   vk::ImageAspectFlagBits::eColor,
+                                   cmdBuf);
+
+    //  make the copies visible to the host once the frame's fence is signaled
+    vk::MemoryBarrier2 hostBarrier{
+        .srcStageMask = vk::PipelineStageFlagBits2::eCopy,
+        .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+        .dstStageMask = vk::PipelineStageFlagBits2::eHost,
+        .dstAccessMask = vk::AccessFlagBits2::eHostRead
+    };
+    cmdBuf.pipelineBarrier2(vk::DependencyInfo{.memoryBarrierCount = 1, .pMemoryBarriers = &hostBarrier});
+}
+
+void ObjectPicker::reserve(FrameReadback& frame, vk::DeviceSize size) {
+    if (size <= frame.capacity)
+        return;
+
+    if (frame.capacity > 0)
+        VkUtils::destroyBufferVMA(std::move(frame.buffer));
+
+    //  a rectangle over the whole window is rare, hover and click queries fit into the first allocation
+    frame.capacity = std::max<vk::DeviceSize>(size, 4096);
+    frame.buffer = VkUtils::createBufferVMA(frame.capacity, vk::BufferUsageFlagBits::eTransferDst,
+                                           VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT);
+}
+
+void ObjectPicker::resolve(FrameReadback& frame) {
+    if (frame.queries.empty())
+        return;
+
+    VkUtils::invalidateBuffer(frame.buffer);
+    const auto* ids = static_cast<const uint32_t*>(frame.buffer.allocationInfo.pMappedData);
+
+    std::vector<uint32_t> objects{};
+    for (auto& query : frame.queries) {
+        //  the ID map stores packed mesh handles, 0 where nothing was drawn
+        const uint32_t* first = ids + query.bufferOffset / sizeof(uint32_t);
+        const uint32_t* last = first + static_cast<size_t>(query.extent.width) * query.extent.height;
+
+        objects.assign(first, last);
+        std::ranges::sort(objects);
+        auto duplicates = std::ranges::unique(objects);
+        objects.erase(duplicates.begin(), duplicates.end());
+
+        std::vector<ResourceHandle> handles{};
+        for (uint32_t object : objects) {
+            ResourceHandle handle{object};
+            if (handle.isValid())
+                handles.emplace_back(handle);
+        }
+
+        latency_ = latency_ * 0.95 + static_cast<double>(frameCounter_ - query.queuedFrame) * 0.05;
+
+        if (query.isHover)
+            hoveredObject_ = handles.empty() ? ResourceHandle{} : handles.front();
+
+        if (query.callback)
+            query.callback(handles);
+    }
+
+    frame.queries.clear();
+}
@@ -0,0 +1,105 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <functional>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <vulkan/vulkan_raii.hpp>
+
+#include "managers/managedResource.h"
+#include "vk/vkUtils.h"
+
+class Texture;
+
+/**
+ * @brief reads object IDs back from the ID map without stalling, results arrive once the frame that copied them is done
+ *
+ * Queries are recorded into the frame's own command buffer right after the scene pass, the copies land in a
+ * readback buffer of the frame context. When the context's fence was waited on again (framesInFlight frames later)
+ * the IDs are read and the callbacks are invoked on the main thread. Nothing ever waits for the GPU.
+ */
+class ObjectPicker {
+public:
+    //  unique valid handles found in the queried pixels, handles of meshes freed since may not resolve anymore
+    using Callback = std::function<void(std::span<const ResourceHandle> objects)>;
+
+    explicit ObjectPicker(uint32_t frameCount);
+    ~ObjectPicker();
+
+    ObjectPicker(const ObjectPicker&) = delete;
+    ObjectPicker& operator=(const ObjectPicker&) = delete;
+
+    /**
+     * @brief queries the object under a pixel, recorded with the next frame
+     */
+    void pick(glm::ivec2 position, Callback callback);
+
+    /**
+     * @brief queries all objects inside a rectangle given by two opposite corners, both inclusive
+     */
+    void pickRect(glm::ivec2 corner0, glm::ivec2 corner1, Callback callback);
+
+    /**
+     * @brief sets the pixel queried every frame, nullopt stops hover queries
+     */
+    void setHoverPosition(std::optional<glm::ivec2> position) { hoverPosition_ = position; }
+
+    //  whether the next recorded frame reads the ID map, it doesn't have to be stored otherwise
+    [[nodiscard]] bool hasPendingQueries() const { return !pendingQueries_.empty() || hoverPosition_.has_value(); }
+
+    //  result of the latest finished hover query
+    [[nodiscard]] ResourceHandle getHoveredObject() const { return hoveredObject_; }
+
+    /**
+     * @brief delivers the results of the frame context, its fence has to be waited on
+     */
+    void beginFrame(uint32_t frameIndex);
+
+    /**
+     * @brief delivers the results of all frame contexts, the device has to be idle
+     */
+    void flush();
+
+    /**
+     * @brief records the queued queries, outside of rendering and with the ID map in color attachment layout
+     */
+    void record(vk::raii::CommandBuffer& cmdBuf, uint32_t frameIndex, const Texture& idMap, vk::Extent2D extent);
+
+    //  smoothed number of frames between queueing a query and getting its result
+    [[nodiscard]] double getLatency() const { return latency_; }
+
+private:
+    struct Query {
+        vk::Offset2D offset{};
+        vk::Extent2D extent{};
+        Callback callback{};
+
+        //  set when recorded, where the pixels are in the frame's readback buffer
+        vk::DeviceSize bufferOffset{0};
+        uint64_t queuedFrame{0};
+        bool isHover{false};
+    };
+
+    struct FrameReadback {
+        VkUtils::BufferAlloc buffer{};
+        vk::DeviceSize capacity{0};
+        std::vector<Query> queries{};
+    };
+
+    void reserve(FrameReadback& frame, vk::DeviceSize size);
+    void resolve(FrameReadback& frame);
+
+    std::vector<FrameReadback> frames_{};
+    std::vector<Query> pendingQueries_{};
+
+    std::optional<glm::ivec2> hoverPosition_{};
+    ResourceHandle hoveredObject_{};
+
+    uint64_t frameCounter_{0};
+    double latency_{0.0};
+};
@@ -0,0 +1,432 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "pixelConversion.h"
+
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define DP_PIXEL_X86 1
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+#else
+#define DP_PIXEL_X86 0
+#endif
+
+//  GCC and Clang only emit vector instructions for functions that ask for them, MSVC always does
+#if defined(__GNUC__) || defined(__clang__)
+#define DP_TARGET(isa) __attribute__((target(isa)))
+#else
+#define DP_TARGET(isa)
+#endif
+
+namespace {
+
+    //====================================================
+    //  scalar reference, same curve as Utils::expand
+
+    float srgbToLinearScalar(float value) {
+        value = std::clamp(value, 0.0f, 1.0f);
+        return value <= 0.04045f ? value / 12.92f : std::pow((value + 0.055f) / 1.055f, 2.4f);
+    }
+
+    float linearToSrgbScalar(float value) {
+        value = std::clamp(value, 0.0f, 1.0f);
+        return value <= 0.0031308f ? value * 12.92f : 1.055f * std::pow(value, 1.0f / 2.4f) - 0.055f;
+    }
+
+    template<float (*convert)(float)>
+    void convertScalar(float* values, size_t count, size_t first, bool hasAlpha) {
+        for (size_t i = first; i < count; ++i) {
+            if (!hasAlpha || i % 4 != 3)
+                values[i] = convert(values[i]);
+        }
+    }
+
+    std::array<uint8_t, 256> createByteTable(float (*convert)(float)) {
+        std::array<uint8_t, 256> table{};
+        for (uint32_t i = 0; i < 256; ++i)
+            table[i] = static_cast<uint8_t>(std::lround(convert(static_cast<float>(i) / 255.0f) * 255.0f));
+        return table;
+    }
+
+    void convertBytes(const std::array<uint8_t, 256>& table, uint8_t* pixels, size_t pixelCount, uint32_t channelCount, bool hasAlpha) {
+        uint32_t colorChannels = hasAlpha ? channelCount - 1 : channelCount;
+
+        for (size_t i = 0; i < pixelCount; ++i) {
+            uint8_t* pixel = pixels + i * channelCount;
+            for (uint32_t c = 0; c < colorChannels; ++c)
+                pixel[c] = table[pixel[c]];
+        }
+    }
+
+#if DP_PIXEL_X86
+
+    //====================================================
+    //  SSE, natural log and exp after Cephes, relative error around 1e-7 on the ranges used here
+
+    __m128 logSse(__m128 x) {
+        const __m128 one = _mm_set1_ps(1.0f);
+
+        //  x = m * 2^e with m in [0.5, 1)
+        __m128i bits = _mm_castps_si128(x);
+        __m128 e = _mm_cvtepi32_ps(_mm_sub_epi32(_mm_srli_epi32(bits, 23), _mm_set1_epi32(126)));
+        __m128 m = _mm_castsi128_ps(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi32(0x007FFFFF)), _mm_set1_epi32(0x3F000000)));
+
+        //  keep m around 1 for the polynomial
+        __m128 isSmall = _mm_cmplt_ps(m, _mm_set1_ps(0.707106781186547524f));
+        e = _mm_sub_ps(e, _mm_and_ps(one, isSmall));
+        m = _mm_add_ps(_mm_sub_ps(m, one), _mm_and_ps(m, isSmall));
+
+        __m128 z = _mm_mul_ps(m, m);
+        __m128 y = _mm_set1_ps(7.0376836292E-2f);
+        y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(-1.1514610310E-1f));
+        y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(1.1676998740E-1f));
+        y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(-1.2420140846E-1f));
+        y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(1.4249322787E-1f));
+        y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(-1.6668057665E-1f));
+        y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(2.0000714765E-1f));
+        y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(-2.4999993993E-1f));
+        y = _mm_add_ps(_mm_mul_ps(y, m), _mm_set1_ps(3.3333331174E-1f));
+        y = _mm_mul_ps(_mm_mul_ps(y, m), z);
+
+        y = _mm_add_ps(y, _mm_mul_ps(e, _mm_set1_ps(-2.12194440e-4f)));
+        y = _mm_sub_ps(y, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+        return _mm_add_ps(_mm_add_ps(m, y), _mm_mul_ps(e, _mm_set1_ps(0.693359375f)));
+    }
+
+    __m128 expSse(__m128 x) {
+        x = _mm_min_ps(_mm_max_ps(x, _mm_set1_ps(-88.3762626647949f)), _mm_set1_ps(88.3762626647949f));
+
+        //  x = n * ln2 + r, floor without SSE4.1
+        __m128 fx = _mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(1.44269504088896341f)), _mm_set1_ps(0.5f));
+        __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(fx));
+        fx = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, fx), _mm_set1_ps(1.0f)));
+
+        x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(0.693359375f)));
+        x = _mm_sub_ps(x, _mm_mul_ps(fx, _mm_set1_ps(-2.12194440e-4f)));
+
+        __m128 z = _mm_mul_ps(x, x);
+        __m128 y = _mm_set1_ps(1.9875691500E-4f);
+        y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.3981999507E-3f));
+        y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(8.3334519073E-3f));
+        y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(4.1665795894E-2f));
+        y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(1.6666665459E-1f));
+        y = _mm_add_ps(_mm_mul_ps(y, x), _mm_set1_ps(5.0000001201E-1f));
+        y = _mm_add_ps(_mm_add_ps(_mm_mul_ps(y, z), x), _mm_set1_ps(1.0f));
+
+        __m128i n = _mm_slli_epi32(_mm_add_epi32(_mm_cvttps_epi32(fx), _mm_set1_epi32(127)), 23);
+        return _mm_mul_ps(y, _mm_castsi128_ps(n));
+    }
+
+    //  x > 0
+    __m128 powSse(__m128 x, float exponent) {
+        return expSse(_mm_mul_ps(logSse(x), _mm_set1_ps(exponent)));
+    }
+
+    __m128 selectSse(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    __m128 srgbToLinearSse(__m128 x) {
+        x = _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+        __m128 linear = _mm_div_ps(x, _mm_set1_ps(12.92f));
+        __m128 curve = powSse(_mm_div_ps(_mm_add_ps(x, _mm_set1_ps(0.055f)), _mm_set1_ps(1.055f)), 2.4f);
+        return selectSse(_mm_cmple_ps(x, _mm_set1_ps(0.04045f)), linear, curve);
+    }
+
+    __m128 linearToSrgbSse(__m128 x) {
+        x = _mm_min_ps(_mm_max_ps(x, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+        __m128 linear = _mm_mul_ps(x, _mm_set1_ps(12.92f));
+        //  the curve is never selected for zero, keep the logarithm finite anyway
+        __m128 curve = powSse(_mm_max_ps(x, _mm_set1_ps(1e-30f)), 1.0f / 2.4f);
+        curve = _mm_sub_ps(_mm_mul_ps(curve, _mm_set1_ps(1.055f)), _mm_set1_ps(0.055f));
+        return selectSse(_mm_cmple_ps(x, _mm_set1_ps(0.0031308f)), linear, curve);
+    }
+
+    template<__m128 (*convert)(__m128)>
+    size_t convertSse(float* values, size_t count, bool hasAlpha) {
+        //  4 lanes hold exactly one RGBA pixel
+        const __m128 keepMask = hasAlpha ? _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1)) : _mm_setzero_ps();
+
+        size_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            __m128 x = _mm_loadu_ps(values + i);
+            _mm_storeu_ps(values + i, selectSse(keepMask, x, convert(x)));
+        }
+        return i;
+    }
+
+    DP_TARGET("ssse3")
+    size_t swapRedBlueSse(uint8_t* pixels, size_t pixelCount) {
+        const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+        size_t i = 0;
+        for (; i + 4 <= pixelCount; i += 4) {
+            auto address = reinterpret_cast<__m128i*>(pixels + i * 4);
+            _mm_storeu_si128(address, _mm_shuffle_epi8(_mm_loadu_si128(address), shuffle));
+        }
+        return i;
+    }
+
+    DP_TARGET("ssse3")
+    size_t expandRGBToRGBASse(const uint8_t* src, uint8_t* dst, size_t pixelCount, bool swapRedBlue, uint8_t alpha) {
+        //  -1 zeroes the byte, alpha is or-ed in afterward
+        const __m128i shuffle = swapRedBlue ? _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1)
+                                            : _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m128i alphaBits = _mm_set1_epi32(static_cast<int>(static_cast<uint32_t>(alpha) << 24));
+
+        //  every load reads 16 bytes but consumes only 12, stop before it would read past the source
+        size_t i = 0;
+        for (; i + 6 <= pixelCount; i += 4) {
+            __m128i rgb = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i * 4), _mm_or_si128(_mm_shuffle_epi8(rgb, shuffle), alphaBits));
+        }
+        return i;
+    }
+
+    //====================================================
+    //  AVX2, same algorithms with 8 lanes
+
+    DP_TARGET("avx2,fma")
+    __m256 logAvx2(__m256 x) {
+        const __m256 one = _mm256_set1_ps(1.0f);
+
+        __m256i bits = _mm256_castps_si256(x);
+        __m256 e = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23), _mm256_set1_epi32(126)));
+        __m256 m = _mm256_castsi256_ps(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007FFFFF)), _mm256_set1_epi32(0x3F000000)));
+
+        __m256 isSmall = _mm256_cmp_ps(m, _mm256_set1_ps(0.707106781186547524f), _CMP_LT_OQ);
+        e = _mm256_sub_ps(e, _mm256_and_ps(one, isSmall));
+        m = _mm256_add_ps(_mm256_sub_ps(m, one), _mm256_and_ps(m, isSmall));
+
+        __m256 z = _mm256_mul_ps(m, m);
+        __m256 y = _mm256_set1_ps(7.0376836292E-2f);
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.1514610310E-1f));
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(1.1676998740E-1f));
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.2420140846E-1f));
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(1.4249322787E-1f));
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-1.6668057665E-1f));
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(2.0000714765E-1f));
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(-2.4999993993E-1f));
+        y = _mm256_fmadd_ps(y, m, _mm256_set1_ps(3.3333331174E-1f));
+        y = _mm256_mul_ps(_mm256_mul_ps(y, m), z);
+
+        y = _mm256_fmadd_ps(e, _mm256_set1_ps(-2.12194440e-4f), y);
+        y = _mm256_fnmadd_ps(z, _mm256_set1_ps(0.5f), y);
+        return _mm256_fmadd_ps(e, _mm256_set1_ps(0.693359375f), _mm256_add_ps(m, y));
+    }
+
+    DP_TARGET("avx2,fma")
+    __m256 expAvx2(__m256 x) {
+        x = _mm256_min_ps(_mm256_max_ps(x, _mm256_set1_ps(-88.3762626647949f)), _mm256_set1_ps(88.3762626647949f));
+
+        __m256 fx = _mm256_floor_ps(_mm256_fmadd_ps(x, _mm256_set1_ps(1.44269504088896341f), _mm256_set1_ps(0.5f)));
+
+        x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(0.693359375f), x);
+        x = _mm256_fnmadd_ps(fx, _mm256_set1_ps(-2.12194440e-4f), x);
+
+        __m256 z = _mm256_mul_ps(x, x);
+        __m256 y = _mm256_set1_ps(1.9875691500E-4f);
+        y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.3981999507E-3f));
+        y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(8.3334519073E-3f));
+        y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(4.1665795894E-2f));
+        y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(1.6666665459E-1f));
+        y = _mm256_fmadd_ps(y, x, _mm256_set1_ps(5.0000001201E-1f));
+        y = _mm256_add_ps(_mm256_fmadd_ps(y, z, x), _mm256_set1_ps(1.0f));
+
+        __m256i n = _mm256_slli_epi32(_mm256_add_epi32(_mm256_cvttps_epi32(fx), _mm256_set1_epi32(127)), 23);
+        return _mm256_mul_ps(y, _mm256_castsi256_ps(n));
+    }
+
+    DP_TARGET("avx2,fma")
+    __m256 powAvx2(__m256 x, float exponent) {
+        return expAvx2(_mm256_mul_ps(logAvx2(x), _mm256_set1_ps(exponent)));
+    }
+
+    DP_TARGET("avx2,fma")
+    __m256 srgbToLinearAvx2(__m256 x) {
+        x = _mm256_min_ps(_mm256_max_ps(x, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+        __m256 linear = _mm256_mul_ps(x, _mm256_set1_ps(1.0f / 12.92f));
+        __m256 curve = powAvx2(_mm256_mul_ps(_mm256_add_ps(x, _mm256_set1_ps(0.055f)), _mm256_set1_ps(1.0f / 1.055f)), 2.4f);
+        return _mm256_blendv_ps(curve, linear, _mm256_cmp_ps(x, _mm256_set1_ps(0.04045f), _CMP_LE_OQ));
+    }
+
+    DP_TARGET("avx2,fma")
+    __m256 linearToSrgbAvx2(__m256 x) {
+        x = _mm256_min_ps(_mm256_max_ps(x, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+        __m256 linear = _mm256_mul_ps(x, _mm256_set1_ps(12.92f));
+        __m256 curve = powAvx2(_mm256_max_ps(x, _mm256_set1_ps(1e-30f)), 1.0f / 2.4f);
+        curve = _mm256_fmsub_ps(curve, _mm256_set1_ps(1.055f), _mm256_set1_ps(0.055f));
+        return _mm256_blendv_ps(curve, linear, _mm256_cmp_ps(x, _mm256_set1_ps(0.0031308f), _CMP_LE_OQ));
+    }
+
+    template<__m256 (*convert)(__m256)>
+    DP_TARGET("avx2,fma")
+    size_t convertAvx2(float* values, size_t count, bool hasAlpha) {
+        //  8 lanes hold two RGBA pixels
+        const __m256 keepMask = hasAlpha ? _mm256_castsi256_ps(_mm256_setr_epi32(0, 0, 0, -1, 0, 0, 0, -1)) : _mm256_setzero_ps();
+
+        size_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            __m256 x = _mm256_loadu_ps(values + i);
+            _mm256_storeu_ps(values + i, _mm256_blendv_ps(convert(x), x, keepMask));
+        }
+        return i;
+    }
+
+    DP_TARGET("avx2")
+    size_t swapRedBlueAvx2(uint8_t* pixels, size_t pixelCount) {
+        const __m256i shuffle = _mm256_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15,
+                                                 2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+
+        size_t i = 0;
+        for (; i + 8 <= pixelCount; i += 8) {
+            auto address = reinterpret_cast<__m256i*>(pixels + i * 4);
+            _mm256_storeu_si256(address, _mm256_shuffle_epi8(_mm256_loadu_si256(address), shuffle));
+        }
+        return i;
+    }
+
+    DP_TARGET("avx2")
+    size_t expandRGBToRGBAAvx2(const uint8_t* src, uint8_t* dst, size_t pixelCount, bool swapRedBlue, uint8_t alpha) {
+        //  the shuffle works within 128-bit lanes, each lane gets its own 4 pixels
+        const __m256i shuffle = swapRedBlue ? _mm256_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1,
+                                                               2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1)
+                                            : _mm256_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1,
+                                                               0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+        const __m256i alphaBits = _mm256_set1_epi32(static_cast<int>(static_cast<uint32_t>(alpha) << 24));
+
+        //  the upper lane reads 16 bytes starting at pixel 4, stop before it would read past the source
+        size_t i = 0;
+        for (; i + 10 <= pixelCount; i += 8) {
+            __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3));
+            __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i * 3 + 12));
+            __m256i rgb = _mm256_inserti128_si256(_mm256_castsi128_si256(low), high, 1);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i * 4), _mm256_or_si256(_mm256_shuffle_epi8(rgb, shuffle), alphaBits));
+        }
+        return i;
+    }
+
+#endif
+}
+
+void PixelConversion::srgbToLinear(uint8_t* pixels, size_t pixelCount, uint32_t channelCount, bool hasAlpha) {
+    static const std::array<uint8_t, 256> table = createByteTable(srgbToLinearScalar);
+    convertBytes(table, pixels, pixelCount, channelCount, hasAlpha);
+}
+
+void PixelConversion::linearToSrgb(uint8_t* pixels, size_t pixelCount, uint32_t channelCount, bool hasAlpha) {
+    static const std::array<uint8_t, 256> table = createByteTable(linearToSrgbScalar);
+    convertBytes(table, pixels, pixelCount, channelCount, hasAlpha);
+}
+
+void PixelConversion::srgbToLinear(std::span<float> values, bool hasAlpha) {
+    size_t done{0};
+#if DP_PIXEL_X86
+    switch (getIsa()) {
+        case Isa::avx2: done = convertAvx2<srgbToLinearAvx2>(values.data(), values.size(), hasAlpha); break;
+        case Isa::sse: done = convertSse<srgbToLinearSse>(values.data(), values.size(), hasAlpha); break;
+        case Isa::scalar: break;
+    }
+#endif
+    convertScalar<srgbToLinearScalar>(values.data(), values.size(), done, hasAlpha);
+}
+
+void PixelConversion::linearToSrgb(std::span<float> values, bool hasAlpha) {
+    size_t done{0};
+#if DP_PIXEL_X86
+    switch (getIsa()) {
+        case Isa::avx2: done = convertAvx2<linearToSrgbAvx2>(values.data(), values.size(), hasAlpha); break;
+        case Isa::sse: done = convertSse<linearToSrgbSse>(values.data(), values.size(), hasAlpha); break;
+        case Isa::scalar: break;
+    }
+#endif
+    convertScalar<linearToSrgbScalar>(values.data(), values.size(), done, hasAlpha);
+}
+
+void PixelConversion::swapRedBlue(uint8_t* pixels, size_t pixelCount) {
+    size_t done{0};
+#if DP_PIXEL_X86
+    switch (getIsa()) {
+        case Isa::avx2: done = swapRedBlueAvx2(pixels, pixelCount); break;
+        case Isa::sse: done = swapRedBlueSse(pixels, pixelCount); break;
+        case Isa::scalar: break;
+    }
+#endif
+    for (size_t i = done; i < pixelCount; ++i)
+        std::swap(pixels[i * 4], pixels[i * 4 + 2]);
+}
+
+void PixelConversion::expandRGBToRGBA(const uint8_t* src, uint8_t* dst, size_t pixelCount, bool swapRedBlue, uint8_t alpha) {
+    size_t done{0};
+#if DP_PIXEL_X86
+    switch (getIsa()) {
+        case Isa::avx2: done = expandRGBToRGBAAvx2(src, dst, pixelCount, swapRedBlue, alpha); break;
+        case Isa::sse: done = expandRGBToRGBASse(src, dst, pixelCount, swapRedBlue, alpha); break;
+        case Isa::scalar: break;
+    }
+#endif
+    for (size_t i = done; i < pixelCount; ++i) {
+        dst[i * 4 + 0] = src[i * 3 + (swapRedBlue ? 2 : 0)];
+        dst[i * 4 + 1] = src[i * 3 + 1];
+        dst[i * 4 + 2] = src[i * 3 + (swapRedBlue ? 0 : 2)];
+        dst[i * 4 + 3] = alpha;
+    }
+}
+
+PixelConversion::Isa PixelConversion::getSupportedIsa() {
+    static const Isa supported = [] {
+#if DP_PIXEL_X86 && (defined(__GNUC__) || defined(__clang__))
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+            return Isa::avx2;
+        if (__builtin_cpu_supports("ssse3"))
+            return Isa::sse;
+#elif DP_PIXEL_X86 && defined(_MSC_VER)
+        int info[4]{};
+        __cpuid(info, 1);
+        bool ssse3 = info[2] & (1 << 9);
+        bool fma = info[2] & (1 << 12);
+        bool osxsave = info[2] & (1 << 27);
+        bool avx = info[2] & (1 << 28);
+
+        __cpuidex(info, 7, 0);
+        bool avx2 = info[1] & (1 << 5);
+
+        //  the OS has to save the upper halves of the ymm registers too
+        bool ymmEnabled = osxsave && (_xgetbv(0) & 6) == 6;
+
+        if (avx && avx2 && fma && ymmEnabled)
+            return Isa::avx2;
+        if (ssse3)
+            return Isa::sse;
+#endif
+        return Isa::scalar;
+    }();
+
+    return supported;
+}
+
+const char* PixelConversion::getIsaName(Isa isa) {
+    switch (isa) {
+        case Isa::scalar: return "scalar";
+        case Isa::sse: return "SSSE3";
+        case Isa::avx2: return "AVX2";
+        default: return "unknown";
+    }
+}
+
+const std::array<float, 256>& PixelConversion::getSrgbToLinearTable() {
+    static const std::array<float, 256> table = [] {
+        std::array<float, 256> values{};
+        for (uint32_t i = 0; i < 256; ++i)
+            values[i] = srgbToLinearScalar(static_cast<float>(i) / 255.0f);
+        return values;
+    }();
+    return table;
+}
@@ -0,0 +1,82 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+/**
+ * @brief pixel format conversions used when loading and cooking textures
+ *
+ * 8-bit sRGB conversions go through lookup tables, float conversions and byte shuffles have SSE and AVX2 paths
+ * picked at runtime by the CPU they run on. Every function also has a scalar path, which is what the vector
+ * paths are compared against.
+ */
+class PixelConversion {
+public:
+    PixelConversion() = delete; //static class
+
+    enum class Isa : uint8_t {
+        scalar,
+        sse,    // SSSE3
+        avx2,   // AVX2 + FMA
+    };
+
+    //====================================================
+    //  8-bit, lookup tables
+
+    /**
+     * @param channelCount bytes per pixel
+     * @param hasAlpha the last channel is alpha and is kept as is
+     */
+    static void srgbToLinear(uint8_t* pixels, size_t pixelCount, uint32_t channelCount, bool hasAlpha);
+    static void linearToSrgb(uint8_t* pixels, size_t pixelCount, uint32_t channelCount, bool hasAlpha);
+
+    [[nodiscard]] static float srgbToLinear(uint8_t value) { return getSrgbToLinearTable()[value]; }
+
+    //====================================================
+    //  float
+
+    /**
+     * @param hasAlpha values are RGBA pixels and every fourth one is kept as is
+     */
+    static void srgbToLinear(std::span<float> values, bool hasAlpha);
+    static void linearToSrgb(std::span<float> values, bool hasAlpha);
+
+    //====================================================
+    //  byte shuffles
+
+    /**
+     * @brief swaps the first and third channel of 4 channel pixels in place, BGRA <-> RGBA
+     */
+    static void swapRedBlue(uint8_t* pixels, size_t pixelCount);
+
+    /**
+     * @brief expands 3 channel pixels to 4 channels, optionally swapping the first and third channel (BGR -> RGBA)
+     */
+    static void expandRGBToRGBA(const uint8_t* src, uint8_t* dst, size_t pixelCount, bool swapRedBlue = false, uint8_t alpha = 255);
+
+    /**
+     * @return the instruction set the conversions run with
+     */
+    static Isa getIsa() { return std::min(getSupportedIsa(), maxIsa_.load(std::memory_order_relaxed)); }
+
+    /**
+     * @brief limits the instruction set, used to compare the vector paths with the scalar ones
+     */
+    static void setMaxIsa(Isa isa) { maxIsa_.store(isa, std::memory_order_relaxed); }
+
+    static Isa getSupportedIsa();
+
+    static const char* getIsaName(Isa isa);
+
+private:
+    static const std::array<float, 256>& getSrgbToLinearTable();
+
+    inline static std::atomic<Isa> maxIsa_{Isa::avx2};
+};
@@ -0,0 +1,302 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#include <imgui/imgui.h>
+
+#include "jobSystem.h"
+
+namespace {
+    void writeEvent(std::ostream& out, bool& isFirst, const char* name, int64_t start, int64_t end, uint32_t pid, uint32_t tid) {
+        out << (isFirst ? "\n" : ",\n");
+        isFirst = false;
+
+        //  complete events, the viewer nests them by time
+        out << R"({"name":")" << name << R"(","ph":"X","ts":)" << static_cast<double>(start) / 1000.0
+            << R"(,"dur":)" << static_cast<double>(end - start) / 1000.0 << R"(,"pid":)" << pid << R"(,"tid":)" << tid << "}";
+    }
+
+    void writeName(std::ostream& out, bool& isFirst, const char* type, const std::string& name, uint32_t pid, uint32_t tid) {
+        out << (isFirst ? "\n" : ",\n");
+        isFirst = false;
+
+        out << R"({"name":")" << type << R"(","ph":"M","pid":)" << pid << R"(,"tid":)" << tid << R"(,"args":{"name":")" << name << R"("}})";
+    }
+}
+
+Profiler::Scope::Scope(const char* name) : name_(name) {
+    if (enabled.load(std::memory_order_relaxed))
+        start_ = getInstance().now();
+}
+
+Profiler::Scope::~Scope() {
+    if (start_ >= 0) {
+        Profiler& profiler = getInstance();
+        profiler.record(name_, start_, profiler.now());
+    }
+}
+
+void Profiler::History::push(float value) {
+    values[offset] = value;
+    offset = (offset + 1) % historyLength;
+    average = average * 0.95f + value * 0.05f;
+}
+
+int64_t Profiler::now() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - epoch_).count();
+}
+
+Profiler::ThreadBuffer& Profiler::getThreadBuffer() {
+    if (threadBuffer_ != nullptr)
+        return *threadBuffer_;
+
+    std::lock_guard lock{threadBuffersMutex_};
+
+    auto& buffer = threadBuffers_.emplace_back(std::make_unique<ThreadBuffer>());
+    buffer->events.resize(threadEventCapacity);
+    buffer->id = static_cast<uint32_t>(threadBuffers_.size() - 1);
+
+    //  the first thread to record anything is the one that initializes the engine
+    uint32_t workerIndex = JobSystem::getThreadIndex();
+    if (workerIndex > 0)
+        buffer->name = "worker " + std::to_string(workerIndex);
+    else
+        buffer->name = buffer->id == 0 ? "main" : "thread " + std::to_string(buffer->id);
+
+    threadBuffer_ = buffer.get();
+    return *threadBuffer_;
+}
+
+void Profiler::record(const char* name, int64_t start, int64_t end) {
+    ThreadBuffer& buffer = getThreadBuffer();
+
+    std::lock_guard lock{buffer.mutex};
+    buffer.events[buffer.writeCount % threadEventCapacity] = Event{.name = name, .start = start, .end = end};
+    buffer.writeCount += 1;
+}
+
+void Profiler::initGpu(const vk::raii::Device& device, float timestampPeriod, uint32_t frameCount) {
+    queryPool_ = vk::raii::QueryPool(device, vk::QueryPoolCreateInfo{
+        .queryType = vk::QueryType::eTimestamp,
+        .queryCount = 2 * maxGpuZones * frameCount
+    });
+
+    timestampPeriod_ = timestampPeriod;
+    gpuFrames_.resize(frameCount);
+    gpuEvents_.resize(gpuEventCapacity);
+}
+
+void Profiler::releaseGpu() {
+    queryPool_ = nullptr;
+    gpuFrames_.clear();
+}
+
+void Profiler::beginGpuFrame(vk::raii::CommandBuffer& cmdBuf, uint32_t frameIndex) {
+    if (!*queryPool_)
+        return;
+
+    GpuFrame& frame = gpuFrames_[frameIndex];
+    frame.recordTime = now();
+    frame.zoneCount = 0;
+    frame.isRecording = enabled.load(std::memory_order_relaxed);
+
+    if (frame.isRecording)
+        cmdBuf.resetQueryPool(queryPool_, 2 * maxGpuZones * frameIndex, 2 * maxGpuZones);
+}
+
+uint32_t Profiler::beginGpuZone(vk::raii::CommandBuffer& cmdBuf, uint32_t frameIndex, const char* name) {
+    if (!*queryPool_)
+        return maxGpuZones;
+
+    GpuFrame& frame = gpuFrames_[frameIndex];
+    if (!frame.isRecording || frame.zoneCount == maxGpuZones)
+        return maxGpuZones;
+
+    uint32_t zone = frame.zoneCount++;
+    frame.names[zone] = name;
+    cmdBuf.writeTimestamp2(vk::PipelineStageFlagBits2::eTopOfPipe, queryPool_, 2 * (maxGpuZones * frameIndex + zone));
+
+    return zone;
+}
+
+void Profiler::endGpuZone(vk::raii::CommandBuffer& cmdBuf, uint32_t frameIndex, uint32_t zone) {
+    if (!*queryPool_ || zone >= gpuFrames_[frameIndex].zoneCount)
+        return;
+
+    cmdBuf.writeTimestamp2(vk::PipelineStageFlagBits2::eBottomOfPipe, queryPool_, 2 * (maxGpuZones * frameIndex + zone) + 1);
+}
+
+void Profiler::resolveGpuFrame(uint32_t frameIndex) {
+    if (!*queryPool_)
+        return;
+
+    GpuFrame& frame = gpuFrames_[frameIndex];
+    if (!frame.isRecording || frame.zoneCount == 0)
+        return;
+
+    frame.isRecording = false;
+
+    //  the frame's fence was waited on, the results are available without waiting
+    const uint32_t queryCount = 2 * frame.zoneCount;
+    auto [result, timestamps] = queryPool_.getResults<uint64_t>(2 * maxGpuZones * frameIndex, queryCount, queryCount * sizeof(uint64_t), sizeof(uint64_t),
+                                                                vk::QueryResultFlagBits::e64);
+    if (result != vk::Result::eSuccess)
+        return;
+
+    uint64_t firstTimestamp = timestamps[0];
+    for (uint32_t zone = 0; zone < frame.zoneCount; ++zone)
+        firstTimestamp = std::min(firstTimestamp, timestamps[2 * zone]);
+
+    auto toTime = [&](uint64_t timestamp) {
+        return frame.recordTime + static_cast<int64_t>(static_cast<double>(timestamp - firstTimestamp) * timestampPeriod_);
+    };
+
+    std::map<std::string_view, float> zoneTimes{};
+    for (uint32_t zone = 0; zone < frame.zoneCount; ++zone) {
+        Event event{.name = frame.names[zone], .start = toTime(timestamps[2 * zone]), .end = toTime(timestamps[2 * zone + 1])};
+
+        gpuEvents_[gpuWriteCount_ % gpuEventCapacity] = event;
+        gpuWriteCount_ += 1;
+
+        zoneTimes[event.name] += static_cast<float>(event.end - event.start) * 1e-6f;
+    }
+
+    for (const auto& [name, time] : zoneTimes)
+        gpuHistories_[name];
+    for (auto& [name, history] : gpuHistories_) {
+        auto zoneTime = zoneTimes.find(name);
+        history.push(zoneTime != zoneTimes.end() ? zoneTime->second : 0.0f);
+    }
+}
+
+void Profiler::endFrame() {
+    ThreadBuffer& buffer = getThreadBuffer();
+
+    std::map<std::string_view, float> scopeTimes{};
+    {
+        std::lock_guard lock{buffer.mutex};
+
+        //  scopes overwritten since the last frame are lost for the histograms
+        uint64_t first = std::max(buffer.frameCount, buffer.writeCount > threadEventCapacity ? buffer.writeCount - threadEventCapacity : 0);
+        for (uint64_t i = first; i < buffer.writeCount; ++i) {
+            const Event& event = buffer.events[i % threadEventCapacity];
+            scopeTimes[event.name] += static_cast<float>(event.end - event.start) * 1e-6f;
+        }
+        buffer.frameCount = buffer.writeCount;
+    }
+
+    //  every scope seen so far gets a value each frame, so the histograms of all scopes line up
+    for (const auto& [name, time] : scopeTimes)
+        cpuHistories_[name];
+    for (auto& [name, history] : cpuHistories_) {
+        auto scopeTime = scopeTimes.find(name);
+        history.push(scopeTime != scopeTimes.end() ? scopeTime->second : 0.0f);
+    }
+}
+
+void Profiler::drawHistories(const std::map<std::string_view, History>& histories) {
+    for (const auto& [name, history] : histories) {
+        char overlay[32];
+        std::snprintf(overlay, sizeof(overlay), "%.3f ms", history.average);
+
+        //  names are string literals, the views end at their terminators
+        ImGui::PlotHistogram(name.data(), history.values.data(), static_cast<int>(historyLength), static_cast<int>(history.offset), overlay,
+                             0.0f, FLT_MAX, ImVec2(0.0f, 40.0f));
+    }
+}
+
+bool Profiler::drawGUI() {
+    if (ImGui::CollapsingHeader("Profiler")) {
+        ImGui::Indent();
+        bool isEnabled = enabled.load(std::memory_order_relaxed);
+        if (ImGui::Checkbox("Enabled", &isEnabled))
+            enabled.store(isEnabled, std::memory_order_relaxed);
+
+        ImGui::SeparatorText("GPU passes");
+        if (!*queryPool_)
+            ImGui::TextUnformatted("Timestamps not supported");
+        drawHistories(gpuHistories_);
+
+        ImGui::SeparatorText("CPU scopes (main thread)");
+        drawHistories(cpuHistories_);
+
+        if (ImGui::Button("Export Chrome trace"))
+            exportStatus_ = exportChromeTrace(traceExportPath) ? "Written to " + traceExportPath : "Failed to write " + traceExportPath;
+        if (!exportStatus_.empty()) {
+            ImGui::SameLine();
+            ImGui::TextUnformatted(exportStatus_.c_str());
+        }
+        ImGui::Unindent();
+    }
+
+    return false;
+}
+
+bool Profiler::exportChromeTrace(const std::string& path) const {
+    std::filesystem::path filePath{path};
+
+    std::error_code ec;
+    if (filePath.has_parent_path())
+        std::filesystem::create_directories(filePath.parent_path(), ec);
+
+    std::ofstream out(filePath, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "WARNING: failed to create trace " << path << std::endl;
+        return false;
+    }
+
+    out << std::fixed << std::setprecision(3);
+    out << R"({"displayTimeUnit":"ms","traceEvents":[)";
+
+    bool isFirst{true};
+    writeName(out, isFirst, "process_name", "CPU", 0, 0);
+    writeName(out, isFirst, "process_name", "GPU", 1, 0);
+    writeName(out, isFirst, "thread_name", "graphics queue", 1, 0);
+
+    {
+        std::lock_guard buffersLock{threadBuffersMutex_};
+
+        std::vector<Event> events{};
+        for (const auto& buffer : threadBuffers_) {
+            {
+                //  copy the events out so that the thread isn't blocked while they are written
+                std::lock_guard lock{buffer->mutex};
+                uint64_t first = buffer->writeCount > threadEventCapacity ? buffer->writeCount - threadEventCapacity : 0;
+
+                events.clear();
+                for (uint64_t i = first; i < buffer->writeCount; ++i)
+                    events.emplace_back(buffer->events[i % threadEventCapacity]);
+            }
+
+            writeName(out, isFirst, "thread_name", buffer->name, 0, buffer->id);
+            for (const auto& event : events)
+                writeEvent(out, isFirst, event.name, event.start, event.end, 0, buffer->id);
+        }
+    }
+
+    uint64_t firstGpuEvent = gpuWriteCount_ > gpuEventCapacity ? gpuWriteCount_ - gpuEventCapacity : 0;
+    for (uint64_t i = firstGpuEvent; i < gpuWriteCount_; ++i) {
+        const Event& event = gpuEvents_[i % gpuEventCapacity];
+        writeEvent(out, isFirst, event.name, event.start, event.end, 1, 0);
+    }
+
+    out << "\n]}\n";
+    out.close();
+
+    if (!out) {
+        std::cerr << "WARNING: failed to write trace " << path << std::endl;
+        return false;
+    }
+
+    return true;
+}
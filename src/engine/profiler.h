@@ -0,0 +1,173 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+/**
+ * @brief collects CPU scopes from every thread and GPU timestamps of render passes, shows them and exports Chrome traces
+ *
+ * Every thread writes its scopes into its own ring buffer, which is only locked by the owner and by the rare
+ * readers, so a scope costs two clock reads and an uncontended lock. GPU zones are timestamp pairs written into
+ * the frame context's part of a query pool and read once its fence was waited on. The GPU track of a trace is
+ * aligned to the CPU time the frame was recorded at, durations and the order within a frame are exact.
+ * Scope and zone names are not copied, they have to be string literals.
+ */
+class Profiler {
+public:
+    static Profiler& getInstance(){
+        //  magic static, safe to call first from any thread
+        static Profiler* instance = new Profiler();
+        return *instance;
+    }
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    /**
+     * @brief measures the CPU time until it goes out of scope
+     */
+    class Scope {
+    public:
+        explicit Scope(const char* name);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        const char* name_{nullptr};
+        int64_t start_{-1};
+    };
+
+    //  scopes and zones started while disabled aren't recorded, toggled by the GUI while other threads record
+    inline static std::atomic<bool> enabled{true};
+
+    //  frames shown in the histograms
+    static constexpr uint32_t historyLength{240};
+
+    //  per thread, the oldest scopes are overwritten
+    static constexpr uint32_t threadEventCapacity{16384};
+    static constexpr uint32_t gpuEventCapacity{16384};
+    static constexpr uint32_t maxGpuZones{16};
+
+    inline static const std::string traceExportPath{"profile.json"};
+
+    /**
+     * @brief creates the timestamp query pool, without it GPU zones are ignored
+     */
+    void initGpu(const vk::raii::Device& device, float timestampPeriod, uint32_t frameCount);
+    void releaseGpu();
+
+    /**
+     * @brief resets the frame context's zones, recorded before any of them
+     */
+    void beginGpuFrame(vk::raii::CommandBuffer& cmdBuf, uint32_t frameIndex);
+
+    /**
+     * @return zone to pass to endGpuZone, ignored there if the zone isn't recorded
+     */
+    uint32_t beginGpuZone(vk::raii::CommandBuffer& cmdBuf, uint32_t frameIndex, const char* name);
+    void endGpuZone(vk::raii::CommandBuffer& cmdBuf, uint32_t frameIndex, uint32_t zone);
+
+    /**
+     * @brief reads the frame context's zones, its fence has to be waited on
+     */
+    void resolveGpuFrame(uint32_t frameIndex);
+
+    /**
+     * @brief adds the calling thread's scopes since the last call to the histograms, called by the main loop once per frame
+     */
+    void endFrame();
+
+    bool drawGUI();
+
+    /**
+     * @brief writes the buffered scopes of all threads and the GPU zones as a Chrome trace (chrome://tracing, Perfetto)
+     * @return false if the file couldn't be written
+     */
+    bool exportChromeTrace(const std::string& path) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Profiler() = default;
+
+    struct Event {
+        const char* name{nullptr};
+
+        //  nanoseconds since the profiler was created
+        int64_t start{0};
+        int64_t end{0};
+    };
+
+    struct ThreadBuffer {
+        std::mutex mutex;
+        std::vector<Event> events{};
+        uint64_t writeCount{0};
+
+        //  events up to here went into the histograms already
+        uint64_t frameCount{0};
+
+        std::string name{};
+        uint32_t id{0};
+    };
+
+    struct GpuFrame {
+        //  CPU time the frame was recorded at, the GPU timestamps are placed relative to it
+        int64_t recordTime{0};
+        std::array<const char*, maxGpuZones> names{};
+        uint32_t zoneCount{0};
+
+        //  the frame's queries were reset, false while the profiler is disabled
+        bool isRecording{false};
+    };
+
+    struct History {
+        std::array<float, historyLength> values{};
+        uint32_t offset{0};
+        float average{0.0f};
+
+        void push(float value);
+    };
+
+    [[nodiscard]] int64_t now() const;
+
+    ThreadBuffer& getThreadBuffer();
+    void record(const char* name, int64_t start, int64_t end);
+
+    static void drawHistories(const std::map<std::string_view, History>& histories);
+
+    inline static thread_local ThreadBuffer* threadBuffer_{nullptr};
+
+    const Clock::time_point epoch_{Clock::now()};
+
+    //  buffers of threads that exited are kept, their scopes are still exported
+    mutable std::mutex threadBuffersMutex_;
+    std::vector<std::unique_ptr<ThreadBuffer>> threadBuffers_{};
+
+    vk::raii::QueryPool queryPool_{nullptr};
+    double timestampPeriod_{0.0};
+    std::vector<GpuFrame> gpuFrames_{};
+
+    //  only touched by the main thread
+    std::vector<Event> gpuEvents_{};
+    uint64_t gpuWriteCount_{0};
+
+    std::map<std::string_view, History> cpuHistories_{};
+    std::map<std::string_view, History> gpuHistories_{};
+
+    std::string exportStatus_{};
+};
@@ -0,0 +1,101 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "rangeAllocator.h"
+
+#include <stdexcept>
+
+RangeAllocator::RangeAllocator(uint32_t capacity) : capacity_(capacity) {
+    if (capacity_ != 0)
+        insertFreeRange(0, capacity_);
+}
+
+std::optional<uint32_t> RangeAllocator::allocate(uint32_t size) {
+    if (size == 0)
+        return std::nullopt;
+
+    auto bestFit = freeBySize_.lower_bound(size);
+    if (bestFit == freeBySize_.end())
+        return std::nullopt;
+
+    uint32_t offset = bestFit->second;
+    uint32_t rangeSize = bestFit->first;
+
+    eraseFreeRange(freeByOffset_.find(offset));
+
+    //  the rest of the range stays free
+    if (rangeSize > size)
+        insertFreeRange(offset + size, rangeSize - size);
+
+    usedSize_ += size;
+    allocationCount_ += 1;
+    return offset;
+}
+
+void RangeAllocator::free(uint32_t offset, uint32_t size) {
+    if (size == 0)
+        return;
+
+    if (offset + size > capacity_ || size > usedSize_)
+        throw std::runtime_error("ERROR: Freeing a range that wasn't allocated!");
+
+    usedSize_ -= size;
+    allocationCount_ -= 1;
+
+    //  merge with the free range right after
+    auto next = freeByOffset_.lower_bound(offset);
+    if (next != freeByOffset_.end() && next->first == offset + size) {
+        size += next->second;
+        next = std::next(next);
+        eraseFreeRange(std::prev(next));
+    }
+
+    //  and with the free range right before
+    if (next != freeByOffset_.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            eraseFreeRange(previous);
+        }
+    }
+
+    insertFreeRange(offset, size);
+}
+
+RangeAllocator::Stats RangeAllocator::getStats() const {
+    return Stats{
+        .capacity = capacity_,
+        .usedSize = usedSize_,
+        .allocationCount = allocationCount_,
+        .freeRangeCount = static_cast<uint32_t>(freeByOffset_.size()),
+        .largestFreeRange = freeBySize_.empty() ? 0 : freeBySize_.rbegin()->first
+    };
+}
+
+float RangeAllocator::getFragmentation() const {
+    uint32_t freeSize = capacity_ - usedSize_;
+    if (freeSize == 0)
+        return 0.0f;
+
+    return 1.0f - static_cast<float>(freeBySize_.rbegin()->first) / static_cast<float>(freeSize);
+}
+
+void RangeAllocator::insertFreeRange(uint32_t offset, uint32_t size) {
+    freeByOffset_.emplace(offset, size);
+    freeBySize_.emplace(size, offset);
+}
+
+void RangeAllocator::eraseFreeRange(std::map<uint32_t, uint32_t>::iterator range) {
+    //  several ranges can have the same size, find the one with this offset
+    auto [first, last] = freeBySize_.equal_range(range->second);
+    for (auto it = first; it != last; ++it) {
+        if (it->second == range->first) {
+            freeBySize_.erase(it);
+            break;
+        }
+    }
+
+    freeByOffset_.erase(range);
+}
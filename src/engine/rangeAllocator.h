@@ -0,0 +1,62 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <cstdint>
+#include <map>
+#include <optional>
+
+/**
+ * @brief hands out ranges of a fixed capacity, the allocation itself lives elsewhere (e.g. in a GPU buffer)
+ *
+ * Best fit allocator over a free list ordered by offset, freed ranges are merged with their free neighbours
+ * right away. Not thread safe.
+ */
+class RangeAllocator {
+public:
+    struct Stats {
+        uint32_t capacity{0};
+        uint32_t usedSize{0};
+        uint32_t allocationCount{0};
+        uint32_t freeRangeCount{0};
+        uint32_t largestFreeRange{0};
+    };
+
+    explicit RangeAllocator(uint32_t capacity);
+
+    /**
+     * @return offset of the range or nothing if no free range is large enough
+     */
+    std::optional<uint32_t> allocate(uint32_t size);
+
+    /**
+     * @param offset and size have to match a previous allocation
+     */
+    void free(uint32_t offset, uint32_t size);
+
+    [[nodiscard]] uint32_t getCapacity() const { return capacity_; }
+    [[nodiscard]] uint32_t getUsedSize() const { return usedSize_; }
+    [[nodiscard]] bool isEmpty() const { return usedSize_ == 0; }
+
+    [[nodiscard]] Stats getStats() const;
+
+    /**
+     * @return 0 if all free space is one range, approaching 1 the more it is split up
+     */
+    [[nodiscard]] float getFragmentation() const;
+
+private:
+    void insertFreeRange(uint32_t offset, uint32_t size);
+    void eraseFreeRange(std::map<uint32_t, uint32_t>::iterator range);
+
+    uint32_t capacity_{0};
+    uint32_t usedSize_{0};
+    uint32_t allocationCount_{0};
+
+    //  offset -> size, neighbours are found here when merging
+    std::map<uint32_t, uint32_t> freeByOffset_{};
+
+    //  size -> offset, the best fit is the first range not smaller than the request
+    std::multimap<uint32_t, uint32_t> freeBySize_{};
+};
@@ -0,0 +1,23 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <glm/glm.hpp>
+
+/**
+ * @brief half line origin + t * direction, t >= 0
+ *
+ * The direction isn't required to be normalized. Transforming a ray keeps t of every point on it, so distances
+ * found in a mesh's object space compare directly with the world space ones.
+ */
+struct Ray {
+    glm::vec3 origin{0.0f};
+    glm::vec3 direction{0.0f, 0.0f, -1.0f};
+
+    [[nodiscard]] glm::vec3 at(float t) const { return origin + direction * t; }
+
+    [[nodiscard]] Ray transform(const glm::mat4& mat) const {
+        return {glm::vec3(mat * glm::vec4(origin, 1.0f)), glm::vec3(mat * glm::vec4(direction, 0.0f))};
+    }
+};
@@ -0,0 +1,171 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "textureStreamer.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include <imgui/imgui.h>
+
+#include "../scene/material.h"
+#include "../scene/texture.h"
+#include "managers/resourceManager.h"
+#include "vk/uploadBatch.h"
+
+TextureStreamer::TextureStreamer(const vk::raii::Device& device, StagingRing& stagingRing) : stagingRing_(stagingRing) {
+    vk::SemaphoreTypeCreateInfo timelineInfo{
+        .semaphoreType = vk::SemaphoreType::eTimeline,
+        .initialValue = 0
+    };
+    timelineSemaphore_ = vk::raii::Semaphore(device, vk::SemaphoreCreateInfo{.pNext = &timelineInfo});
+}
+
+TextureStreamer::~TextureStreamer() {
+    //  decode jobs and upload callbacks reference this object, they have to be finished before it goes away
+    JobSystem::getInstance().wait(decodeCounter_);
+    stagingRing_.waitIdle();
+}
+
+std::shared_ptr<Texture> TextureStreamer::request(std::string_view fileName, bool isSrgb) {
+    if (auto texture = TextureManager::getInstance()->getResource(fileName))
+        return texture;
+
+    auto texture = TextureManager::getInstance()->getOrRegisterResource(fileName, fileName, isSrgb, true);
+
+    //  somebody else could have registered it in the meantime, only schedule textures nobody decoded yet
+    bool expected{false};
+    if (!texture->isResident() && texture->isStreamScheduled_.compare_exchange_strong(expected, true)) {
+        pendingCount_.fetch_add(1, std::memory_order_relaxed);
+
+        JobSystem::getInstance().submit([this, texture] {
+            try {
+                texture->decode();
+
+                if (texture->getUploadSize() == 0)
+                    throw std::runtime_error("ERROR: unsupported image format!");
+            }
+            catch (const std::exception& e) {
+                //  the texture keeps using the placeholder
+                std::cerr << "WARNING: failed to stream texture " << texture->getResourceName() << " (" << e.what() << ")" << std::endl;
+                pendingCount_.fetch_sub(1, std::memory_order_relaxed);
+                return;
+            }
+
+            std::lock_guard<std::mutex> lock(decodedMutex_);
+            decoded_.emplace_back(texture);
+        }, decodeCounter_, JobPriority::background);
+    }
+
+    return texture;
+}
+
+void TextureStreamer::watch(ResourceHandle material) {
+    std::lock_guard<std::mutex> lock(watchMutex_);
+    watchedMaterials_.emplace_back(material);
+}
+
+void TextureStreamer::update() {
+    submitBatch();
+
+    if (residencyChanged_)
+        refreshMaterials();
+}
+
+void TextureStreamer::flush() {
+    JobSystem::getInstance().wait(decodeCounter_);
+
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(decodedMutex_);
+            if (decoded_.empty())
+                break;
+        }
+        submitBatch();
+    }
+    stagingRing_.waitIdle();
+
+    if (residencyChanged_)
+        refreshMaterials();
+}
+
+void TextureStreamer::submitBatch() {
+    //  a batch never takes more than half of the ring so that the next one can be staged while it's in flight
+    const vk::DeviceSize budget = std::min(batchBudget, stagingRing_.getCapacity() / 2);
+
+    std::vector<std::shared_ptr<Texture>> textures{};
+    {
+        std::lock_guard<std::mutex> lock(decodedMutex_);
+        if (decoded_.empty())
+            return;
+
+        //  take textures until the budget is used up, the rest waits for the next frame
+        vk::DeviceSize batchSize{0};
+        auto it = decoded_.begin();
+        while (it != decoded_.end() && (batchSize == 0 || batchSize + (*it)->getUploadSize() <= budget)) {
+            batchSize += (*it)->getUploadSize();
+            ++it;
+        }
+
+        textures.assign(std::make_move_iterator(decoded_.begin()), std::make_move_iterator(it));
+        decoded_.erase(decoded_.begin(), it);
+    }
+
+    UploadBatch batch{stagingRing_, VkUtils::QueueType::transfer};
+
+    //  the transfer queue can't name the fragment stage, the graphics submission waits on the timeline semaphore instead
+    for (const auto& texture : textures) {
+        //  copy offsets have to be a multiple of the texel size and of 4 on transfer only queues
+        auto allocation = batch.allocate(texture->getUploadSize(), 16);
+        texture->recordUpload(*allocation.buffer, allocation.offset, vk::PipelineStageFlagBits2::eNone, batch.getCommandBuffer());
+        uploadedBytes_ += texture->getUploadSize();
+    }
+
+    uint64_t timelineValue = ++submittedValue_;
+    batch.signal(*timelineSemaphore_, timelineValue);
+    batch.onComplete([this, textures = std::move(textures), timelineValue] { retireBatch(textures, timelineValue); });
+    batch.submit();
+
+    batchesInFlight_ += 1;
+}
+
+void TextureStreamer::retireBatch(const std::vector<std::shared_ptr<Texture>>& textures, uint64_t timelineValue) {
+    for (auto& texture : textures) {
+        if (Texture::releaseCpuDataOnUpload)
+            texture->releaseCpuData();
+        texture->markResident();
+    }
+
+    //  the fence of the batch is signaled after its semaphore, batches retire in order
+    completedValue_ = timelineValue;
+
+    uploadedCount_ += textures.size();
+    pendingCount_.fetch_sub(textures.size(), std::memory_order_relaxed);
+    batchesInFlight_ -= 1;
+    residencyChanged_ = true;
+}
+
+void TextureStreamer::refreshMaterials() {
+    residencyChanged_ = false;
+
+    std::lock_guard<std::mutex> lock(watchMutex_);
+
+    //  materials that are gone or have all of their textures resident stop being watched
+    std::erase_if(watchedMaterials_, [](ResourceHandle handle) {
+        Material* material = MaterialManager::getInstance()->resolve(handle);
+        return material == nullptr || material->refreshTextures();
+    });
+}
+
+void TextureStreamer::drawGUI() const {
+    if (ImGui::CollapsingHeader("Texture streaming")) {
+        ImGui::Indent();
+        ImGui::Text("Pending: %u", getPendingCount());
+        ImGui::Text("Uploaded: %u (%.1f MB)", uploadedCount_, static_cast<double>(uploadedBytes_) / (1024.0 * 1024.0));
+        ImGui::Text("Batches in flight: %u", batchesInFlight_);
+        ImGui::Text("Decoded pixels in RAM: %.1f MB", static_cast<double>(Texture::getTotalCpuDataSize()) / (1024.0 * 1024.0));
+        ImGui::Checkbox("Release pixels after upload", &Texture::releaseCpuDataOnUpload);
+        ImGui::Unindent();
+    }
+}
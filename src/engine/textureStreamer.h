@@ -0,0 +1,92 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include "jobSystem.h"
+#include "vk/stagingRing.h"
+#include "managers/managedResource.h"
+
+class Texture;
+
+/**
+ * @brief loads textures from disk in the background
+ *
+ * Requested textures are registered right away but decoded on the job system workers. Decoded textures are
+ * uploaded in batches through the staging ring on the transfer queue, every batch signals the next value of a
+ * timeline semaphore.
+ * Until a texture is resident, materials using it leave the map unset and fall back to their constant values.
+ */
+class TextureStreamer {
+public:
+    TextureStreamer(const vk::raii::Device& device, StagingRing& stagingRing);
+    ~TextureStreamer();
+
+    TextureStreamer(const TextureStreamer&) = delete;
+    TextureStreamer& operator=(const TextureStreamer&) = delete;
+
+    /**
+     * @brief returns the texture registered under fileName or registers it and schedules its decode and upload
+     */
+    std::shared_ptr<Texture> request(std::string_view fileName, bool isSrgb);
+
+    /**
+     * @brief makes the material rebind its textures whenever one of them becomes resident, can be called from any thread
+     */
+    void watch(ResourceHandle material);
+
+    /**
+     * @brief submits the next batch, call once per frame after the staging ring collected finished uploads
+     */
+    void update();
+
+    /**
+     * @brief blocks until every requested texture is resident
+     */
+    void flush();
+
+    [[nodiscard]] const vk::raii::Semaphore& getTimelineSemaphore() const { return timelineSemaphore_; }
+
+    //  timeline value all submissions sampling streamed textures have to wait on
+    [[nodiscard]] uint64_t getCompletedValue() const { return completedValue_; }
+
+    [[nodiscard]] uint32_t getPendingCount() const { return pendingCount_.load(std::memory_order_relaxed); }
+
+    void drawGUI() const;
+
+private:
+    void submitBatch();
+    void retireBatch(const std::vector<std::shared_ptr<Texture>>& textures, uint64_t timelineValue);
+    void refreshMaterials();
+
+    //  upper bound of staging memory used by a single batch, a larger texture goes into a batch on its own
+    static constexpr vk::DeviceSize batchBudget{64 * 1024 * 1024};
+
+    StagingRing& stagingRing_;
+
+    vk::raii::Semaphore timelineSemaphore_{nullptr};
+
+    JobCounter decodeCounter_{};
+
+    std::mutex decodedMutex_;
+    std::vector<std::shared_ptr<Texture>> decoded_{};
+
+    uint32_t batchesInFlight_{0};
+    uint64_t submittedValue_{0};
+    uint64_t completedValue_{0};
+
+    std::mutex watchMutex_;
+    std::vector<ResourceHandle> watchedMaterials_{};
+    bool residencyChanged_{false};
+
+    std::atomic<uint32_t> pendingCount_{0};
+    uint32_t uploadedCount_{0};
+    vk::DeviceSize uploadedBytes_{0};
+};
@@ -0,0 +1,230 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "triangleBvh.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <utility>
+
+void TriangleBvh::build(std::span<const Vertex3D> vertices, std::span<const uint32_t> indices) {
+    nodes_.clear();
+    triangles_.clear();
+    triangleIndices_.clear();
+    texCoords_.clear();
+
+    const auto triangleCount = static_cast<uint32_t>(indices.size() / 3);
+    if (triangleCount == 0)
+        return;
+
+    std::vector<Aabb> triangleBounds(triangleCount);
+    std::vector<glm::vec3> centroids(triangleCount);
+    texCoords_.resize(static_cast<size_t>(triangleCount) * 3);
+
+    for (uint32_t i = 0; i < triangleCount; ++i) {
+        for (uint32_t j = 0; j < 3; ++j) {
+            const Vertex3D& vertex = vertices[indices[3 * i + j]];
+            triangleBounds[i].expand(vertex.position);
+            texCoords_[3 * i + j] = vertex.texCoord;
+        }
+        centroids[i] = triangleBounds[i].getCenter();
+    }
+
+    std::vector<uint32_t> order(triangleCount);
+    std::iota(order.begin(), order.end(), 0u);
+
+    //  a binary tree with at least one triangle per leaf never has more nodes
+    nodes_.reserve(2 * static_cast<size_t>(triangleCount) - 1);
+    nodes_.emplace_back(Node{.first = 0, .count = triangleCount});
+
+    struct Bin {
+        Aabb bounds{};
+        uint32_t count{0};
+    };
+
+    //  node and its depth
+    std::vector<std::pair<uint32_t, uint32_t>> stack{{0, 0}};
+    while (!stack.empty()) {
+        auto [nodeIndex, depth] = stack.back();
+        stack.pop_back();
+
+        Node& node = nodes_[nodeIndex];
+
+        Aabb centroidBounds{};
+        for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+            node.bounds = Aabb::merge(node.bounds, triangleBounds[order[i]]);
+            centroidBounds.expand(centroids[order[i]]);
+        }
+
+        if (node.count <= maxLeafSize || depth == maxDepth)
+            continue;
+
+        //  find the cheapest split over the bins of all three axes
+        float bestCost = std::numeric_limits<float>::max();
+        uint32_t bestAxis{0};
+        uint32_t bestBin{0};
+
+        glm::vec3 centroidExtent = centroidBounds.max - centroidBounds.min;
+        for (uint32_t axis = 0; axis < 3; ++axis) {
+            if (centroidExtent[axis] <= 0.0f)
+                continue;
+
+            float binScale = static_cast<float>(binCount) / centroidExtent[axis];
+
+            std::array<Bin, binCount> bins{};
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                auto bin = std::min(binCount - 1, static_cast<uint32_t>((centroids[order[i]][axis] - centroidBounds.min[axis]) * binScale));
+                bins[bin].bounds = Aabb::merge(bins[bin].bounds, triangleBounds[order[i]]);
+                bins[bin].count += 1;
+            }
+
+            //  sweep from the right to get the cost of every right side, then from the left
+            std::array<float, binCount - 1> rightCosts{};
+            Aabb rightBounds{};
+            uint32_t rightCount{0};
+            for (uint32_t i = binCount - 1; i > 0; --i) {
+                rightBounds = Aabb::merge(rightBounds, bins[i].bounds);
+                rightCount += bins[i].count;
+                rightCosts[i - 1] = rightCount > 0 ? static_cast<float>(rightCount) * rightBounds.getSurfaceArea() : 0.0f;
+            }
+
+            Aabb leftBounds{};
+            uint32_t leftCount{0};
+            for (uint32_t i = 0; i < binCount - 1; ++i) {
+                leftBounds = Aabb::merge(leftBounds, bins[i].bounds);
+                leftCount += bins[i].count;
+
+                if (leftCount == 0 || leftCount == node.count)
+                    continue;
+
+                float cost = static_cast<float>(leftCount) * leftBounds.getSurfaceArea() + rightCosts[i];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = i;
+                }
+            }
+        }
+
+        //  keep the leaf if no split is cheaper than intersecting all of its triangles
+        float leafCost = static_cast<float>(node.count) * node.bounds.getSurfaceArea();
+        float splitCost = traversalCost * node.bounds.getSurfaceArea() + bestCost;
+        if (bestCost == std::numeric_limits<float>::max() || splitCost >= leafCost)
+            continue;
+
+        float binScale = static_cast<float>(binCount) / centroidExtent[bestAxis];
+        auto middle = std::partition(order.begin() + node.first, order.begin() + node.first + node.count, [&](uint32_t triangle) {
+            auto bin = std::min(binCount - 1, static_cast<uint32_t>((centroids[triangle][bestAxis] - centroidBounds.min[bestAxis]) * binScale));
+            return bin <= bestBin;
+        });
+
+        auto leftCount = static_cast<uint32_t>(middle - order.begin()) - node.first;
+        auto leftChild = static_cast<uint32_t>(nodes_.size());
+
+        nodes_.emplace_back(Node{.first = node.first, .count = leftCount});
+        nodes_.emplace_back(Node{.first = node.first + leftCount, .count = node.count - leftCount});
+
+        node.first = leftChild;
+        node.count = 0;
+
+        stack.emplace_back(leftChild, depth + 1);
+        stack.emplace_back(leftChild + 1, depth + 1);
+    }
+
+    triangles_.resize(triangleCount);
+    triangleIndices_ = std::move(order);
+
+    for (uint32_t i = 0; i < triangleCount; ++i) {
+        uint32_t triangle = triangleIndices_[i];
+        const glm::vec3& v0 = vertices[indices[3 * triangle]].position;
+        const glm::vec3& v1 = vertices[indices[3 * triangle + 1]].position;
+        const glm::vec3& v2 = vertices[indices[3 * triangle + 2]].position;
+
+        triangles_[i] = Triangle{.vertex = v0, .edge1 = v1 - v0, .edge2 = v2 - v0};
+    }
+}
+
+bool TriangleBvh::intersect(const Ray& ray, float maxDistance, Hit& hit) const {
+    if (nodes_.empty())
+        return false;
+
+    const glm::vec3 invDirection = 1.0f / ray.direction;
+    bool isHit{false};
+
+    //  every level leaves at most one child waiting, the build caps the depth so that this never overflows
+    std::array<uint32_t, maxDepth + 1> stack{};
+    uint32_t stackSize{0};
+
+    if (nodes_.front().bounds.intersectRay(ray.origin, invDirection, maxDistance) == std::numeric_limits<float>::infinity())
+        return false;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+        const Node& node = nodes_[stack[--stackSize]];
+
+        if (node.isLeaf()) {
+            //  Möller-Trumbore
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                const Triangle& triangle = triangles_[i];
+
+                glm::vec3 p = glm::cross(ray.direction, triangle.edge2);
+                float determinant = glm::dot(triangle.edge1, p);
+                if (std::abs(determinant) < 1e-12f)
+                    continue;
+
+                float invDeterminant = 1.0f / determinant;
+                glm::vec3 s = ray.origin - triangle.vertex;
+
+                float u = glm::dot(s, p) * invDeterminant;
+                if (u < 0.0f || u > 1.0f)
+                    continue;
+
+                glm::vec3 q = glm::cross(s, triangle.edge1);
+                float v = glm::dot(ray.direction, q) * invDeterminant;
+                if (v < 0.0f || u + v > 1.0f)
+                    continue;
+
+                float t = glm::dot(triangle.edge2, q) * invDeterminant;
+                if (t < 0.0f || t >= maxDistance)
+                    continue;
+
+                maxDistance = t;
+                hit = Hit{.distance = t, .triangle = triangleIndices_[i], .barycentrics = {u, v}};
+                isHit = true;
+            }
+            continue;
+        }
+
+        //  visit the closer child first, the other one is often culled by the shortened ray
+        uint32_t nearChild = node.first;
+        uint32_t farChild = node.first + 1;
+        float nearDistance = nodes_[nearChild].bounds.intersectRay(ray.origin, invDirection, maxDistance);
+        float farDistance = nodes_[farChild].bounds.intersectRay(ray.origin, invDirection, maxDistance);
+
+        if (farDistance < nearDistance) {
+            std::swap(nearChild, farChild);
+            std::swap(nearDistance, farDistance);
+        }
+
+        if (farDistance != std::numeric_limits<float>::infinity())
+            stack[stackSize++] = farChild;
+        if (nearDistance != std::numeric_limits<float>::infinity())
+            stack[stackSize++] = nearChild;
+    }
+
+    return isHit;
+}
+
+glm::vec2 TriangleBvh::getTexCoord(const Hit& hit) const {
+    const glm::vec2* texCoords = &texCoords_[3 * static_cast<size_t>(hit.triangle)];
+    return texCoords[0] * (1.0f - hit.barycentrics.x - hit.barycentrics.y) + texCoords[1] * hit.barycentrics.x + texCoords[2] * hit.barycentrics.y;
+}
+
+size_t TriangleBvh::getMemorySize() const {
+    return nodes_.capacity() * sizeof(Node) + triangles_.capacity() * sizeof(Triangle) +
+           triangleIndices_.capacity() * sizeof(uint32_t) + texCoords_.capacity() * sizeof(glm::vec2);
+}
@@ -0,0 +1,86 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "aabb.h"
+#include "ray.h"
+#include "../scene/Vertex.h"
+
+/**
+ * @brief static bounding volume hierarchy over the triangles of a mesh for ray casts in object space
+ *
+ * Built top down, every node is split where the surface area heuristic is lowest among binCount bins of the
+ * triangle centroids along each axis. The triangles are stored in leaf order with the data the intersection test
+ * needs, so the tree doesn't depend on the mesh's CPU copies and survives them being released.
+ */
+class TriangleBvh {
+public:
+    struct Hit {
+        float distance{0.0f};
+        uint32_t triangle{0};
+
+        //  weights of the triangle's second and third vertex, the first one gets 1 - x - y
+        glm::vec2 barycentrics{0.0f};
+    };
+
+    void build(std::span<const Vertex3D> vertices, std::span<const uint32_t> indices);
+
+    /**
+     * @brief finds the closest triangle hit by the ray, both sides of a triangle count
+     * @return true if a triangle closer than maxDistance was hit, hit is only written then
+     */
+    bool intersect(const Ray& ray, float maxDistance, Hit& hit) const;
+
+    //  texture coordinate at the hit, interpolated from the triangle's vertices
+    [[nodiscard]] glm::vec2 getTexCoord(const Hit& hit) const;
+
+    [[nodiscard]] bool isEmpty() const { return nodes_.empty(); }
+    [[nodiscard]] const Aabb& getBounds() const { return nodes_.front().bounds; }
+
+    [[nodiscard]] uint32_t getNodeCount() const { return static_cast<uint32_t>(nodes_.size()); }
+    [[nodiscard]] uint32_t getTriangleCount() const { return static_cast<uint32_t>(triangles_.size()); }
+    [[nodiscard]] size_t getMemorySize() const;
+
+    static constexpr uint32_t binCount{16};
+    static constexpr uint32_t maxLeafSize{4};
+
+    //  nodes this deep stay leaves whatever their size, bounds the traversal stack to maxDepth + 1 entries
+    static constexpr uint32_t maxDepth{63};
+
+    //  cost of visiting a node relative to intersecting a triangle
+    static constexpr float traversalCost{1.0f};
+
+private:
+    struct Node {
+        Aabb bounds{};
+
+        //  leaves: first triangle and count, inner nodes: the left child (the right one follows it) and a count of 0
+        uint32_t first{0};
+        uint32_t count{0};
+
+        [[nodiscard]] bool isLeaf() const { return count > 0; }
+    };
+
+    //  first vertex and the edges to the other two, what the intersection test works with
+    struct Triangle {
+        glm::vec3 vertex{};
+        glm::vec3 edge1{};
+        glm::vec3 edge2{};
+    };
+
+    std::vector<Node> nodes_{};
+    std::vector<Triangle> triangles_{};
+
+    //  mesh triangle of every stored triangle
+    std::vector<uint32_t> triangleIndices_{};
+
+    //  three per mesh triangle
+    std::vector<glm::vec2> texCoords_{};
+};
@@ -29,14 +29,15 @@ struct MaterialUBOFormat {
     glm::vec3 specularAlbedo{};
     float ior{};
 
+    //  map handles index the bindless texture array, ~0u (NO_TEXTURE) for maps that aren't set
     glm::vec3 emission{};
-    uint32_t diffuseAlbedoMapHandle{0};
+    uint32_t diffuseAlbedoMapHandle{~0u};
 
     glm::vec3 attenuation;
-    uint32_t specularALbedoMapHandle{0};
+    uint32_t specularALbedoMapHandle{~0u};
 
-    uint32_t shininessMapHandle{0};
-    uint32_t normalMapHandle{0};
+    uint32_t shininessMapHandle{~0u};
+    uint32_t normalMapHandle{~0u};
     float padding;
     float padding2;
 };
@@ -46,4 +47,13 @@ struct PushConstants {
     glm::mat4 normalMat{};
     uint32_t materialId{};
     uint32_t meshId{};
-};
\ No newline at end of file
+};
+
+//  per draw data of indirect draws, std430 layout
+struct DrawDataFormat {
+    glm::mat4 modelMat{};
+    glm::mat4 normalMat{};
+    uint32_t materialId{};
+    uint32_t meshId{};
+    uint32_t padding[2]{};
+};
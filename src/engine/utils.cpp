@@ -3,6 +3,7 @@
 //
 
 #include "utils.h"
+#include <cstdio>
 #include <fstream>
 #include <iostream>
 
@@ -21,3 +22,30 @@ std::vector<char> Utils::readFile(std::string_view filename) {
 
     return fileBuf;
 }
+
+std::string Utils::escapeJson(std::string_view str) {
+    std::string escaped{};
+    escaped.reserve(str.size());
+
+    for (char c : str) {
+        switch (c) {
+            case '"': escaped += "\\\""; break;
+            case '\\': escaped += "\\\\"; break;
+            case '\n': escaped += "\\n"; break;
+            case '\r': escaped += "\\r"; break;
+            case '\t': escaped += "\\t"; break;
+            default:
+                //  the remaining control characters have no short form
+                if (static_cast<unsigned char>(c) < 0x20) {
+                    char code[7];
+                    std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned int>(c));
+                    escaped += code;
+                }
+                else {
+                    escaped += c;
+                }
+        }
+    }
+
+    return escaped;
+}
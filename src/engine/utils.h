@@ -3,6 +3,8 @@
 //
 
 #pragma once
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <vector>
 
@@ -14,6 +16,41 @@ public:
     Utils() = delete; //static class
     static std::vector<char> readFile(std::string_view filename);
 
+    /**
+     * @return the string with quotes, backslashes and control characters escaped for a JSON string literal
+     */
+    static std::string escapeJson(std::string_view str);
+
+    /**
+     * @brief non-cryptographic 64-bit hash used to key on-disk caches
+     * @param data bytes to hash
+     * @param size number of bytes
+     * @param seed initial value, chain calls by passing the previous result
+     */
+    static uint64_t hash64(const void* data, size_t size, uint64_t seed = 0xcbf29ce484222325ull) {
+        constexpr uint64_t prime{0x100000001b3ull};
+        constexpr uint64_t mixPrime{0x9e3779b97f4a7c15ull};
+
+        auto bytes = static_cast<const uint8_t*>(data);
+        uint64_t h = seed ^ (size * mixPrime);
+
+        //  consume whole 8-byte words first, the tail is done bytewise
+        size_t i = 0;
+        for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+            uint64_t word;
+            memcpy(&word, bytes + i, sizeof(word));
+            h = (h ^ (word * mixPrime)) * prime;
+            h ^= h >> 29;
+        }
+        for (; i < size; ++i)
+            h = (h ^ bytes[i]) * prime;
+
+        h ^= h >> 32;
+        h *= mixPrime;
+        h ^= h >> 29;
+        return h;
+    }
+
     static glm::vec3 expand(const glm::vec3& u){
         return {expand(u.x), expand(u.y), expand(u.z)};
     }
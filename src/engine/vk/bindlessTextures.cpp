@@ -0,0 +1,149 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "bindlessTextures.h"
+
+#include <iostream>
+
+#include "../../scene/texture.h"
+
+BindlessTextures::BindlessTextures(const vk::raii::Device& device, uint32_t capacity, uint32_t framesInFlight)
+    : device_(device), capacity_(capacity), framesInFlight_(framesInFlight) {
+    vk::DescriptorSetLayoutBinding textureBinding{
+        .binding = 0,
+        .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+        .descriptorCount = capacity_,
+        .stageFlags = vk::ShaderStageFlagBits::eFragment,
+    };
+
+    vk::DescriptorBindingFlags bindingFlags = vk::DescriptorBindingFlagBits::ePartiallyBound | vk::DescriptorBindingFlagBits::eUpdateAfterBind |
+                                              vk::DescriptorBindingFlagBits::eUpdateUnusedWhilePending;
+
+    vk::DescriptorSetLayoutBindingFlagsCreateInfo bindingFlagsInfo{
+        .bindingCount = 1,
+        .pBindingFlags = &bindingFlags
+    };
+
+    descriptorSetLayout_ = vk::raii::DescriptorSetLayout(device_, vk::DescriptorSetLayoutCreateInfo{
+        .pNext = &bindingFlagsInfo,
+        .flags = vk::DescriptorSetLayoutCreateFlagBits::eUpdateAfterBindPool,
+        .bindingCount = 1,
+        .pBindings = &textureBinding
+    });
+
+    vk::DescriptorPoolSize poolSize{
+        .type = vk::DescriptorType::eCombinedImageSampler,
+        .descriptorCount = capacity_
+    };
+
+    descriptorPool_ = vk::raii::DescriptorPool(device_, vk::DescriptorPoolCreateInfo{
+        .flags = vk::DescriptorPoolCreateFlagBits::eFreeDescriptorSet | vk::DescriptorPoolCreateFlagBits::eUpdateAfterBind,
+        .maxSets = 1,
+        .poolSizeCount = 1,
+        .pPoolSizes = &poolSize
+    });
+
+    vk::DescriptorSetAllocateInfo allocInfo{
+        .descriptorPool = descriptorPool_,
+        .descriptorSetCount = 1,
+        .pSetLayouts = &*descriptorSetLayout_
+    };
+    descriptorSet_ = std::move(device_.allocateDescriptorSets(allocInfo).front());
+
+    slotHandles_.resize(capacity_);
+}
+
+uint32_t BindlessTextures::bind(Texture& texture) {
+    if (!texture.isResident())
+        return invalidIndex;
+
+    std::lock_guard lock(mutex_);
+    if (texture.bindlessSlot_ != invalidIndex)
+        return texture.bindlessSlot_;
+
+    uint32_t slot{invalidIndex};
+    if (!freeSlots_.empty()) {
+        slot = freeSlots_.back();
+        freeSlots_.pop_back();
+    }
+    else if (nextSlot_ < capacity_) {
+        slot = nextSlot_++;
+    }
+    else {
+        std::cerr << "WARNING: texture " << texture.getResourceName() << " doesn't fit into the bindless texture array (" << capacity_ << " textures)" << std::endl;
+        return invalidIndex;
+    }
+
+    writeSlot(slot, texture);
+
+    boundCount_ += 1;
+    slotHandles_[slot] = texture.getHandle();
+    texture.bindlessSlot_ = slot;
+
+    return slot;
+}
+
+void BindlessTextures::release(Texture& texture) {
+    std::lock_guard lock(mutex_);
+
+    //  the fallback itself is going away, the slots pointing at it are no longer sampled
+    if (fallback_ == &texture)
+        fallback_ = nullptr;
+
+    const uint32_t slot = texture.bindlessSlot_;
+    if (slot == invalidIndex)
+        return;
+
+    //  materials in frames still in flight may point at the slot, keep it sampleable until they finish
+    if (fallback_ != nullptr)
+        writeSlot(slot, *fallback_);
+
+    boundCount_ -= 1;
+    slotHandles_[slot] = {};
+    texture.bindlessSlot_ = invalidIndex;
+
+    retiredSlots_.emplace_back(RetiredSlot{.frameIndex = frameIndex_, .slot = slot});
+}
+
+void BindlessTextures::setFallback(const Texture& texture) {
+    std::lock_guard lock(mutex_);
+    fallback_ = &texture;
+}
+
+void BindlessTextures::collect(uint64_t frameIndex) {
+    std::lock_guard lock(mutex_);
+    frameIndex_ = frameIndex;
+
+    std::erase_if(retiredSlots_, [this](const RetiredSlot& retired) {
+        if (frameIndex_ < retired.frameIndex + framesInFlight_)
+            return false;
+
+        freeSlots_.emplace_back(retired.slot);
+        return true;
+    });
+}
+
+void BindlessTextures::writeSlot(uint32_t slot, const Texture& texture) const {
+    vk::DescriptorImageInfo imageInfo{
+        .sampler = texture.getVkSampler(),
+        .imageView = texture.getVkImageView(),
+        .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal
+    };
+
+    vk::WriteDescriptorSet writeDescriptorSet{
+        .dstSet = descriptorSet_,
+        .dstBinding = 0,
+        .dstArrayElement = slot,
+        .descriptorCount = 1,
+        .descriptorType = vk::DescriptorType::eCombinedImageSampler,
+        .pImageInfo = &imageInfo
+    };
+
+    device_.updateDescriptorSets(writeDescriptorSet, {});
+}
+
+uint32_t BindlessTextures::getBoundCount() const {
+    std::lock_guard lock(mutex_);
+    return boundCount_;
+}
@@ -0,0 +1,96 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <mutex>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include "../managers/managedResource.h"
+
+class Texture;
+
+/**
+ * @brief a single descriptor array every material texture is sampled through
+ *
+ * The set is bound once per pass instead of a set per material. Slots are written once a texture is resident,
+ * with update after bind so that textures finishing streaming can be added while frames using the set are still
+ * in flight. Slots no material refers to are never accessed and may stay unwritten (partially bound).
+ *
+ * A released texture's slot is pointed at the fallback texture and only handed out again once the frames in flight
+ * at the time of the release have finished, so no frame samples a texture it wasn't recorded with.
+ */
+class BindlessTextures {
+public:
+    /**
+     * @param framesInFlight frames a released slot waits for before it is reused
+     */
+    BindlessTextures(const vk::raii::Device& device, uint32_t capacity, uint32_t framesInFlight);
+
+    BindlessTextures(const BindlessTextures&) = delete;
+    BindlessTextures& operator=(const BindlessTextures&) = delete;
+
+    /**
+     * @brief writes the texture into its slot, safe to call from worker threads
+     * @return the index shaders sample the texture with, invalidIndex if it isn't resident or the array is full
+     */
+    uint32_t bind(Texture& texture);
+
+    /**
+     * @brief points the texture's slot at the fallback and retires the slot, called when the texture is destroyed
+     */
+    void release(Texture& texture);
+
+    /**
+     * @brief texture written into released slots, has to stay alive until it is released itself
+     */
+    void setFallback(const Texture& texture);
+
+    /**
+     * @brief makes the slots released maxFramesInFlight frames ago reusable, called once the frame's fence was waited on
+     */
+    void collect(uint64_t frameIndex);
+
+    [[nodiscard]] const vk::raii::DescriptorSetLayout& getDescriptorSetLayout() const { return descriptorSetLayout_; }
+    [[nodiscard]] const vk::raii::DescriptorSet& getDescriptorSet() const { return descriptorSet_; }
+
+    [[nodiscard]] uint32_t getCapacity() const { return capacity_; }
+    [[nodiscard]] uint32_t getBoundCount() const;
+
+    //  the texture handle of a material map that isn't set, NO_TEXTURE in the shaders
+    static constexpr uint32_t invalidIndex{~0u};
+
+private:
+    const vk::raii::Device& device_;
+    uint32_t capacity_{0};
+
+    vk::raii::DescriptorSetLayout descriptorSetLayout_{nullptr};
+    vk::raii::DescriptorPool descriptorPool_{nullptr};
+    vk::raii::DescriptorSet descriptorSet_{nullptr};
+
+    void writeSlot(uint32_t slot, const Texture& texture) const;
+
+    //  descriptor writes to the set have to be externally synchronized
+    mutable std::mutex mutex_{};
+
+    //  handle of the texture each slot was written with, slots in use by frames in flight must not be rewritten
+    std::vector<ResourceHandle> slotHandles_{};
+    uint32_t boundCount_{0};
+
+    //  slots below nextSlot_ have been handed out before, freed ones are reused first
+    uint32_t nextSlot_{0};
+    std::vector<uint32_t> freeSlots_{};
+
+    struct RetiredSlot {
+        uint64_t frameIndex{0};
+        uint32_t slot{0};
+    };
+    std::vector<RetiredSlot> retiredSlots_{};
+
+    uint32_t framesInFlight_{0};
+    uint64_t frameIndex_{0};
+
+    const Texture* fallback_{nullptr};
+};
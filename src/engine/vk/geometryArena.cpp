@@ -0,0 +1,135 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "geometryArena.h"
+
+#include <algorithm>
+
+#include <imgui/imgui.h>
+
+GeometryArena::GeometryArena(uint32_t vertexStride, uint32_t blockVertexCount, uint32_t blockIndexCount) :
+    vertexStride_(vertexStride), blockVertexCount_(blockVertexCount), blockIndexCount_(blockIndexCount) {}
+
+GeometryArena::~GeometryArena() {
+    for (auto& block : blocks_) {
+        VkUtils::destroyBufferVMA(std::move(block->vertexBuffer));
+        VkUtils::destroyBufferVMA(std::move(block->indexBuffer));
+    }
+}
+
+GeometryArena::Allocation GeometryArena::allocate(uint32_t vertexCount, uint32_t indexCount, vk::IndexType indexType) {
+    if (vertexCount == 0 || indexCount == 0)
+        return {};
+
+    const uint32_t indexesPerSlot = sizeof(uint32_t) / getIndexSize(indexType);
+    const uint32_t slotCount = (indexCount + indexesPerSlot - 1) / indexesPerSlot;
+
+    //  vertices and indices have to come from the same block, give the vertices back if the indices don't fit
+    auto tryAllocate = [&](uint32_t blockIndex) -> Allocation {
+        Block& block = *blocks_[blockIndex];
+
+        auto firstVertex = block.vertices.allocate(vertexCount);
+        if (!firstVertex)
+            return {};
+
+        auto firstSlot = block.indices.allocate(slotCount);
+        if (!firstSlot) {
+            block.vertices.free(*firstVertex, vertexCount);
+            return {};
+        }
+
+        return Allocation{
+            .block = blockIndex,
+            .firstVertex = *firstVertex,
+            .vertexCount = vertexCount,
+            .firstIndex = *firstSlot * indexesPerSlot,
+            .indexCount = indexCount,
+            .indexType = indexType
+        };
+    };
+
+    for (uint32_t i = 0; i < blocks_.size(); ++i) {
+        if (Allocation allocation = tryAllocate(i); allocation.isValid())
+            return allocation;
+    }
+
+    uint32_t block = createBlock(std::max(vertexCount, blockVertexCount_), std::max(slotCount, blockIndexCount_));
+    return tryAllocate(block);
+}
+
+void GeometryArena::free(const Allocation& allocation) {
+    if (!allocation.isValid())
+        return;
+
+    const uint32_t indexesPerSlot = sizeof(uint32_t) / getIndexSize(allocation.indexType);
+
+    Block& block = *blocks_.at(allocation.block);
+    block.vertices.free(allocation.firstVertex, allocation.vertexCount);
+    block.indices.free(allocation.firstIndex / indexesPerSlot, (allocation.indexCount + indexesPerSlot - 1) / indexesPerSlot);
+}
+
+void GeometryArena::bindBlock(vk::raii::CommandBuffer& cmdBuf, uint32_t block, vk::IndexType indexType) const {
+    cmdBuf.bindVertexBuffers(0, blocks_[block]->vertexBuffer.buffer, {0});
+    cmdBuf.bindIndexBuffer(blocks_[block]->indexBuffer.buffer, 0, indexType);
+}
+
+GeometryArena::Stats GeometryArena::getStats() const {
+    Stats stats{.blockCount = static_cast<uint32_t>(blocks_.size())};
+
+    vk::DeviceSize freeSize{0}, largestFreeSize{0};
+    for (const auto& block : blocks_) {
+        RangeAllocator::Stats vertexStats = block->vertices.getStats();
+        RangeAllocator::Stats indexStats = block->indices.getStats();
+
+        //  both allocators count every mesh once
+        stats.allocationCount += vertexStats.allocationCount;
+
+        stats.capacity += static_cast<vk::DeviceSize>(vertexStats.capacity) * vertexStride_ + static_cast<vk::DeviceSize>(indexStats.capacity) * sizeof(uint32_t);
+        stats.usedSize += static_cast<vk::DeviceSize>(vertexStats.usedSize) * vertexStride_ + static_cast<vk::DeviceSize>(indexStats.usedSize) * sizeof(uint32_t);
+
+        freeSize += static_cast<vk::DeviceSize>(vertexStats.capacity - vertexStats.usedSize) * vertexStride_;
+        largestFreeSize = std::max(largestFreeSize, static_cast<vk::DeviceSize>(vertexStats.largestFreeRange) * vertexStride_);
+    }
+
+    //  the vertex ranges decide whether another mesh fits, indices are far smaller
+    if (freeSize != 0)
+        stats.fragmentation = 1.0f - static_cast<float>(largestFreeSize) / static_cast<float>(freeSize);
+
+    return stats;
+}
+
+void GeometryArena::drawGUI() const {
+    if (ImGui::CollapsingHeader("Geometry arena")) {
+        ImGui::Indent();
+
+        Stats stats = getStats();
+        double capacityMB = static_cast<double>(stats.capacity) / (1024.0 * 1024.0);
+        double usedMB = static_cast<double>(stats.usedSize) / (1024.0 * 1024.0);
+
+        ImGui::Text("Blocks: %u", stats.blockCount);
+        ImGui::Text("Vertex stride: %u B", vertexStride_);
+        ImGui::Text("Meshes: %u", stats.allocationCount);
+        ImGui::Text("Used: %.1f / %.1f MB (%.1f %%)", usedMB, capacityMB, capacityMB > 0.0 ? usedMB / capacityMB * 100.0 : 0.0);
+        ImGui::Text("Fragmentation: %.1f %%", stats.fragmentation * 100.0f);
+
+        for (uint32_t i = 0; i < blocks_.size(); ++i) {
+            const Block& block = *blocks_[i];
+            ImGui::Text("  block %u: %u / %u vertices in %u free ranges, %u / %u index slots", i,
+                        block.vertices.getUsedSize(), block.vertices.getCapacity(), block.vertices.getStats().freeRangeCount,
+                        block.indices.getUsedSize(), block.indices.getCapacity());
+        }
+
+        ImGui::Unindent();
+    }
+}
+
+uint32_t GeometryArena::createBlock(uint32_t vertexCount, uint32_t indexCount) {
+    auto block = std::make_unique<Block>(vertexCount, indexCount);
+
+    block->vertexBuffer = VkUtils::createBufferVMA(static_cast<vk::DeviceSize>(vertexCount) * vertexStride_, vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst);
+    block->indexBuffer = VkUtils::createBufferVMA(static_cast<vk::DeviceSize>(indexCount) * sizeof(uint32_t), vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst);
+
+    blocks_.emplace_back(std::move(block));
+    return static_cast<uint32_t>(blocks_.size() - 1);
+}
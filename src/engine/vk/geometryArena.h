@@ -0,0 +1,109 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <memory>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include "vkUtils.h"
+#include "../rangeAllocator.h"
+
+/**
+ * @brief device local vertex and index buffers all meshes sub-allocate their geometry from
+ *
+ * Memory comes in blocks of one vertex and one index buffer. Blocks never move or grow, so uploads recorded into
+ * them stay valid, and a new block is only created when no existing one has room. A mesh's vertices and indices
+ * always end up in the same block, meshes larger than a block get a block of their own. Index ranges are handed
+ * out in 32 bit slots, a mesh with 16 bit indices packs two into a slot. Not thread safe, meshes are created and
+ * destroyed on the main thread.
+ */
+class GeometryArena {
+public:
+    struct Allocation {
+        uint32_t block{invalidBlock};
+        uint32_t firstVertex{0};
+        uint32_t vertexCount{0};
+
+        //  in units of indexType, as passed to the draw
+        uint32_t firstIndex{0};
+        uint32_t indexCount{0};
+        vk::IndexType indexType{vk::IndexType::eUint32};
+
+        [[nodiscard]] bool isValid() const { return block != invalidBlock; }
+    };
+
+    struct Stats {
+        uint32_t blockCount{0};
+        uint32_t allocationCount{0};
+        vk::DeviceSize capacity{0};
+        vk::DeviceSize usedSize{0};
+        float fragmentation{0.0f};
+    };
+
+    /**
+     * @param vertexStride size of a single vertex in bytes
+     * @param blockVertexCount how many vertices fit into a block
+     * @param blockIndexCount how many 32 bit indices fit into a block
+     */
+    GeometryArena(uint32_t vertexStride, uint32_t blockVertexCount, uint32_t blockIndexCount);
+    ~GeometryArena();
+
+    GeometryArena(const GeometryArena&) = delete;
+    GeometryArena& operator=(const GeometryArena&) = delete;
+
+    Allocation allocate(uint32_t vertexCount, uint32_t indexCount, vk::IndexType indexType = vk::IndexType::eUint32);
+
+    /**
+     * @brief gives the ranges back, the GPU must not be reading them anymore
+     */
+    void free(const Allocation& allocation);
+
+    /**
+     * @brief binds the vertex and index buffer of the block, the index buffer is read as indexType
+     */
+    void bindBlock(vk::raii::CommandBuffer& cmdBuf, uint32_t block, vk::IndexType indexType) const;
+
+    [[nodiscard]] const VkUtils::BufferAlloc& getVertexBuffer(uint32_t block) const { return blocks_[block]->vertexBuffer; }
+    [[nodiscard]] const VkUtils::BufferAlloc& getIndexBuffer(uint32_t block) const { return blocks_[block]->indexBuffer; }
+
+    [[nodiscard]] vk::DeviceSize getVertexOffset(const Allocation& allocation) const { return static_cast<vk::DeviceSize>(allocation.firstVertex) * vertexStride_; }
+    [[nodiscard]] static vk::DeviceSize getIndexOffset(const Allocation& allocation) { return static_cast<vk::DeviceSize>(allocation.firstIndex) * getIndexSize(allocation.indexType); }
+
+    [[nodiscard]] static uint32_t getIndexSize(vk::IndexType indexType) { return indexType == vk::IndexType::eUint16 ? sizeof(uint16_t) : sizeof(uint32_t); }
+
+    /**
+     * @return the narrowest index type that can address vertexCount vertices
+     */
+    [[nodiscard]] static vk::IndexType selectIndexType(uint32_t vertexCount) { return vertexCount <= 65536 ? vk::IndexType::eUint16 : vk::IndexType::eUint32; }
+
+    [[nodiscard]] uint32_t getVertexStride() const { return vertexStride_; }
+    [[nodiscard]] uint32_t getBlockCount() const { return static_cast<uint32_t>(blocks_.size()); }
+
+    [[nodiscard]] Stats getStats() const;
+
+    void drawGUI() const;
+
+    static constexpr uint32_t invalidBlock{~0u};
+
+private:
+    struct Block {
+        Block(uint32_t vertexCount, uint32_t indexCount) : vertices(vertexCount), indices(indexCount) {}
+
+        VkUtils::BufferAlloc vertexBuffer{};
+        VkUtils::BufferAlloc indexBuffer{};
+
+        RangeAllocator vertices;
+        RangeAllocator indices;
+    };
+
+    uint32_t createBlock(uint32_t vertexCount, uint32_t indexCount);
+
+    uint32_t vertexStride_{0};
+    uint32_t blockVertexCount_{0};
+    uint32_t blockIndexCount_{0};
+
+    std::vector<std::unique_ptr<Block>> blocks_{};
+};
@@ -4,12 +4,11 @@
 
 #include "graphicsPipeline.h"
 
-#include "../../scene/Vertex.h"
 
-
-GraphicsPipeline::GraphicsPipeline(std::string_view vShaderPath, std::string_view fShaderPath,
-                                   std::span<const vk::DescriptorSetLayout> descriptorSetLayouts, std::span<const vk::Format> colorAttachmentFormats, bool hasVertexLayout, vk::Format depthFormat) {
-    initShaders(vShaderPath,fShaderPath);
+GraphicsPipeline::GraphicsPipeline(std::span<const uint32_t> vertexCode, std::span<const uint32_t> fragmentCode,
+                                   std::span<const vk::DescriptorSetLayout> descriptorSetLayouts, std::span<const vk::Format> colorAttachmentFormats, bool hasVertexLayout, vk::Format depthFormat,
+                                   VertexFormat vertexFormat, const vk::raii::PipelineCache* pipelineCache) {
+    initShaders(vertexCode,fragmentCode);
 
     vk::PipelineLayoutCreateInfo pipelineLayoutInfo{
         .setLayoutCount = static_cast<uint32_t>(descriptorSetLayouts.size()),
@@ -54,8 +53,17 @@ GraphicsPipeline::GraphicsPipeline(std::string_view vShaderPath, std::string_vie
 
     vk::PipelineVertexInputStateCreateInfo vertexInputInfo{};
 
-    auto bindingDescription = Vertex3D::getBindingDescription();
-    auto attributeDescriptions = Vertex3D::getAttributeDescriptions();
+    bool isPacked = vertexFormat == VertexFormat::packed;
+    auto bindingDescription = isPacked ? PackedVertex3D::getBindingDescription() : Vertex3D::getBindingDescription();
+    auto attributeDescriptions = isPacked ? PackedVertex3D::getAttributeDescriptions() : Vertex3D::getAttributeDescriptions();
+
+    vk::Bool32 isVertexFormatPacked = isPacked ? vk::True : vk::False;
+    vk::SpecializationInfo specializationInfo{
+        .mapEntryCount = 1,
+        .pMapEntries = &vertexFormatSpecialization,
+        .dataSize = sizeof(isVertexFormatPacked),
+        .pData = &isVertexFormatPacked
+    };
 
     if (hasVertexLayout) {
         vertexInputInfo = {
@@ -64,6 +72,8 @@ GraphicsPipeline::GraphicsPipeline(std::string_view vShaderPath, std::string_vie
             .vertexAttributeDescriptionCount = attributeDescriptions.size(),
             .pVertexAttributeDescriptions = attributeDescriptions.data()
         };
+
+        shaderStages_[0].pSpecializationInfo = &specializationInfo;
     }
 
 
@@ -85,5 +95,5 @@ GraphicsPipeline::GraphicsPipeline(std::string_view vShaderPath, std::string_vie
         .basePipelineHandle = nullptr,
         .basePipelineIndex = -1,
     };
-    graphicsPipeline_ = vk::raii::Pipeline(VkUtils::getDevice(), nullptr, pipelineInfo);
+    graphicsPipeline_ = vk::raii::Pipeline(VkUtils::getDevice(), pipelineCache, pipelineInfo);
 }
@@ -8,11 +8,17 @@
 #include "vkUtils.h"
 #include "../utils.h"
 #include "../uboFormat.h"
+#include "../../scene/Vertex.h"
 
 class GraphicsPipeline {
 public:
-    GraphicsPipeline(std::string_view vShaderPath, std::string_view fShaderPath, std::span<const vk::DescriptorSetLayout> descriptorSetLayouts,
-                     std::span<const vk::Format> colorAttachmentFormats, bool hasVertexLayout, vk::Format depthFormat = vk::Format::eUndefined);
+    /**
+     * @param vertexCode SPIR-V of the vertex shader, see ShaderLibrary
+     * @param pipelineCache optional, may be shared by pipelines created on different threads
+     */
+    GraphicsPipeline(std::span<const uint32_t> vertexCode, std::span<const uint32_t> fragmentCode, std::span<const vk::DescriptorSetLayout> descriptorSetLayouts,
+                     std::span<const vk::Format> colorAttachmentFormats, bool hasVertexLayout, vk::Format depthFormat = vk::Format::eUndefined,
+                     VertexFormat vertexFormat = VertexFormat::full, const vk::raii::PipelineCache* pipelineCache = nullptr);
 
     GraphicsPipeline() = default;
 
@@ -28,12 +34,9 @@ private:
     vk::PipelineRenderingCreateInfo pipelineRenderingCreateInfo_{};
     std::array<vk::PipelineShaderStageCreateInfo,2> shaderStages_{};
 
-    void initShaders(std::string_view vShaderPath, std::string_view fShaderPath) {
-        auto vertexShaderCode = Utils::readFile(vShaderPath);
-        auto fragmentShaderCode = Utils::readFile(fShaderPath);
-
-        vShaderModule_ = createShaderModule(vertexShaderCode);
-        fShaderModule_ = createShaderModule(fragmentShaderCode);
+    void initShaders(std::span<const uint32_t> vertexCode, std::span<const uint32_t> fragmentCode) {
+        vShaderModule_ = createShaderModule(vertexCode);
+        fShaderModule_ = createShaderModule(fragmentCode);
 
         shaderStages_ = {
             vk::PipelineShaderStageCreateInfo{// vertex shader comes first
@@ -49,14 +52,21 @@ private:
         };
     }
 
-    static vk::raii::ShaderModule createShaderModule(const std::vector<char> &code) {
+    static vk::raii::ShaderModule createShaderModule(std::span<const uint32_t> code) {
         vk::ShaderModuleCreateInfo createInfo{
-            .codeSize = code.size() * sizeof(char),
-            .pCode = reinterpret_cast<const uint32_t*>(code.data())
+            .codeSize = code.size_bytes(),
+            .pCode = code.data()
         };
         return vk::raii::ShaderModule{VkUtils::getDevice(), createInfo};
     }
 
+    //  vertex shaders read both vertex layouts, constant_id 0 tells them which one is bound
+    static constexpr vk::SpecializationMapEntry vertexFormatSpecialization{
+        .constantID = 0,
+        .offset = 0,
+        .size = sizeof(vk::Bool32)
+    };
+
     static constexpr std::array dynamicStates = {
         vk::DynamicState::eViewport,
         vk::DynamicState::eScissor,
@@ -0,0 +1,117 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "parallelRecorder.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include <imgui/imgui.h>
+
+#include "../jobSystem.h"
+#include "../profiler.h"
+
+ParallelRecorder::ParallelRecorder(const vk::raii::Device& device, uint32_t queueFamilyIndex, uint32_t frameCount) :
+    device_(device), queueFamilyIndex_(queueFamilyIndex) {
+
+    framePools_.resize(frameCount);
+}
+
+void ParallelRecorder::beginFrame(uint32_t frameIndex) {
+    //  resetting the pools resets all of their command buffers at once
+    for (auto& threadPool : framePools_[frameIndex]) {
+        threadPool.pool.reset();
+        threadPool.usedCount = 0;
+    }
+}
+
+void ParallelRecorder::record(vk::raii::CommandBuffer& cmdBuf, uint32_t frameIndex, const vk::CommandBufferInheritanceRenderingInfo& renderingInfo,
+                              uint32_t count, const RecordFunction& recordChunk) {
+    if (count == 0)
+        return;
+
+    JobSystem& jobSystem = JobSystem::getInstance();
+    const uint32_t threadCount = jobSystem.getThreadCount();
+
+    std::vector<ThreadCommandPool>& pools = framePools_[frameIndex];
+    reservePools(pools, threadCount);
+
+    //  a few chunks per thread so that stealing can even out chunks of uneven cost
+    const uint32_t chunkSize = std::max(minChunkSize, (count + threadCount * 4 - 1) / (threadCount * 4));
+    chunkCount_ = (count + chunkSize - 1) / chunkSize;
+
+    std::vector<vk::CommandBuffer> secondaryBuffers(chunkCount_);
+
+    threadStats_.resize(threadCount);
+    threadRecordTimes_.assign(threadCount, 0.0);
+    for (auto& stats : threadStats_)
+        stats.chunkCount = 0;
+
+    const vk::CommandBufferInheritanceInfo inheritanceInfo{
+        .pNext = &renderingInfo
+    };
+
+    //  every thread only touches its own pool and stats, the chunks write to their own slot
+    jobSystem.parallelFor(count, chunkSize, [&](uint32_t begin, uint32_t end) {
+        Profiler::Scope scope{"ParallelRecorder::recordChunk"};
+        auto start = std::chrono::steady_clock::now();
+        const uint32_t threadIndex = JobSystem::getThreadIndex();
+
+        vk::raii::CommandBuffer& secondary = acquireCommandBuffer(pools[threadIndex]);
+        secondary.begin({
+            .flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit | vk::CommandBufferUsageFlagBits::eRenderPassContinue,
+            .pInheritanceInfo = &inheritanceInfo
+        });
+
+        recordChunk(secondary, begin, end);
+
+        secondary.end();
+        secondaryBuffers[begin / chunkSize] = *secondary;
+
+        threadRecordTimes_[threadIndex] += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+        threadStats_[threadIndex].chunkCount += 1;
+    });
+
+    //  executed in chunk order, so the draws end up in the same order as when recorded inline
+    cmdBuf.executeCommands(secondaryBuffers);
+
+    for (uint32_t i = 0; i < threadCount; ++i)
+        threadStats_[i].recordTime = threadStats_[i].recordTime * 0.95 + threadRecordTimes_[i] * 0.05;
+}
+
+bool ParallelRecorder::drawGUI() const {
+    if (ImGui::CollapsingHeader("Parallel recording")) {
+        ImGui::Indent();
+        ImGui::Text("Chunks: %u on %u threads", chunkCount_, static_cast<uint32_t>(threadStats_.size()));
+        for (uint32_t i = 0; i < threadStats_.size(); ++i)
+            ImGui::Text("Thread %u: %.1f us, %u chunks", i, threadStats_[i].recordTime, threadStats_[i].chunkCount);
+        ImGui::Unindent();
+    }
+
+    return false;
+}
+
+void ParallelRecorder::reservePools(std::vector<ThreadCommandPool>& pools, uint32_t threadCount) {
+    //  the job system can be resized, pools are only ever added
+    while (pools.size() < threadCount) {
+        ThreadCommandPool& threadPool = pools.emplace_back();
+        threadPool.pool = vk::raii::CommandPool(device_, vk::CommandPoolCreateInfo{
+            .flags = vk::CommandPoolCreateFlagBits::eTransient,
+            .queueFamilyIndex = queueFamilyIndex_
+        });
+    }
+}
+
+vk::raii::CommandBuffer& ParallelRecorder::acquireCommandBuffer(ThreadCommandPool& pool) {
+    if (pool.usedCount == pool.commandBuffers.size()) {
+        vk::CommandBufferAllocateInfo allocInfo{
+            .commandPool = pool.pool,
+            .level = vk::CommandBufferLevel::eSecondary,
+            .commandBufferCount = 1
+        };
+        pool.commandBuffers.emplace_back(std::move(device_.allocateCommandBuffers(allocInfo).front()));
+    }
+
+    return pool.commandBuffers[pool.usedCount++];
+}
@@ -0,0 +1,74 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <functional>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+/**
+ * @brief records draws on the job system into secondary command buffers and executes them from a primary one
+ *
+ * Every thread of the job system gets its own command pool per frame context, so recording needs no locking.
+ * The pools of a frame context are reset in beginFrame once its fence was waited on, the command buffers are
+ * kept and reused by the following frames.
+ */
+class ParallelRecorder {
+public:
+    using RecordFunction = std::function<void(vk::raii::CommandBuffer& cmdBuf, uint32_t begin, uint32_t end)>;
+
+    //  smoothed per thread times in microseconds, index 0 is the thread that called record
+    struct ThreadStats {
+        double recordTime{0.0};
+        uint32_t chunkCount{0};
+    };
+
+    ParallelRecorder(const vk::raii::Device& device, uint32_t queueFamilyIndex, uint32_t frameCount);
+
+    ParallelRecorder(const ParallelRecorder&) = delete;
+    ParallelRecorder& operator=(const ParallelRecorder&) = delete;
+
+    /**
+     * @brief resets the frame's command pools, the frame's fence has to be waited on
+     */
+    void beginFrame(uint32_t frameIndex);
+
+    /**
+     * @brief splits [0, count) into chunks, records them in parallel and executes them in order from cmdBuf
+     *
+     * cmdBuf has to be inside of dynamic rendering begun with the secondary command buffers contents flag. Nothing
+     * is inherited but the attachments, so recordChunk has to set all state (pipeline, sets, dynamic state) itself.
+     */
+    void record(vk::raii::CommandBuffer& cmdBuf, uint32_t frameIndex, const vk::CommandBufferInheritanceRenderingInfo& renderingInfo,
+                uint32_t count, const RecordFunction& recordChunk);
+
+    [[nodiscard]] const std::vector<ThreadStats>& getThreadStats() const { return threadStats_; }
+    [[nodiscard]] uint32_t getChunkCount() const { return chunkCount_; }
+
+    bool drawGUI() const;
+
+    //  a chunk should be worth the cost of beginning and executing a command buffer
+    static constexpr uint32_t minChunkSize{64};
+
+private:
+    struct ThreadCommandPool {
+        vk::raii::CommandPool pool{nullptr};
+        std::vector<vk::raii::CommandBuffer> commandBuffers{};
+        uint32_t usedCount{0};
+    };
+
+    void reservePools(std::vector<ThreadCommandPool>& pools, uint32_t threadCount);
+    vk::raii::CommandBuffer& acquireCommandBuffer(ThreadCommandPool& pool);
+
+    const vk::raii::Device& device_;
+    uint32_t queueFamilyIndex_{0};
+
+    //  per frame context, per thread
+    std::vector<std::vector<ThreadCommandPool>> framePools_{};
+
+    std::vector<ThreadStats> threadStats_{};
+    std::vector<double> threadRecordTimes_{};
+    uint32_t chunkCount_{0};
+};
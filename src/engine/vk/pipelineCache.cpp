@@ -0,0 +1,101 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "pipelineCache.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#include "../mappedFile.h"
+#include "../utils.h"
+
+PipelineCache::PipelineCache(const vk::raii::Device& device, const vk::PhysicalDeviceProperties& properties, std::string_view path) :
+    path_(path), properties_(properties) {
+
+    MappedFile file{};
+    if (loadFromDisk)
+        file = MappedFile{path_};
+
+    //  the blob is only handed to the driver if it was written by the same device and driver
+    const std::byte* initialData{nullptr};
+    size_t initialSize{0};
+
+    if (file.isOpen() && file.getSize() >= sizeof(Header)) {
+        const auto& header = *reinterpret_cast<const Header*>(file.getData());
+        const Header expected = makeHeader();
+        const std::byte* data = file.getData() + sizeof(Header);
+
+        bool isValid = header.magic == magic && header.version == version && header.vendorId == expected.vendorId &&
+                       header.deviceId == expected.deviceId && header.driverVersion == expected.driverVersion &&
+                       header.pipelineCacheUuid == expected.pipelineCacheUuid && header.dataSize == file.getSize() - sizeof(Header) &&
+                       header.dataHash == Utils::hash64(data, header.dataSize);
+
+        if (isValid) {
+            initialData = data;
+            initialSize = header.dataSize;
+        }
+        else
+            std::cout << "Pipeline cache " << path_ << " is stale or corrupted, starting cold" << std::endl;
+    }
+
+    pipelineCache_ = vk::raii::PipelineCache(device, vk::PipelineCacheCreateInfo{
+        .initialDataSize = initialSize,
+        .pInitialData = initialData
+    });
+
+    isWarm_ = initialSize > 0;
+    loadedSize_ = initialSize;
+}
+
+void PipelineCache::save() const {
+    std::vector<uint8_t> data = pipelineCache_.getData();
+
+    Header header = makeHeader();
+    header.dataSize = data.size();
+    header.dataHash = Utils::hash64(data.data(), data.size());
+
+    //  write into a temporary file first so that an interrupted write never leaves a valid looking cache behind
+    std::filesystem::path finalPath{path_};
+    std::filesystem::path tempPath{finalPath};
+    tempPath += ".tmp";
+
+    std::error_code ec;
+    if (finalPath.has_parent_path())
+        std::filesystem::create_directories(finalPath.parent_path(), ec);
+
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "WARNING: failed to create pipeline cache " << finalPath.string() << std::endl;
+        return;
+    }
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+    out.close();
+
+    if (!out) {
+        std::cerr << "WARNING: failed to write pipeline cache " << finalPath.string() << std::endl;
+        std::filesystem::remove(tempPath, ec);
+        return;
+    }
+
+    std::filesystem::rename(tempPath, finalPath, ec);
+    if (ec)
+        std::cerr << "WARNING: failed to finalize pipeline cache " << finalPath.string() << " (" << ec.message() << ")" << std::endl;
+}
+
+PipelineCache::Header PipelineCache::makeHeader() const {
+    Header header{
+        .magic = magic,
+        .version = version,
+        .vendorId = properties_.vendorID,
+        .deviceId = properties_.deviceID,
+        .driverVersion = properties_.driverVersion,
+    };
+    std::ranges::copy(properties_.pipelineCacheUUID, header.pipelineCacheUuid.begin());
+
+    return header;
+}
@@ -0,0 +1,67 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <array>
+#include <string>
+#include <string_view>
+
+#include <vulkan/vulkan_raii.hpp>
+
+/**
+ * @brief VkPipelineCache persisted on disk between runs
+ *
+ * The driver's cache blob is stored behind a header with the vendor, device, driver version and pipeline cache UUID
+ * of the device that wrote it. A blob written by a different device or driver, or a corrupted one, is discarded and
+ * the cache starts out empty (cold). The cache is internally synchronized, pipelines can be created from any thread.
+ */
+class PipelineCache {
+public:
+    PipelineCache(const vk::raii::Device& device, const vk::PhysicalDeviceProperties& properties, std::string_view path);
+
+    PipelineCache(const PipelineCache&) = delete;
+    PipelineCache& operator=(const PipelineCache&) = delete;
+
+    /**
+     * @brief writes the current cache contents to disk, replacing the file atomically
+     */
+    void save() const;
+
+    [[nodiscard]] const vk::raii::PipelineCache& getPipelineCache() const { return pipelineCache_; }
+
+    //  whether valid data was loaded from disk
+    [[nodiscard]] bool isWarm() const { return isWarm_; }
+    [[nodiscard]] size_t getLoadedSize() const { return loadedSize_; }
+
+    // bump whenever the header changes
+    static constexpr uint32_t version{1};
+
+    //  skip loading the file, used to measure cold pipeline creation
+    inline static bool loadFromDisk{true};
+
+private:
+    struct Header {
+        std::array<char, 4> magic{};
+        uint32_t version{};
+        uint32_t vendorId{};
+        uint32_t deviceId{};
+        uint32_t driverVersion{};
+        std::array<uint8_t, vk::UuidSize> pipelineCacheUuid{};
+        uint32_t padding{};
+        uint64_t dataSize{};
+        uint64_t dataHash{};
+    };
+
+    [[nodiscard]] Header makeHeader() const;
+
+    static constexpr std::array<char, 4> magic{'D', 'P', 'P', 'C'};
+
+    std::string path_{};
+    vk::PhysicalDeviceProperties properties_{};
+
+    vk::raii::PipelineCache pipelineCache_{nullptr};
+
+    bool isWarm_{false};
+    size_t loadedSize_{0};
+};
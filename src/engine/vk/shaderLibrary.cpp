@@ -0,0 +1,311 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "shaderLibrary.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#include <shaderc/shaderc.hpp>
+
+#include "../jobSystem.h"
+#include "../profiler.h"
+#include "../utils.h"
+
+namespace {
+    constexpr uint32_t spirvMagic{0x07230203};
+
+#ifdef NDEBUG
+    constexpr bool isDebug{false};
+#else
+    constexpr bool isDebug{true};
+#endif
+
+    shaderc_shader_kind getShaderKind(const std::string& name) {
+        std::string extension = std::filesystem::path{name}.extension().string();
+
+        if (extension == ".vert")
+            return shaderc_glsl_vertex_shader;
+        if (extension == ".frag")
+            return shaderc_glsl_fragment_shader;
+        if (extension == ".comp")
+            return shaderc_glsl_compute_shader;
+
+        throw std::runtime_error("ERROR: unknown stage of shader " + name + "!");
+    }
+}
+
+/**
+ * @brief serves includes from the sources collected for the cache key, so that the compiled code matches the key
+ */
+class ShaderLibrary::Includer : public shaderc::CompileOptions::IncluderInterface {
+public:
+    explicit Includer(std::span<const SourceFile> sources) : sources_(sources) {}
+
+    shaderc_include_result* GetInclude(const char* requestedSource, shaderc_include_type, const char*, size_t) override {
+        auto* result = new IncludeResult{};
+
+        auto it = std::ranges::find(sources_, std::string_view{requestedSource}, &SourceFile::name);
+        if (it != sources_.end()) {
+            result->source_name = it->name.c_str();
+            result->source_name_length = it->name.size();
+            result->content = it->source.c_str();
+            result->content_length = it->source.size();
+        }
+        else {
+            //  an empty source name tells the compiler the include failed, the content is the error message
+            result->message = std::string{"cannot read "} + requestedSource;
+            result->source_name = "";
+            result->source_name_length = 0;
+            result->content = result->message.c_str();
+            result->content_length = result->message.size();
+        }
+
+        return result;
+    }
+
+    void ReleaseInclude(shaderc_include_result* data) override {
+        delete static_cast<IncludeResult*>(data);
+    }
+
+private:
+    struct IncludeResult : shaderc_include_result {
+        std::string message{};
+    };
+
+    std::span<const SourceFile> sources_;
+};
+
+ShaderLibrary::ShaderLibrary(std::string_view sourceDirectory) : sourceDirectory_(sourceDirectory) {
+    lastPoll_ = std::chrono::steady_clock::now();
+}
+
+std::vector<uint32_t> ShaderLibrary::getSpirv(std::string_view name, std::span<const Define> defines) {
+    Profiler::Scope scope{"ShaderLibrary::getSpirv"};
+
+    std::string shaderName{name};
+
+    if (!std::filesystem::exists(sourceDirectory_ / shaderName)) {
+        std::vector<uint32_t> code = loadPrecompiled(shaderName);
+
+        std::lock_guard lock(mutex_);
+        stats_.precompiledCount += 1;
+        return code;
+    }
+
+    std::vector<SourceFile> sources{};
+    collectSources(shaderName, sources);
+
+    {
+        //  a file edited after its first read keeps its old time, so the next poll still reports it
+        std::lock_guard lock(mutex_);
+        auto& files = shaderFiles_[shaderName];
+        files.clear();
+        for (const auto& source : sources) {
+            files.emplace_back(source.name);
+            writeTimes_.try_emplace(source.name, source.writeTime);
+        }
+    }
+
+    //  everything the compiled code depends on goes into the key
+    uint64_t hash = Utils::hash64(&version, sizeof(version));
+    hash = Utils::hash64(&isDebug, sizeof(isDebug), hash);
+    for (const auto& source : sources) {
+        hash = Utils::hash64(source.name.data(), source.name.size(), hash);
+        hash = Utils::hash64(source.source.data(), source.source.size(), hash);
+    }
+    for (const auto& define : defines) {
+        hash = Utils::hash64(define.name.data(), define.name.size(), hash);
+        hash = Utils::hash64(define.value.data(), define.value.size(), hash);
+    }
+
+    std::filesystem::path cachePath{cachePathPrefix + std::to_string(hash) + ".spv"};
+
+    if (useSpirvCache) {
+        std::vector<uint32_t> code = readSpirv(cachePath);
+        if (!code.empty()) {
+            std::lock_guard lock(mutex_);
+            stats_.cacheHitCount += 1;
+            return code;
+        }
+    }
+
+    std::vector<uint32_t> code = compile(sources, defines);
+
+    if (useSpirvCache)
+        writeSpirv(cachePath, code);
+
+    std::lock_guard lock(mutex_);
+    stats_.compiledCount += 1;
+    return code;
+}
+
+std::vector<std::string> ShaderLibrary::pollChanges() {
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastPoll_ < pollInterval)
+        return {};
+
+    lastPoll_ = now;
+
+    std::lock_guard lock(mutex_);
+
+    std::vector<std::string> changedFiles{};
+    for (auto& [file, writeTime] : writeTimes_) {
+        //  editors may replace the file while saving, a file that can't be checked now is picked up by the next poll
+        std::error_code ec;
+        auto currentWriteTime = std::filesystem::last_write_time(sourceDirectory_ / file, ec);
+        if (ec || currentWriteTime == writeTime)
+            continue;
+
+        writeTime = currentWriteTime;
+        changedFiles.emplace_back(file);
+    }
+
+    std::vector<std::string> changedShaders{};
+    if (changedFiles.empty())
+        return changedShaders;
+
+    for (const auto& [shader, files] : shaderFiles_) {
+        bool isAffected = std::ranges::any_of(files, [&](const std::string& file) {
+            return std::ranges::find(changedFiles, file) != changedFiles.end();
+        });
+
+        if (isAffected)
+            changedShaders.emplace_back(shader);
+    }
+
+    return changedShaders;
+}
+
+ShaderLibrary::Stats ShaderLibrary::getStats() const {
+    std::lock_guard lock(mutex_);
+    return stats_;
+}
+
+void ShaderLibrary::collectSources(const std::string& name, std::vector<SourceFile>& sources) const {
+    if (std::ranges::find(sources, name, &SourceFile::name) != sources.end())
+        return;
+
+    std::filesystem::path path = sourceDirectory_ / name;
+
+    //  the time is taken before reading, an edit during the read is then seen by the next poll
+    std::error_code ec;
+    auto writeTime = std::filesystem::last_write_time(path, ec);
+
+    std::ifstream file(path, std::ios::binary);
+    if (ec || !file.is_open())
+        return;
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+
+    sources.emplace_back(SourceFile{.name = name, .source = buffer.str(), .writeTime = writeTime});
+
+    //  includes are always relative to the source directory, there are no nested directories
+    std::istringstream lines(sources.back().source);
+    for (std::string line; std::getline(lines, line);) {
+        std::string_view view{line};
+        view.remove_prefix(std::min(view.find_first_not_of(" \t"), view.size()));
+
+        if (!view.starts_with("#include"))
+            continue;
+
+        size_t first = view.find('"');
+        size_t last = view.find('"', first + 1);
+        if (first != std::string_view::npos && last != std::string_view::npos)
+            collectSources(std::string{view.substr(first + 1, last - first - 1)}, sources);
+    }
+}
+
+std::vector<uint32_t> ShaderLibrary::compile(std::span<const SourceFile> sources, std::span<const Define> defines) {
+    const SourceFile& shader = sources.front();
+
+    shaderc::CompileOptions options{};
+    options.SetTargetEnvironment(shaderc_target_env_vulkan, shaderc_env_version_vulkan_1_3);
+    options.SetIncluder(std::make_unique<Includer>(sources));
+
+    //  same as the flags of the SHADER_COMPILATION target
+    if (isDebug)
+        options.SetGenerateDebugInfo();
+    else
+        options.SetOptimizationLevel(shaderc_optimization_level_performance);
+
+    for (const auto& define : defines)
+        options.AddMacroDefinition(define.name, define.value);
+
+    //  a compiler per call, compiles run on worker threads
+    shaderc::Compiler compiler{};
+    shaderc::SpvCompilationResult result = compiler.CompileGlslToSpv(shader.source, getShaderKind(shader.name), shader.name.c_str(), options);
+
+    if (result.GetCompilationStatus() != shaderc_compilation_status_success)
+        throw std::runtime_error("ERROR: failed to compile shader " + shader.name + "!\n" + result.GetErrorMessage());
+
+    if (result.GetNumWarnings() > 0)
+        std::cerr << "WARNING: shader " << shader.name << " compiled with warnings\n" << result.GetErrorMessage() << std::endl;
+
+    return {result.cbegin(), result.cend()};
+}
+
+std::vector<uint32_t> ShaderLibrary::loadPrecompiled(std::string_view name) {
+    //  the SHADER_COMPILATION target names the output <name>_<stage>.spv
+    std::filesystem::path sourcePath{name};
+    std::string stage = sourcePath.extension().string().substr(1);
+    std::filesystem::path path{precompiledPathPrefix + sourcePath.stem().string() + "_" + stage + ".spv"};
+
+    std::vector<uint32_t> code = readSpirv(path);
+    if (code.empty())
+        throw std::runtime_error("ERROR: shader " + std::string{name} + " has neither a source nor a precompiled binary!");
+
+    return code;
+}
+
+std::vector<uint32_t> ShaderLibrary::readSpirv(const std::filesystem::path& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+        return {};
+
+    auto size = static_cast<size_t>(file.tellg());
+    if (size == 0 || size % sizeof(uint32_t) != 0)
+        return {};
+
+    std::vector<uint32_t> code(size / sizeof(uint32_t));
+    file.seekg(0);
+    file.read(reinterpret_cast<char*>(code.data()), static_cast<std::streamsize>(size));
+
+    if (!file || code.front() != spirvMagic)
+        return {};
+
+    return code;
+}
+
+void ShaderLibrary::writeSpirv(const std::filesystem::path& path, std::span<const uint32_t> code) {
+    //  write into a temporary file first, shaders shared by several pipelines can be compiled by two threads at once
+    std::filesystem::path tempPath{path};
+    tempPath += ".tmp" + std::to_string(JobSystem::getThreadIndex());
+
+    std::error_code ec;
+    if (path.has_parent_path())
+        std::filesystem::create_directories(path.parent_path(), ec);
+
+    std::ofstream out(tempPath, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "WARNING: failed to create shader cache " << path.string() << std::endl;
+        return;
+    }
+
+    out.write(reinterpret_cast<const char*>(code.data()), static_cast<std::streamsize>(code.size_bytes()));
+    out.close();
+
+    if (!out) {
+        std::cerr << "WARNING: failed to write shader cache " << path.string() << std::endl;
+        std::filesystem::remove(tempPath, ec);
+        return;
+    }
+
+    std::filesystem::rename(tempPath, path, ec);
+    if (ec)
+        std::cerr << "WARNING: failed to finalize shader cache " << path.string() << " (" << ec.message() << ")" << std::endl;
+}
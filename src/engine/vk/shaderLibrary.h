@@ -0,0 +1,99 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief compiles GLSL shaders at runtime and keeps the SPIR-V in a content addressed cache
+ *
+ * The cache key is a hash of the source, every file it includes (recursively), the defines and the compile options,
+ * so editing an include invalidates all shaders using it and nothing else. Sources that can't be found (a build
+ * shipped without them) fall back to the SPIR-V compiled at build time by the SHADER_COMPILATION target.
+ * The library remembers which files every compiled shader read, pollChanges reports the shaders that have to be
+ * rebuilt after any of them was edited.
+ */
+class ShaderLibrary {
+public:
+    struct Define {
+        std::string name{};
+        std::string value{};
+    };
+
+    struct Stats {
+        uint32_t compiledCount{0};
+        uint32_t cacheHitCount{0};
+        uint32_t precompiledCount{0};
+    };
+
+    explicit ShaderLibrary(std::string_view sourceDirectory);
+
+    ShaderLibrary(const ShaderLibrary&) = delete;
+    ShaderLibrary& operator=(const ShaderLibrary&) = delete;
+
+    /**
+     * @brief compiles a shader or loads it from the cache, safe to call from worker threads
+     * @param name file name inside the source directory, the stage is taken from the extension (.vert, .frag, .comp)
+     * @throws std::runtime_error with the compiler's messages if the shader doesn't compile
+     */
+    std::vector<uint32_t> getSpirv(std::string_view name, std::span<const Define> defines = {});
+
+    /**
+     * @brief checks the files read by the compiled shaders for changes, at most every pollInterval
+     * @return names of the shaders whose source or includes changed since the last call
+     */
+    std::vector<std::string> pollChanges();
+
+    [[nodiscard]] Stats getStats() const;
+
+    // bump whenever the compile options change in a way the key doesn't capture
+    static constexpr uint32_t version{1};
+
+    static constexpr std::chrono::milliseconds pollInterval{250};
+
+    inline static bool useSpirvCache{true};
+    inline static const std::string cachePathPrefix{"cache/shaders/"};
+    inline static const std::string precompiledPathPrefix{"shaders/"};
+
+private:
+    struct SourceFile {
+        std::string name{};
+        std::string source{};
+        std::filesystem::file_time_type writeTime{};
+    };
+
+    class Includer;
+
+    /**
+     * @brief reads name and everything it includes into sources, depth first and without duplicates
+     *
+     * Includes that can't be read are skipped here and reported by the compiler.
+     */
+    void collectSources(const std::string& name, std::vector<SourceFile>& sources) const;
+
+    //  the first source is the shader itself, the rest are served to the compiler as includes
+    static std::vector<uint32_t> compile(std::span<const SourceFile> sources, std::span<const Define> defines);
+    static std::vector<uint32_t> loadPrecompiled(std::string_view name);
+
+    static std::vector<uint32_t> readSpirv(const std::filesystem::path& path);
+    static void writeSpirv(const std::filesystem::path& path, std::span<const uint32_t> code);
+
+    std::filesystem::path sourceDirectory_{};
+
+    mutable std::mutex mutex_;
+
+    //  files read by every compiled shader, including the shader itself
+    std::unordered_map<std::string, std::vector<std::string>> shaderFiles_{};
+    std::unordered_map<std::string, std::filesystem::file_time_type> writeTimes_{};
+
+    std::chrono::steady_clock::time_point lastPoll_{};
+    Stats stats_{};
+};
@@ -0,0 +1,169 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "stagingRing.h"
+
+#include <imgui/imgui.h>
+
+StagingRing::StagingRing(const vk::raii::Device& device, vk::DeviceSize capacity) : device_(device), capacity_(capacity) {
+    buffer_ = VkUtils::createBufferVMA(capacity_, vk::BufferUsageFlagBits::eTransferSrc, VkUtils::stagingAllocFlagsVMA);
+    mapped_ = static_cast<uint8_t*>(buffer_.allocationInfo.pMappedData);
+
+    if (mapped_ == nullptr)
+        throw std::runtime_error("ERROR: Mapped pointer points to NULL!");
+
+    for (auto queueType : {VkUtils::QueueType::graphics, VkUtils::QueueType::transfer}) {
+        vk::CommandPoolCreateInfo poolInfo{
+            .flags = vk::CommandPoolCreateFlagBits::eTransient,
+            .queueFamilyIndex = VkUtils::getQueueFamilyIndex(queueType)
+        };
+        commandPools_[static_cast<int>(queueType)] = vk::raii::CommandPool(device_, poolInfo);
+    }
+}
+
+StagingRing::~StagingRing() {
+    waitIdle();
+
+    for (auto& dedicatedBuffer : openDedicatedBuffers_)
+        VkUtils::destroyBufferVMA(std::move(dedicatedBuffer));
+
+    VkUtils::destroyBufferVMA(std::move(buffer_));
+}
+
+std::optional<StagingRing::Allocation> StagingRing::tryAllocate(vk::DeviceSize size, vk::DeviceSize alignment) {
+    if (size > capacity_)
+        return std::nullopt;
+
+    uint64_t offset = (head_ + alignment - 1) / alignment * alignment;
+
+    //  allocations never wrap around, skip the rest of the buffer instead
+    if (offset % capacity_ + size > capacity_)
+        offset = (offset / capacity_ + 1) * capacity_;
+
+    if (offset + size - tail_ > capacity_)
+        return std::nullopt;
+
+    head_ = offset + size;
+    stats_.stagedBytes += size;
+
+    vk::DeviceSize physicalOffset = offset % capacity_;
+    return Allocation{
+        .buffer = &buffer_,
+        .offset = physicalOffset,
+        .data = mapped_ + physicalOffset
+    };
+}
+
+StagingRing::Allocation StagingRing::allocateDedicated(vk::DeviceSize size) {
+    auto& dedicatedBuffer = openDedicatedBuffers_.emplace_back(VkUtils::createBufferVMA(size, vk::BufferUsageFlagBits::eTransferSrc, VkUtils::stagingAllocFlagsVMA));
+    stats_.stagedBytes += size;
+
+    return Allocation{
+        .buffer = &dedicatedBuffer,
+        .offset = 0,
+        .data = static_cast<uint8_t*>(dedicatedBuffer.allocationInfo.pMappedData)
+    };
+}
+
+vk::raii::CommandBuffer StagingRing::beginCommandBuffer(VkUtils::QueueType queueType) {
+    vk::CommandBufferAllocateInfo allocInfo{
+        .commandPool = commandPools_[static_cast<int>(queueType)],
+        .level = vk::CommandBufferLevel::ePrimary,
+        .commandBufferCount = 1
+    };
+    vk::raii::CommandBuffer commandBuffer = std::move(device_.allocateCommandBuffers(allocInfo).front());
+
+    commandBuffer.begin({.flags = vk::CommandBufferUsageFlagBits::eOneTimeSubmit});
+    return commandBuffer;
+}
+
+void StagingRing::submit(vk::raii::CommandBuffer&& commandBuffer, VkUtils::QueueType queueType, std::vector<std::function<void()>>&& callbacks,
+                         vk::Semaphore signalSemaphore, uint64_t signalValue) {
+    commandBuffer.end();
+
+    Submission submission{
+        .fence = acquireFence(),
+        .commandBuffer = std::move(commandBuffer),
+        .ringEnd = head_,
+        .dedicatedBuffers = std::move(openDedicatedBuffers_),
+        .callbacks = std::move(callbacks),
+    };
+    openDedicatedBuffers_.clear();
+
+    vk::TimelineSemaphoreSubmitInfo timelineInfo{
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues = &signalValue
+    };
+
+    vk::SubmitInfo submitInfo{
+        .pNext = signalSemaphore ? &timelineInfo : nullptr,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &*submission.commandBuffer,
+        .signalSemaphoreCount = signalSemaphore ? 1u : 0u,
+        .pSignalSemaphores = &signalSemaphore
+    };
+
+    VkUtils::getQueue(queueType).submit(submitInfo, *submission.fence);
+
+    stats_.submissions += 1;
+    pending_.emplace_back(std::move(submission));
+}
+
+void StagingRing::collect() {
+    //  submissions can go to different queues, only retire in order so that the tail never skips live data
+    while (!pending_.empty() && pending_.front().fence.getStatus() == vk::Result::eSuccess) {
+        retire(pending_.front());
+        pending_.pop_front();
+    }
+}
+
+bool StagingRing::waitOldest() {
+    if (pending_.empty())
+        return false;
+
+    if (device_.waitForFences(*pending_.front().fence, vk::True, UINT64_MAX) != vk::Result::eSuccess)
+        throw std::runtime_error("ERROR: failed to wait on an upload!");
+
+    stats_.stalls += 1;
+    retire(pending_.front());
+    pending_.pop_front();
+    return true;
+}
+
+void StagingRing::waitIdle() {
+    while (waitOldest()) {}
+}
+
+vk::raii::Fence StagingRing::acquireFence() {
+    if (freeFences_.empty())
+        return vk::raii::Fence(device_, vk::FenceCreateInfo{});
+
+    vk::raii::Fence fence = std::move(freeFences_.back());
+    freeFences_.pop_back();
+    return fence;
+}
+
+void StagingRing::retire(Submission& submission) {
+    tail_ = submission.ringEnd;
+
+    //  signaled by now, reset for the next submission instead of creating a fence each time
+    device_.resetFences(*submission.fence);
+    freeFences_.emplace_back(std::move(submission.fence));
+
+    for (auto& dedicatedBuffer : submission.dedicatedBuffers)
+        VkUtils::destroyBufferVMA(std::move(dedicatedBuffer));
+
+    for (const auto& callback : submission.callbacks)
+        callback();
+}
+
+void StagingRing::drawGUI() const {
+    if (ImGui::CollapsingHeader("Uploads")) {
+        ImGui::Indent();
+        ImGui::Text("Staged: %.1f MB", static_cast<double>(stats_.stagedBytes) / (1024.0 * 1024.0));
+        ImGui::Text("Submissions: %u (%u stalled)", stats_.submissions, stats_.stalls);
+        ImGui::Text("Ring usage: %.1f / %.1f MB", static_cast<double>(head_ - tail_) / (1024.0 * 1024.0), static_cast<double>(capacity_) / (1024.0 * 1024.0));
+        ImGui::Unindent();
+    }
+}
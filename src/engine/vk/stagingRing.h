@@ -0,0 +1,117 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <array>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include "vkUtils.h"
+
+/**
+ * @brief persistently mapped ring buffer all uploads are staged through
+ *
+ * Space is handed out linearly and given back once the fence of the submission that used it is signaled,
+ * submissions retire in the order they were made. Also owns the command pools the upload command buffers are
+ * allocated from. Not thread safe, uploads are recorded and submitted from the main thread only.
+ */
+class StagingRing {
+public:
+    struct Allocation {
+        const VkUtils::BufferAlloc* buffer{nullptr};
+        vk::DeviceSize offset{0};
+        uint8_t* data{nullptr};
+    };
+
+    struct Stats {
+        uint64_t stagedBytes{0};
+        uint32_t submissions{0};
+        uint32_t stalls{0};
+    };
+
+    StagingRing(const vk::raii::Device& device, vk::DeviceSize capacity);
+    ~StagingRing();
+
+    StagingRing(const StagingRing&) = delete;
+    StagingRing& operator=(const StagingRing&) = delete;
+
+    /**
+     * @return space in the ring or nothing if it doesn't fit until some submission retires
+     */
+    std::optional<Allocation> tryAllocate(vk::DeviceSize size, vk::DeviceSize alignment);
+
+    /**
+     * @brief allocates a separate staging buffer for data that doesn't fit into the ring at all, it's freed with the next submission
+     */
+    Allocation allocateDedicated(vk::DeviceSize size);
+
+    vk::raii::CommandBuffer beginCommandBuffer(VkUtils::QueueType queueType);
+
+    /**
+     * @brief submits the command buffer, the ring space allocated so far is reclaimed once it finishes
+     * @param callbacks run on the calling thread from collect() once the submission finished
+     * @param signalSemaphore optional timeline semaphore signaled with signalValue
+     */
+    void submit(vk::raii::CommandBuffer&& commandBuffer, VkUtils::QueueType queueType, std::vector<std::function<void()>>&& callbacks,
+                vk::Semaphore signalSemaphore = nullptr, uint64_t signalValue = 0);
+
+    /**
+     * @brief retires all finished submissions without blocking
+     */
+    void collect();
+
+    /**
+     * @brief blocks until the oldest submission finishes and retires it
+     * @return false if there was nothing to wait on
+     */
+    bool waitOldest();
+
+    void waitIdle();
+
+    [[nodiscard]] bool hasPending() const { return !pending_.empty(); }
+    [[nodiscard]] vk::DeviceSize getCapacity() const { return capacity_; }
+    [[nodiscard]] const Stats& getStats() const { return stats_; }
+
+    void drawGUI() const;
+
+private:
+    friend class UploadBatch;
+
+    struct Submission {
+        vk::raii::Fence fence{nullptr};
+        vk::raii::CommandBuffer commandBuffer{nullptr};
+        uint64_t ringEnd{0};
+        std::vector<VkUtils::BufferAlloc> dedicatedBuffers{};
+        std::vector<std::function<void()>> callbacks{};
+    };
+
+    //  an unsignaled fence from the pool, created if all of them are in use
+    vk::raii::Fence acquireFence();
+    void retire(Submission& submission);
+
+    const vk::raii::Device& device_;
+
+    VkUtils::BufferAlloc buffer_{};
+    uint8_t* mapped_{nullptr};
+    vk::DeviceSize capacity_{0};
+
+    //  monotonic offsets, the physical offset is offset % capacity_
+    uint64_t head_{0};
+    uint64_t tail_{0};
+
+    std::deque<Submission> pending_{};
+    std::vector<vk::raii::Fence> freeFences_{};
+    std::vector<VkUtils::BufferAlloc> openDedicatedBuffers_{};
+
+    //  one pool per queue type, indexed by VkUtils::QueueType
+    std::array<vk::raii::CommandPool, 3> commandPools_{nullptr, nullptr, nullptr};
+
+    bool isBatchOpen_{false};
+
+    Stats stats_{};
+};
@@ -0,0 +1,115 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "uploadBatch.h"
+
+#include <cstring>
+#include <iostream>
+
+UploadBatch::UploadBatch(StagingRing& ring, VkUtils::QueueType queueType) : ring_(ring), queueType_(queueType) {
+    //  the ring hands out space linearly, a second open batch could get its unsubmitted space reclaimed
+    if (ring_.isBatchOpen_)
+        throw std::runtime_error("ERROR: only one upload batch can be recorded at a time!");
+
+    ring_.isBatchOpen_ = true;
+    commandBuffer_ = ring_.beginCommandBuffer(queueType_);
+}
+
+UploadBatch::~UploadBatch() {
+    if (isSubmitted_)
+        return;
+
+    //  destructors run during unwinding too, a failed submit must not terminate
+    try {
+        submit();
+    }
+    catch (const std::exception& e) {
+        std::cerr << "WARNING: failed to submit an upload batch\n" << e.what() << std::endl;
+    }
+}
+
+StagingRing::Allocation UploadBatch::allocate(vk::DeviceSize size, vk::DeviceSize alignment) {
+    isEmpty_ = false;
+
+    ring_.collect();
+    while (true) {
+        if (auto allocation = ring_.tryAllocate(size, alignment))
+            return *allocation;
+
+        //  free up space by waiting for older uploads first, then by submitting what this batch recorded so far
+        if (ring_.waitOldest())
+            continue;
+
+        if (ring_.head_ != ring_.tail_) {
+            flush();
+            continue;
+        }
+
+        //  doesn't fit even into an empty ring
+        return ring_.allocateDedicated(size);
+    }
+}
+
+void UploadBatch::uploadBuffer(const void* data, vk::DeviceSize size, const VkUtils::BufferAlloc& dstBuffer, vk::DeviceSize dstOffset) {
+    auto allocation = allocate(size);
+    std::memcpy(allocation.data, data, size);
+
+    vk::BufferCopy region{
+        .srcOffset = allocation.offset,
+        .dstOffset = dstOffset,
+        .size = size
+    };
+    commandBuffer_.copyBuffer(allocation.buffer->buffer, dstBuffer.buffer, region);
+}
+
+void UploadBatch::onComplete(std::function<void()> callback) {
+    callbacks_.emplace_back(std::move(callback));
+}
+
+void UploadBatch::signal(vk::Semaphore timelineSemaphore, uint64_t value) {
+    signalSemaphore_ = timelineSemaphore;
+    signalValue_ = value;
+}
+
+void UploadBatch::flush() {
+    //  no barrier here, the one submit() records covers these copies too as they were submitted earlier to the same queue,
+    //  on the transfer queue the semaphore signaled by the last submission does the same
+    ring_.submit(std::move(commandBuffer_), queueType_, {});
+    commandBuffer_ = ring_.beginCommandBuffer(queueType_);
+}
+
+void UploadBatch::submit() {
+    if (isSubmitted_)
+        return;
+
+    ring_.isBatchOpen_ = false;
+    isSubmitted_ = true;
+
+    //  nothing to wait for, the begun command buffer goes back to the pool unsubmitted
+    if (isEmpty_ && !signalSemaphore_) {
+        commandBuffer_ = vk::raii::CommandBuffer{nullptr};
+
+        for (const auto& callback : callbacks_)
+            callback();
+        return;
+    }
+
+    //  make the copies visible to everything submitted to this queue afterward, the transfer queue relies on the semaphore instead
+    if (!isEmpty_ && queueType_ == VkUtils::QueueType::graphics) {
+        vk::MemoryBarrier2 barrier{
+            .srcStageMask = vk::PipelineStageFlagBits2::eTransfer,
+            .srcAccessMask = vk::AccessFlagBits2::eTransferWrite,
+            .dstStageMask = vk::PipelineStageFlagBits2::eAllCommands,
+            .dstAccessMask = vk::AccessFlagBits2::eMemoryRead
+        };
+        commandBuffer_.pipelineBarrier2(vk::DependencyInfo{.memoryBarrierCount = 1, .pMemoryBarriers = &barrier});
+    }
+
+    ring_.submit(std::move(commandBuffer_), queueType_, std::move(callbacks_), signalSemaphore_, signalValue_);
+}
+
+void UploadBatch::submitAndWait() {
+    submit();
+    ring_.waitIdle();
+}
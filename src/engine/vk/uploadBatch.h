@@ -0,0 +1,67 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <functional>
+#include <vector>
+
+#include <vulkan/vulkan_raii.hpp>
+
+#include "stagingRing.h"
+#include "vkUtils.h"
+
+/**
+ * @brief records many buffer and image uploads into a single command buffer staged through the StagingRing
+ *
+ * If the ring runs out of space, the batch first waits for older submissions and only then submits what it
+ * has recorded so far and continues in a new command buffer. Only one batch can be recorded at a time.
+ * Anything left unsubmitted is submitted on destruction.
+ */
+class UploadBatch {
+public:
+    explicit UploadBatch(StagingRing& ring, VkUtils::QueueType queueType = VkUtils::QueueType::graphics);
+    ~UploadBatch();
+
+    UploadBatch(const UploadBatch&) = delete;
+    UploadBatch& operator=(const UploadBatch&) = delete;
+
+    /**
+     * @brief returns staging memory to write into, copies reading from it have to be recorded into getCommandBuffer()
+     */
+    StagingRing::Allocation allocate(vk::DeviceSize size, vk::DeviceSize alignment = 16);
+
+    void uploadBuffer(const void* data, vk::DeviceSize size, const VkUtils::BufferAlloc& dstBuffer, vk::DeviceSize dstOffset = 0);
+
+    [[nodiscard]] vk::raii::CommandBuffer& getCommandBuffer() { return commandBuffer_; }
+
+    /**
+     * @brief the callback runs on the main thread once the GPU has finished the batch
+     */
+    void onComplete(std::function<void()> callback);
+
+    /**
+     * @brief signals the timeline semaphore with value once the batch finishes
+     */
+    void signal(vk::Semaphore timelineSemaphore, uint64_t value);
+
+    void submit();
+    void submitAndWait();
+
+    [[nodiscard]] bool isEmpty() const { return isEmpty_; }
+
+private:
+    void flush();
+
+    StagingRing& ring_;
+    VkUtils::QueueType queueType_;
+
+    vk::raii::CommandBuffer commandBuffer_{nullptr};
+    std::vector<std::function<void()>> callbacks_{};
+
+    vk::Semaphore signalSemaphore_{nullptr};
+    uint64_t signalValue_{0};
+
+    bool isEmpty_{true};
+    bool isSubmitted_{false};
+};
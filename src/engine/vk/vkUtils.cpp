@@ -3,6 +3,7 @@
 //
 
 #include "vkUtils.h"
+#include <array>
 #include <iostream>
 #include <ranges>
 
@@ -60,6 +61,10 @@ void VkUtils::destroyBufferVMA(BufferAlloc&& buffer) {
     vmaDestroyBuffer(allocator_,buffer.buffer,buffer.allocation);
 }
 
+void VkUtils::invalidateBuffer(const BufferAlloc& buffer, vk::DeviceSize offset, vk::DeviceSize size) {
+    vmaInvalidateAllocation(allocator_, buffer.allocation, offset, size);
+}
+
 
 void VkUtils::copyBuffer(const BufferAlloc& srcBuffer, const BufferAlloc& dstBuffer, vk::DeviceSize size) {
     vk::BufferCopy region{
@@ -79,14 +84,14 @@ void VkUtils::copyBuffer(const BufferAlloc& srcBuffer, const BufferAlloc& dstBuf
     endSingleTimeCommand(cmdBuf,QueueType::graphics);
 }
 
-void VkUtils::copyBufferToImage(const BufferAlloc& buffer, const ImageAlloc& image, uint32_t width, uint32_t height, vk::raii::CommandBuffer& cmdBuf) {
+void VkUtils::copyBufferToImage(const BufferAlloc& buffer, const ImageAlloc& image, uint32_t width, uint32_t height, vk::raii::CommandBuffer& cmdBuf, vk::DeviceSize bufferOffset, uint32_t mipLevel) {
     vk::BufferImageCopy region {
-        .bufferOffset = 0,
+        .bufferOffset = bufferOffset,
         .bufferRowLength = 0,
         .bufferImageHeight = 0,
         .imageSubresource = {
             .aspectMask = vk::ImageAspectFlagBits::eColor,
-            .mipLevel = 0,
+            .mipLevel = mipLevel,
             .baseArrayLayer = 0,
             .layerCount = 1,
         },
@@ -134,12 +139,13 @@ void VkUtils::copyImageToBuffer(const ImageAlloc& image, const BufferAlloc& buff
 }
 
 
-void VkUtils::init(const vk::raii::Device* device, const vk::raii::PhysicalDevice* physicalDevice, const vk::raii::Instance* instance, const std::vector<const vk::raii::Queue*>&& queueHandles, const vk::
-                   raii::CommandPool* commandPool) {
+void VkUtils::init(const vk::raii::Device* device, const vk::raii::PhysicalDevice* physicalDevice, const vk::raii::Instance* instance, const std::vector<const vk::raii::Queue*>&& queueHandles,
+                   const std::vector<uint32_t>&& queueFamilyIndices, const vk::raii::CommandPool* commandPool, bool isMemoryPrioritySupported) {
     device_ = device;
     physicalDevice_ = physicalDevice;
     memoryProperties_ = physicalDevice->getMemoryProperties();
     queueHandles_ = queueHandles;
+    queueFamilyIndices_ = queueFamilyIndices;
     commandPool_ = commandPool;
     instance_ = instance;
 
@@ -149,7 +155,7 @@ void VkUtils::init(const vk::raii::Device* device, const vk::raii::PhysicalDevic
     };
 
     VmaAllocatorCreateInfo allocatorCreateInfo{
-        .flags = VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT,
+        .flags = isMemoryPrioritySupported ? VMA_ALLOCATOR_CREATE_EXT_MEMORY_PRIORITY_BIT : VmaAllocatorCreateFlags{},
         .physicalDevice = **physicalDevice_,
         .device = **device,
         .pVulkanFunctions = &vulkanFunctions,
@@ -161,6 +167,17 @@ void VkUtils::init(const vk::raii::Device* device, const vk::raii::PhysicalDevic
 
 }
 
+vk::DeviceSize VkUtils::getMemoryUsage() {
+    std::array<VmaBudget, VK_MAX_MEMORY_HEAPS> budgets{};
+    vmaGetHeapBudgets(allocator_, budgets.data());
+
+    vk::DeviceSize usage{0};
+    for (uint32_t i = 0; i < memoryProperties_.memoryHeapCount; ++i)
+        usage += budgets[i].usage;
+
+    return usage;
+}
+
 void VkUtils::destroy() {
     vmaDestroyAllocator(allocator_);
 }
@@ -196,7 +213,7 @@ void VkUtils::endSingleTimeCommand(const vk::raii::CommandBuffer& cmdBuf, QueueT
 
 void VkUtils::transitionImageLayout(const vk::Image& image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout, vk::PipelineStageFlags2 srcStageMask,
                                     vk::AccessFlags2 srcAccessMask, vk::PipelineStageFlags2 dstStageMask, vk::AccessFlags2 dstAccessMask,
-                                    vk::ImageAspectFlags imageAspectFlags, vk::raii::CommandBuffer& cmdBuf) {
+                                    vk::ImageAspectFlags imageAspectFlags, vk::raii::CommandBuffer& cmdBuf, uint32_t levelCount) {
 
     vk::ImageMemoryBarrier2 barrier{
         .srcStageMask = srcStageMask,
@@ -211,7 +228,7 @@ void VkUtils::transitionImageLayout(const vk::Image& image, vk::ImageLayout oldL
         .subresourceRange = {
             .aspectMask = imageAspectFlags,
             .baseMipLevel = 0,
-            .levelCount = 1,
+            .levelCount = levelCount,
             .baseArrayLayer = 0,
             .layerCount = 1
         }
@@ -34,16 +34,26 @@ public:
     static void mapMemory(const BufferAlloc& buffer, void*& ptr);
     static void unmapMemory(const BufferAlloc& buffer);
 
+    /**
+     * @brief makes device writes visible to the host, needed before reading mapped memory that isn't host coherent
+     */
+    static void invalidateBuffer(const BufferAlloc& buffer, vk::DeviceSize offset = 0, vk::DeviceSize size = vk::WholeSize);
+
 
     static ImageAlloc createImageVMA(const vk::ImageCreateInfo& imageInfo, VmaAllocationCreateFlags allocationFlags = {});
     static void destroyImageVMA(ImageAlloc&& image);
 
+    /**
+     * @brief device memory used by this process over all heaps, from the memory budget or VMA's own estimate without it
+     */
+    static vk::DeviceSize getMemoryUsage();
+
 
     static void copyBuffer(const BufferAlloc& srcBuffer, const BufferAlloc& dstBuffer, vk::DeviceSize size);
     static void copyBuffer(const BufferAlloc& srcBuffer, const BufferAlloc& dstBuffer, const vk::BufferCopy& region);
 
 
-    static void copyBufferToImage(const BufferAlloc& buffer, const ImageAlloc& image, uint32_t width, uint32_t height, vk::raii::CommandBuffer& cmdBuf);
+    static void copyBufferToImage(const BufferAlloc& buffer, const ImageAlloc& image, uint32_t width, uint32_t height, vk::raii::CommandBuffer& cmdBuf, vk::DeviceSize bufferOffset = 0, uint32_t mipLevel = 0);
     static void copyImageToBuffer(const ImageAlloc& image, const BufferAlloc& buffer, int32_t offsetX, uint32_t width, int32_t offsetY, uint32_t height, vk::raii::CommandBuffer& cmdBuf);
 
     /**
@@ -75,17 +85,20 @@ public:
     static void transitionImageLayout(const vk::Image &image, vk::ImageLayout oldLayout, vk::ImageLayout newLayout,
                                       vk::PipelineStageFlags2 srcStageMask, vk::AccessFlags2 srcAccessMask,
                                       vk::PipelineStageFlags2 dstStageMask, vk::AccessFlags2 dstAccessMask,
-                                      vk::ImageAspectFlags imageAspectFlags, vk::raii::CommandBuffer &cmdBuf);
+                                      vk::ImageAspectFlags imageAspectFlags, vk::raii::CommandBuffer &cmdBuf, uint32_t levelCount = 1);
 
     static constexpr VmaAllocationCreateFlags stagingAllocFlagsVMA{VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT | VMA_ALLOCATION_CREATE_MAPPED_BIT};
 
     static const vk::raii::Device& getDevice() {return *device_;}
 
+    static uint32_t getQueueFamilyIndex(QueueType queueType) { return queueFamilyIndices_[static_cast<int>(queueType)]; }
+    static const vk::raii::Queue& getQueue(QueueType queueType) { return *queueHandles_[static_cast<int>(queueType)]; }
+
 private:
     friend class Engine;
 
-    static void init(const vk::raii::Device* device, const vk::raii::PhysicalDevice* physicalDevice, const vk::raii::Instance* instance, const std::vector<const vk::raii::Queue*>&& queueHandles, const vk::
-                     raii::CommandPool* commandPool);
+    static void init(const vk::raii::Device* device, const vk::raii::PhysicalDevice* physicalDevice, const vk::raii::Instance* instance, const std::vector<const vk::raii::Queue*>&& queueHandles,
+                     const std::vector<uint32_t>&& queueFamilyIndices, const vk::raii::CommandPool* commandPool, bool isMemoryPrioritySupported);
 
     static void destroy();
 
@@ -94,6 +107,7 @@ private:
     inline static const vk::raii::Instance* instance_{};
     inline static vk::PhysicalDeviceMemoryProperties memoryProperties_{};
     inline static std::vector<const vk::raii::Queue*> queueHandles_{};
+    inline static std::vector<uint32_t> queueFamilyIndices_{};
     inline static const vk::raii::CommandPool* commandPool_{};
 
     inline static VmaAllocator allocator_{};
@@ -1,17 +1,105 @@
+#include <charconv>
+#include <iostream>
+#include <optional>
+#include <string>
+#include <string_view>
+
 #include "../engine/engine.h"
 #include "../engine/modelLoader.h"
+#include "../engine/profiler.h"
 #include "../engine/managers/resourceManager.h"
 
-int main() {
+namespace {
+    constexpr std::string_view usage{"usage: dp [--headless] [--frames N] [--output frame.png|frame.exr] [--trace trace.json] "
+                                     "[--benchmark camera_path.txt] [--report benchmark.json]"};
+
+    //  the whole argument has to be a number, stoul would throw on text and wrap negative numbers around
+    std::optional<uint32_t> parseCount(std::string_view arg) {
+        uint32_t value{0};
+        auto [end, error] = std::from_chars(arg.data(), arg.data() + arg.size(), value);
+        if (error != std::errc{} || end != arg.data() + arg.size())
+            return std::nullopt;
+        return value;
+    }
+}
+
+//  usage: dp [--headless] [--frames N] [--output frame.png|frame.exr] [--trace trace.json]
+//            [--benchmark camera_path.txt] [--report benchmark.json]
+//  headless runs render N frames offscreen, print the frame time and optionally save the last frame
+//  --benchmark replays a recorded camera path over N frames without vsync and writes the frame time percentiles to the report
+//  --trace writes the profiler's scopes as a Chrome trace once rendering stopped
+int main(int argc, char** argv) {
+    uint32_t frameCount{100};
+    std::optional<std::string> outputPath{};
+    std::optional<std::string> tracePath{};
+    std::optional<std::string> benchmarkPath{};
+    std::string reportPath{"benchmark.json"};
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+        if (arg == "--headless")
+            Engine::headless = true;
+        else if (arg == "--frames" && i + 1 < argc) {
+            std::optional<uint32_t> count = parseCount(argv[++i]);
+            if (!count) {
+                std::cerr << "ERROR: --frames expects a frame count, got " << argv[i] << "\n" << usage << std::endl;
+                return EXIT_FAILURE;
+            }
+            frameCount = *count;
+        }
+        else if (arg == "--output" && i + 1 < argc)
+            outputPath = argv[++i];
+        else if (arg == "--trace" && i + 1 < argc)
+            tracePath = argv[++i];
+        else if (arg == "--benchmark" && i + 1 < argc)
+            benchmarkPath = argv[++i];
+        else if (arg == "--report" && i + 1 < argc)
+            reportPath = argv[++i];
+        else
+            std::cerr << "WARNING: unknown argument " << arg << std::endl;
+    }
+
+    //  a broken path fails before anything is loaded
+    std::optional<CameraPath> cameraPath{};
+    if (benchmarkPath) {
+        cameraPath = CameraPath::load(*benchmarkPath);
+        Engine::useVsync = false;
+    }
+
     Engine::getInstance().init();
 
     auto cam = std::make_shared<Camera>(glm::vec3{0,0,2},glm::vec3{0,0,0});
     auto sky = TextureManager::getInstance()->registerResource("sky", "../assets/sky/lebombo_4k.exr", false);
-    auto scene = std::make_shared<Scene>(ModelLoader::loadModel("room/room.obj", false),cam,std::move(sky));
+    auto scene = std::make_shared<Scene>(ModelLoader::loadModel("room/room.obj"),cam,std::move(sky));
 
     Engine::getInstance().setScene(std::move(scene));
-    Engine::getInstance().run();
+
+    if (cameraPath) {
+        BenchmarkReport report = Engine::getInstance().runBenchmark(*cameraPath, frameCount);
+        report.writeJson(reportPath);
+
+        BenchmarkReport::Summary frameTime = report.getFrameTime();
+        BenchmarkReport::Summary gpuTime = report.getGpuTime();
+        std::cout << "Frame time over " << frameTime.count << " frame(s): p50 " << frameTime.p50 << " ms, p95 " << frameTime.p95 << " ms, p99 " << frameTime.p99
+                  << " ms, GPU p50 " << gpuTime.p50 << " ms, written to " << reportPath << std::endl;
+
+        if (outputPath && Engine::headless)
+            Engine::getInstance().saveFrame(*outputPath);
+    }
+    else if (Engine::headless) {
+        double frameTime = Engine::getInstance().renderFrames(frameCount);
+        std::cout << "Rendered " << frameCount << " frame(s), " << frameTime << " ms per frame (" << (frameTime > 0.0 ? 1000.0 / frameTime : 0.0) << " fps)" << std::endl;
+
+        if (outputPath)
+            Engine::getInstance().saveFrame(*outputPath);
+    }
+    else
+        Engine::getInstance().run();
+
+    if (tracePath)
+        Profiler::getInstance().exportChromeTrace(*tracePath);
+
     Engine::getInstance().cleanup();
 
     return EXIT_SUCCESS;
-}
\ No newline at end of file
+}
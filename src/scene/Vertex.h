@@ -7,6 +7,7 @@
 #include <vulkan/vulkan_raii.hpp>
 
 #include <array>
+#include <cmath>
 
 struct Vertex3D{
     glm::vec3 position{};
@@ -51,4 +52,108 @@ struct Vertex3D{
             }
         };
     }
-};
\ No newline at end of file
+};
+
+/**
+ * @brief layout the GPU reads mesh vertices in, meshes are always kept as Vertex3D on the CPU
+ */
+enum class VertexFormat : uint8_t {
+    full = 0,   //  Vertex3D as is
+    packed = 1  //  PackedVertex3D
+};
+
+/**
+ * @brief 20 byte vertex, positions are quantized against the mesh bounds
+ *
+ * The shader gets positions in [0,1], the mesh folds the dequantization into its model matrix. Normal and tangent
+ * are octahedral encoded, the bitangent sign lives in the w component of the position.
+ */
+struct PackedVertex3D {
+    std::array<uint16_t, 4> position{};
+    uint32_t normal{};
+    uint32_t tangent{};
+    uint32_t texCoord{};
+
+    /**
+     * @param boundsMin minimum of the mesh bounds
+     * @param invBoundsExtent reciprocal of the bounds extent, 0 on axes the mesh is flat in
+     */
+    static PackedVertex3D pack(const Vertex3D& vertex, const glm::vec3& boundsMin, const glm::vec3& invBoundsExtent, float bitangentSign = 1.0f) {
+        glm::vec3 position = glm::clamp((vertex.position - boundsMin) * invBoundsExtent, 0.0f, 1.0f);
+
+        return PackedVertex3D{
+            .position = {
+                static_cast<uint16_t>(std::lround(position.x * 65535.0f)),
+                static_cast<uint16_t>(std::lround(position.y * 65535.0f)),
+                static_cast<uint16_t>(std::lround(position.z * 65535.0f)),
+                static_cast<uint16_t>(bitangentSign < 0.0f ? 0 : 65535)
+            },
+            .normal = glm::packSnorm2x16(octEncode(vertex.normal)),
+            .tangent = glm::packSnorm2x16(octEncode(vertex.tangent)),
+            .texCoord = glm::packHalf2x16(vertex.texCoord)
+        };
+    }
+
+    /**
+     * @brief maps a direction onto the octahedron unfolded into [-1,1]^2, a zero vector ends up as +z
+     */
+    static glm::vec2 octEncode(const glm::vec3& direction) {
+        float length = std::abs(direction.x) + std::abs(direction.y) + std::abs(direction.z);
+        if (length == 0.0f)
+            return glm::vec2{0.0f};
+
+        glm::vec3 n = direction / length;
+        if (n.z >= 0.0f)
+            return glm::vec2{n.x, n.y};
+
+        //  fold the lower hemisphere over the diagonals
+        return glm::vec2{
+            (1.0f - std::abs(n.y)) * (n.x >= 0.0f ? 1.0f : -1.0f),
+            (1.0f - std::abs(n.x)) * (n.y >= 0.0f ? 1.0f : -1.0f)
+        };
+    }
+
+    static constexpr vk::VertexInputBindingDescription getBindingDescription(){
+        return vk::VertexInputBindingDescription{
+            .binding = 0,
+            .stride = sizeof(PackedVertex3D),
+            .inputRate = vk::VertexInputRate::eVertex
+        };
+    }
+
+    //  same locations as Vertex3D, the shaders read both layouts
+    static constexpr std::array<vk::VertexInputAttributeDescription, 4> getAttributeDescriptions() {
+        return {
+            vk::VertexInputAttributeDescription{ // position
+                .location = 0,
+                .binding = 0,
+                .format = vk::Format::eR16G16B16A16Unorm,
+                .offset = static_cast<uint32_t>(offsetof(PackedVertex3D, position))
+            },
+            vk::VertexInputAttributeDescription{ // normal
+                .location = 1,
+                .binding = 0,
+                .format = vk::Format::eR16G16Snorm,
+                .offset = static_cast<uint32_t>(offsetof(PackedVertex3D, normal))
+            },
+            vk::VertexInputAttributeDescription{ // tangent
+                .location = 2,
+                .binding = 0,
+                .format = vk::Format::eR16G16Snorm,
+                .offset = static_cast<uint32_t>(offsetof(PackedVertex3D, tangent))
+            },
+            vk::VertexInputAttributeDescription{ // texCoord
+                .location = 3,
+                .binding = 0,
+                .format = vk::Format::eR16G16Sfloat,
+                .offset = static_cast<uint32_t>(offsetof(PackedVertex3D, texCoord))
+            }
+        };
+    }
+};
+
+static_assert(sizeof(PackedVertex3D) == 20);
+
+constexpr uint32_t getVertexStride(VertexFormat format) {
+    return format == VertexFormat::packed ? sizeof(PackedVertex3D) : sizeof(Vertex3D);
+}
@@ -47,6 +47,14 @@ const glm::mat4 &Camera::getInvViewProjMat() const {
     return uboFormat_.matInvViewProj;
 }
 
+Ray Camera::getRay(const glm::vec2& ndc) const {
+    //  any point along the pixel's line of sight, the far plane is numerically the safest
+    glm::vec4 farPoint = getInvViewProjMat() * glm::vec4(ndc, 1.0f, 1.0f);
+    glm::vec3 direction = glm::vec3(farPoint) / farPoint.w - getPositionWorld();
+
+    return {getPositionWorld(), glm::normalize(direction)};
+}
+
 void Camera::updateOrientation(double dx, double dy) {
     yaw_ += dx * 0.03;
     pitch_ -= dy * 0.03;
@@ -71,6 +79,14 @@ void Camera::updatePosition(const glm::vec3 &velocity) {
     }
 }
 
+void Camera::setPose(const Pose& pose) {
+    positionWorld_ = pose.position;
+    yaw_ = pose.yaw;
+    pitch_ = glm::clamp(pose.pitch, -89.0f, 89.0f);
+
+    updateCameraVectors();
+}
+
 void Camera::recalculateMatrices() {
     recalculateViewMat();
     recalculateProjMat();
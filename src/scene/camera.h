@@ -7,11 +7,18 @@
 
 #include <glm/glm.hpp>
 
+#include "../engine/ray.h"
 #include "../engine/uboFormat.h"
 
 
 class Camera : public UBOFormat<CameraUBOFormat> {
 public:
+    //  everything the user controls, enough to restore the camera exactly
+    struct Pose {
+        glm::vec3 position{};
+        float yaw{0.0f};
+        float pitch{0.0f};
+    };
 
     explicit Camera(const glm::vec3& position, const glm::vec3& viewAt, float verticalFov = 45.0f);
 
@@ -27,9 +34,19 @@ public:
 
     [[nodiscard]] const glm::vec3 & getPositionWorld() const { return uboFormat_.positionWorld; }
 
+    /**
+     * @brief world space ray from the camera through a point of the screen
+     * @param ndc x to the right and y up, both in [-1, 1]
+     * @return ray with a normalized direction, distances along it are in world units
+     */
+    [[nodiscard]] Ray getRay(const glm::vec2& ndc) const;
+
     void updateOrientation(double dx, double dy);
     void updatePosition(const glm::vec3& velocity);
 
+    [[nodiscard]] Pose getPose() const { return {.position = positionWorld_, .yaw = yaw_, .pitch = pitch_}; }
+    void setPose(const Pose& pose);
+
 
 private:
 
@@ -5,6 +5,7 @@
 #include "material.h"
 
 #include <imgui/imgui.h>
+#include <algorithm>
 #include <utility>
 #include <iostream>
 
@@ -22,59 +23,39 @@ void Material::setTexture(std::shared_ptr<Texture> texture, TextureMapSlot slot)
     if (slot == TextureMapSlot::invalidMapSlot)
         throw std::runtime_error("ERROR: trying to set texture at invalid slot offset!");
 
+    //  get notified once a streamed texture finishes uploading
+    if (texture && !texture->isResident() && isValid())
+        Engine::getInstance().getTextureStreamer().watch(getHandle());
+
     textures_[static_cast<uint8_t>(slot)] = std::move(texture);
 
-    if (slot == TextureMapSlot::diffuseMapSlot)
-        uboFormat_.diffuseAlbedoMapHandle = 1;
-    else if (slot == TextureMapSlot::specularMapSlot)
-        uboFormat_.specularALbedoMapHandle = 1;
-    else if (slot == TextureMapSlot::normalMapSlot)
-        uboFormat_.normalMapHandle = 1;
-    else if (slot == TextureMapSlot::shininessMapSlot)
-        uboFormat_.shininessMapHandle = 1;
+    bindTextures();
 }
 
-void Material::recordDescriptorSet() const {
-
-    std::vector<vk::WriteDescriptorSet> descriptorWrites{};
-    std::vector<vk::DescriptorImageInfo> imageInfos;
-    imageInfos.reserve(textures_.size());
-    descriptorWrites.reserve(textures_.size());
-
-    auto dummy = TextureManager::getInstance()->getResource("dummy");
-
-    for (uint32_t i = 0; i < textures_.size(); ++i) {
+void Material::bindTextures() {
+    BindlessTextures& bindlessTextures = Engine::getInstance().getBindlessTextures();
 
-        imageInfos.emplace_back(vk::DescriptorImageInfo{
-            .sampler = textures_[i] ? textures_[i]->getVkSampler() : dummy->getVkSampler(),
-            .imageView = textures_[i] ? textures_[i]->getVkImageView() : dummy->getVkImageView(),
-            .imageLayout = vk::ImageLayout::eShaderReadOnlyOptimal
-        });
+    //  shaders only sample maps whose handle is set, so textures still being streamed aren't mixed in
+    auto getMapHandle = [&](TextureMapSlot slot) -> uint32_t {
+        const auto& texture = textures_[static_cast<uint8_t>(slot)];
+        return texture ? bindlessTextures.bind(*texture) : BindlessTextures::invalidIndex;
+    };
 
-        vk::WriteDescriptorSet writeDescriptorSet{
-            .dstSet = descriptorSet_,
-            .dstBinding = i,
-            .dstArrayElement = 0,
-            .descriptorCount = 1,
-            .descriptorType = vk::DescriptorType::eCombinedImageSampler,
-            .pImageInfo = &imageInfos.back()
-        };
+    uboFormat_.diffuseAlbedoMapHandle = getMapHandle(TextureMapSlot::diffuseMapSlot);
+    uboFormat_.specularALbedoMapHandle = getMapHandle(TextureMapSlot::specularMapSlot);
+    uboFormat_.normalMapHandle = getMapHandle(TextureMapSlot::normalMapSlot);
+    uboFormat_.shininessMapHandle = getMapHandle(TextureMapSlot::shininessMapSlot);
+}
 
-        descriptorWrites.emplace_back(writeDescriptorSet);
-    }
+bool Material::refreshTextures() {
+    bindTextures();
+    updateUBO();
 
-   VkUtils::getDevice().updateDescriptorSets(descriptorWrites,{});
+    return std::ranges::all_of(textures_, [](const auto& texture) { return !texture || texture->isResident(); });
 }
 
 void Material::updateUBO() const {
-    Engine::getInstance().setMaterialUBOStorage(getCID(), uboFormat_);
-}
-
-void Material::updateUBONow() const {
-    for (const auto & materialUBO : Engine::getInstance().getMaterialUBOs()) {
-        uint8_t* dst = materialUBO + getCID() * sizeof(uboFormat_);
-        memcpy(dst,&uboFormat_,sizeof(uboFormat_));
-    }
+    Engine::getInstance().setMaterialData(getCID(), uboFormat_);
 }
 
 bool Material::drawGUI() {
@@ -96,14 +77,3 @@ bool Material::drawGUI() {
 
     return changed;
 }
-
-void Material::allocateDescriptorSet() {
-    vk::DescriptorSetAllocateInfo allocInfo{
-        .descriptorPool = Engine::getInstance().getDescriptorPool(),
-        .descriptorSetCount = 1,
-        .pSetLayouts = &*Engine::getInstance().getDescriptorSetLayoutMaterial(),
-    };
-
-    auto h = VkUtils::getDevice().allocateDescriptorSets(allocInfo);
-    descriptorSet_ = std::move(h.front());
-}
@@ -25,9 +25,7 @@ public:
         shininessMapSlot = 3,
     };
 
-    Material() : ManagedResource(){
-        allocateDescriptorSet();
-    }
+    Material() : ManagedResource() {}
 
 
     std::shared_ptr<Texture> getTexture(TextureMapSlot slot);
@@ -77,11 +75,22 @@ public:
 
     std::string getResourceType() const override { return "Material"; }
 
-    void recordDescriptorSet() const;
-    const vk::raii::DescriptorSet& getDescriptorSet() const {return descriptorSet_;}
-
+    /**
+     * @brief puts the textures that are resident by now into the engine's bindless texture array and points the
+     * map handles at them, maps of textures that aren't resident yet stay unset
+     */
+    void bindTextures();
+
+    /**
+     * @brief binds the textures and updates the material data once streamed textures become resident
+     * @return true if all textures are resident
+     */
+    bool refreshTextures();
+
+    /**
+     * @brief copies the material data to the engine's material buffer, frames pick it up before they are recorded
+     */
     void updateUBO() const;
-    void updateUBONow() const;
 
     bool drawGUI() override;
 
@@ -89,7 +98,6 @@ public:
     friend class MaterialManager;
 private:
 
-    void allocateDescriptorSet();
     // glm::vec3 diffuseAlbedo_{};
     // glm::vec3 specularAlbedo_{};
     // glm::vec3 emission_{};
@@ -109,8 +117,6 @@ private:
     //  2 - normal map
     //  3 - shininnes map]
     std::array<std::shared_ptr<Texture>,4> textures_{};
-
-    vk::raii::DescriptorSet descriptorSet_{nullptr};
 };
 
 
@@ -4,18 +4,40 @@
 
 #include "mesh.h"
 
+#include <algorithm>
+#include <cstring>
+
 #include <imgui/imgui.h>
 #include "../engine/engine.h"
+#include "../engine/profiler.h"
+
+Mesh::Mesh(std::vector<Vertex3D>&& vertexList, std::vector<uint32_t>&& indexList, std::shared_ptr<Material> material, std::vector<Meshlet>&& meshlets):
+    vertices_(std::move(vertexList)), indices_(std::move(indexList)), vertexView_(vertices_), indexView_(indices_), meshlets_(std::move(meshlets)),
+    material_(std::move(material)) {
+
+    computeBounds();
+    allocateGeometry();
+}
+
+Mesh::Mesh(std::span<const Vertex3D> vertexList, std::span<const uint32_t> indexList, std::shared_ptr<Material> material, std::span<const Meshlet> meshlets,
+           std::shared_ptr<const void> source):
+    vertexView_(vertexList), indexView_(indexList), source_(std::move(source)), meshlets_(meshlets.begin(), meshlets.end()), material_(std::move(material)) {
 
-Mesh::Mesh(std::vector<Vertex3D>&& vertexList, std::vector<uint32_t>&& indexList, std::shared_ptr<Material> material):
-    vertices_(std::move(vertexList)), indices_(std::move(indexList)), material_(std::move(material)) {
+    //  nothing keeps the spans alive past the constructor, the mesh needs copies of its own
+    if (source_ == nullptr) {
+        vertices_.assign(vertexList.begin(), vertexList.end());
+        indices_.assign(indexList.begin(), indexList.end());
+        vertexView_ = vertices_;
+        indexView_ = indices_;
+    }
 
-    initBuffers();
+    computeBounds();
+    allocateGeometry();
 }
 
 Mesh::~Mesh() {
-    VkUtils::destroyBufferVMA(std::move(vertexBuffer_));
-    VkUtils::destroyBufferVMA(std::move(indexBuffer_));
+    if (geometry_.isValid())
+        Engine::getInstance().getGeometryArena().free(geometry_);
 }
 
 bool Mesh::drawGUI() {
@@ -29,49 +51,122 @@ bool Mesh::drawGUI() {
     return false;
 }
 
-void Mesh::stage(const VkUtils::BufferAlloc& stagingBuffer) const {
+void Mesh::stage(UploadBatch& batch) const {
+    if (!geometry_.isValid() || vertexView_.empty())
+        return;
+
+    const GeometryArena& arena = Engine::getInstance().getGeometryArena();
 
-    if (stagingBuffer.allocationInfo.pMappedData == nullptr)
-        throw std::runtime_error("ERROR: Mapped pointer points to NULL!");
+    //  vertices are converted straight into staging memory, no packed copy is kept around
+    const vk::DeviceSize vertexDataSize = static_cast<vk::DeviceSize>(vertexView_.size()) * arena.getVertexStride();
+    StagingRing::Allocation vertexStaging = batch.allocate(vertexDataSize);
 
-    auto vertexBufferSize = sizeof(vertices_[0]) * vertices_.size();
-    auto indexBufferSize = sizeof(indices_[0]) * indices_.size();
+    if constexpr (Engine::vertexFormat == VertexFormat::packed) {
+        glm::vec3 extent = boundsMax_ - boundsMin_;
+        glm::vec3 invExtent{
+            extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+            extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+            extent.z > 0.0f ? 1.0f / extent.z : 0.0f
+        };
 
-    //  copy from vertices vector to staging buffer
-    memcpy(stagingBuffer.allocationInfo.pMappedData,vertices_.data(),vertexBufferSize);
+        auto* packed = reinterpret_cast<PackedVertex3D*>(vertexStaging.data);
+        for (size_t i = 0; i < vertexView_.size(); ++i)
+            packed[i] = PackedVertex3D::pack(vertexView_[i], boundsMin_, invExtent);
+    }
+    else
+        std::memcpy(vertexStaging.data, vertexView_.data(), vertexDataSize);
+
+    //  record right after allocating, the next allocation could submit the command buffer recorded so far
+    batch.getCommandBuffer().copyBuffer(vertexStaging.buffer->buffer, arena.getVertexBuffer(geometry_.block).buffer, vk::BufferCopy{
+        .srcOffset = vertexStaging.offset,
+        .dstOffset = arena.getVertexOffset(geometry_),
+        .size = vertexDataSize
+    });
+
+    const vk::DeviceSize indexDataSize = static_cast<vk::DeviceSize>(indexView_.size()) * GeometryArena::getIndexSize(geometry_.indexType);
+    StagingRing::Allocation indexStaging = batch.allocate(indexDataSize);
+
+    if (geometry_.indexType == vk::IndexType::eUint16)
+        std::ranges::transform(indexView_, reinterpret_cast<uint16_t*>(indexStaging.data), [](uint32_t index) { return static_cast<uint16_t>(index); });
+    else
+        std::memcpy(indexStaging.data, indexView_.data(), indexDataSize);
+
+    batch.getCommandBuffer().copyBuffer(indexStaging.buffer->buffer, arena.getIndexBuffer(geometry_.block).buffer, vk::BufferCopy{
+        .srcOffset = indexStaging.offset,
+        .dstOffset = GeometryArena::getIndexOffset(geometry_),
+        .size = indexDataSize
+    });
+
+    //  resolve by handle, the mesh could be freed before the upload finishes
+    if (releaseCpuDataOnUpload && isValid()) {
+        batch.onComplete([handle = getHandle()] {
+            if (Mesh* mesh = MeshManager::getInstance()->resolve(handle))
+                mesh->releaseCpuData();
+        });
+    }
+}
 
-    //  copy from staging buffer to vertex buffer
-    VkUtils::copyBuffer(stagingBuffer,vertexBuffer_,vertexBufferSize);
+void Mesh::releaseCpuData() {
+    if (bvh_.isEmpty())
+        buildBvh();
 
-    // copy from indices vector to staging buffer
-    memcpy(stagingBuffer.allocationInfo.pMappedData,indices_.data(), indexBufferSize);
+    vertices_ = {};
+    indices_ = {};
+    vertexView_ = {};
+    indexView_ = {};
 
-    // copy from staging buffer to indices buffer
-    VkUtils::copyBuffer(stagingBuffer,indexBuffer_,indexBufferSize);
+    //  borrowed geometry is only needed until it is uploaded, this unmaps the cache once no other mesh reads from it
+    source_.reset();
+}
+
+void Mesh::buildBvh() {
+    if (vertexView_.empty())
+        return;
+
+    Profiler::Scope scope{"Mesh::buildBvh"};
+
+    bvh_.build(vertexView_, indexView_);
 }
 
 void Mesh::recordDrawCommands(vk::raii::CommandBuffer& cmdBuf, const vk::raii::PipelineLayout& pipelineLayout) const {
-    cmdBuf.bindVertexBuffers(0,vertexBuffer_.buffer,{0});
-    cmdBuf.bindIndexBuffer(indexBuffer_.buffer,0,vk::IndexType::eUint32);
-    //  bind per mesh descriptor set
-    cmdBuf.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pipelineLayout, 1, *getMaterial()->getDescriptorSet(), nullptr);
+    if (!geometry_.isValid())
+        return;
 
+    //  the material is found through materialId, its textures are in the bindless set bound for the whole pass
     const PushConstants pcs = {
-        .modelMat = transform_.getModelMat(),
+        .modelMat = getDrawModelMat(),
         .normalMat = transform_.getNormalMat(),
         .materialId = material_->getCID(),
-        .meshId = getCID()
+        .meshId = getHandle().value
     };
 
     cmdBuf.pushConstants(pipelineLayout,vk::ShaderStageFlagBits::eVertex | vk::ShaderStageFlagBits::eFragment,0, vk::ArrayProxy<const PushConstants>{pcs});
 
-    cmdBuf.drawIndexed(indices_.size(), 1, 0, 0, 0);
+    cmdBuf.drawIndexed(geometry_.indexCount, 1, geometry_.firstIndex, static_cast<int32_t>(geometry_.firstVertex), 0);
 }
 
-void Mesh::initBuffers() {
-    vk::DeviceSize vertexBufferSize = sizeof(vertices_[0]) * vertices_.size();
-    vertexBuffer_ = VkUtils::createBufferVMA(vertexBufferSize,vk::BufferUsageFlagBits::eVertexBuffer | vk::BufferUsageFlagBits::eTransferDst);
+void Mesh::computeBounds() {
+    if (vertexView_.empty())
+        return;
+
+    boundsMin_ = boundsMax_ = vertexView_.front().position;
+    for (const auto& vertex : vertexView_) {
+        boundsMin_ = glm::min(boundsMin_, vertex.position);
+        boundsMax_ = glm::max(boundsMax_, vertex.position);
+    }
+
+    //  packed positions are in [0,1] across the bounds, scale and offset them back in the vertex shader
+    if constexpr (Engine::vertexFormat == VertexFormat::packed) {
+        glm::vec3 extent = boundsMax_ - boundsMin_;
+        vertexTransform_ = glm::mat4{1.0f};
+        vertexTransform_[0][0] = extent.x;
+        vertexTransform_[1][1] = extent.y;
+        vertexTransform_[2][2] = extent.z;
+        vertexTransform_[3] = glm::vec4{boundsMin_, 1.0f};
+    }
+}
 
-    vk::DeviceSize indexBufferSize = sizeof(indices_[0]) * indices_.size();
-    indexBuffer_ = VkUtils::createBufferVMA(indexBufferSize,vk::BufferUsageFlagBits::eIndexBuffer | vk::BufferUsageFlagBits::eTransferDst);
+void Mesh::allocateGeometry() {
+    auto vertexCount = static_cast<uint32_t>(vertexView_.size());
+    geometry_ = Engine::getInstance().getGeometryArena().allocate(vertexCount, static_cast<uint32_t>(indexView_.size()), GeometryArena::selectIndexType(vertexCount));
 }
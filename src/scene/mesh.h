@@ -3,48 +3,119 @@
 //
 
 #pragma once
+#include <memory>
+#include <span>
 #include <vector>
 
 
 #include "material.h"
 #include "transform.h"
 #include "Vertex.h"
+#include "../engine/aabb.h"
 #include "../engine/iDrawGui.h"
-#include "../engine/vk/vkUtils.h"
+#include "../engine/meshOptimizer.h"
+#include "../engine/triangleBvh.h"
+#include "../engine/vk/geometryArena.h"
+#include "../engine/vk/uploadBatch.h"
 
 
 class Mesh : public ManagedResource, public IDrawGui {
 public:
 
-    Mesh(std::vector<Vertex3D> &&vertexList, std::vector<uint32_t> &&indexList, std::shared_ptr<Material> material);
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+
+    Mesh(std::vector<Vertex3D> &&vertexList, std::vector<uint32_t> &&indexList, std::shared_ptr<Material> material, std::vector<Meshlet>&& meshlets = {});
+
+    /**
+     * @param source keeps the memory of the spans alive, e.g. a mapped mesh cache, the vertices and indices are then read
+     * from it directly until the CPU data is released, without it they are copied
+     */
+    Mesh(std::span<const Vertex3D> vertexList, std::span<const uint32_t> indexList, std::shared_ptr<Material> material, std::span<const Meshlet> meshlets = {},
+         std::shared_ptr<const void> source = nullptr);
 
     ~Mesh() override;
 
     bool drawGUI() override;
 
-    void stage(const VkUtils::BufferAlloc& stagingBuffer) const;
-
+    /**
+     * @brief converts the geometry to the engine's vertex format and index type right in staging memory and
+     * records its upload, does nothing once the CPU copies were released
+     */
+    void stage(UploadBatch& batch) const;
 
+    /**
+     * @brief records the draw of the mesh, the arena block of its geometry has to be bound already
+     */
     void recordDrawCommands(vk::raii::CommandBuffer& cmdBuf, const vk::raii::PipelineLayout& pipelineLayout) const;
 
-    [[nodiscard]] const std::vector<Vertex3D>& getVertices() const {return vertices_;}
-    [[nodiscard]] const std::vector<uint32_t >& getIndices() const { return indices_; }
+    /**
+     * @brief frees the CPU copies of the vertices and indices once they live on the GPU, builds the BVH first so ray casts keep working
+     */
+    void releaseCpuData();
+
+    /**
+     * @brief builds the triangle BVH ray casts are done with, from the CPU copies, does nothing once they were released
+     */
+    void buildBvh();
+
+    //  object space, empty until buildBvh() was called
+    [[nodiscard]] const TriangleBvh& getBvh() const { return bvh_; }
+
+    //  empty once releaseCpuData() was called
+    [[nodiscard]] std::span<const Vertex3D> getVertices() const { return vertexView_; }
+    [[nodiscard]] std::span<const uint32_t> getIndices() const { return indexView_; }
     [[nodiscard]] Transform& getTransform() { return transform_;}
+
+    //  ranges of the index buffer, kept when the CPU data is released
+    [[nodiscard]] const std::vector<Meshlet>& getMeshlets() const { return meshlets_; }
+
+    [[nodiscard]] const glm::vec3& getBoundsMin() const { return boundsMin_; }
+    [[nodiscard]] const glm::vec3& getBoundsMax() const { return boundsMax_; }
+
+    //  object space bounds transformed by the model matrix
+    [[nodiscard]] Aabb getWorldBounds() const { return Aabb{boundsMin_, boundsMax_}.transform(transform_.getModelMat()); }
+
+    /**
+     * @brief maps the vertex positions the GPU reads to object space, has to be applied before the model matrix
+     */
+    [[nodiscard]] const glm::mat4& getVertexTransform() const { return vertexTransform_; }
+    [[nodiscard]] glm::mat4 getDrawModelMat() const { return transform_.getModelMat() * vertexTransform_; }
+
     std::string getResourceType() const override { return "Mesh"; }
-    [[nodiscard]] const vk::Buffer & getVertexBuffer() const { return vertexBuffer_.buffer; }
-    [[nodiscard]] const vk::Buffer & getIndexBuffer() const { return indexBuffer_.buffer; }
-    std::shared_ptr<Material> getMaterial() const {return material_;}
+    [[nodiscard]] const GeometryArena::Allocation& getGeometry() const { return geometry_; }
+    [[nodiscard]] const std::shared_ptr<Material>& getMaterial() const {return material_;}
+
+    //  drop the CPU geometry as soon as an upload finishes, turn off to keep it around for CPU side queries
+    inline static bool releaseCpuDataOnUpload{false};
 
     friend class MeshManager;
 private:
-    void initBuffers();
+    void computeBounds();
+    void allocateGeometry();
 
+    //  owned geometry, empty when it is borrowed from source_
     std::vector<Vertex3D> vertices_{};
     std::vector<uint32_t> indices_{};
+
+    //  the geometry the mesh reads, either vertices_ and indices_ or memory kept alive by source_
+    std::span<const Vertex3D> vertexView_{};
+    std::span<const uint32_t> indexView_{};
+    std::shared_ptr<const void> source_{nullptr};
+
+    std::vector<Meshlet> meshlets_{};
     std::shared_ptr<Material> material_{nullptr};
 
-    VkUtils::BufferAlloc vertexBuffer_{};
-    VkUtils::BufferAlloc indexBuffer_{};
+    //  ranges of the engine's geometry arena the vertices and indices are uploaded to
+    GeometryArena::Allocation geometry_{};
+
+    TriangleBvh bvh_{};
+
+    glm::vec3 boundsMin_{0.0f};
+    glm::vec3 boundsMax_{0.0f};
+
+    //  dequantizes packed positions, identity for the full vertex format
+    glm::mat4 vertexTransform_{1.0f};
 
     Transform transform_{};
 
@@ -4,19 +4,105 @@
 
 #include "scene.h"
 
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <numeric>
+
 #include "../engine/engine.h"
+#include "../engine/jobSystem.h"
+#include "../engine/profiler.h"
 #include <imgui/imgui.h>
 
+Scene::~Scene() {
+    releaseBvh();
+}
+
+const std::vector<uint32_t>& Scene::cullMeshes(bool frustumCulling) {
+    refitBvh();
+
+    visibleMeshes_.clear();
+
+    if (!frustumCulling) {
+        visibleMeshes_.resize(meshes_.size());
+        std::iota(visibleMeshes_.begin(), visibleMeshes_.end(), 0u);
+        return visibleMeshes_;
+    }
+
+    bvh_.cull(Frustum{camera_->getViewProjMat()}, visibleMeshes_);
+    return visibleMeshes_;
+}
+
+std::optional<Scene::RayHit> Scene::castRay(const Ray& ray, float maxDistance) {
+    refitBvh();
+
+    rayCandidates_.clear();
+    bvh_.intersect(ray, maxDistance, rayCandidates_);
+
+    std::optional<RayHit> closestHit{};
+    for (uint32_t meshIndex : rayCandidates_) {
+        const std::shared_ptr<Mesh>& mesh = meshes_[meshIndex];
+
+        //  t is kept by the transform, the hit distance is the world space one
+        Ray objectRay = ray.transform(glm::inverse(mesh->getTransform().getModelMat()));
+
+        TriangleBvh::Hit hit{};
+        if (!mesh->getBvh().intersect(objectRay, maxDistance, hit))
+            continue;
+
+        maxDistance = hit.distance;
+        closestHit = RayHit{
+            .mesh = mesh,
+            .distance = hit.distance,
+            .position = ray.at(hit.distance),
+            .triangle = hit.triangle,
+            .barycentrics = {1.0f - hit.barycentrics.x - hit.barycentrics.y, hit.barycentrics.x, hit.barycentrics.y},
+            .texCoord = mesh->getBvh().getTexCoord(hit)
+        };
+    }
+
+    return closestHit;
+}
+
+void Scene::update(const Transform& transform) {
+    auto [first, last] = transformMeshes_.equal_range(&transform);
+    for (auto it = first; it != last; ++it) {
+        //  a transform dragged in the GUI changes many times a frame, refit once
+        if (!isMeshDirty_[it->second]) {
+            isMeshDirty_[it->second] = 1;
+            dirtyMeshes_.emplace_back(it->second);
+        }
+    }
+}
+
+
+void Scene::setSelectedObjects(std::span<const ResourceHandle> objects) {
+    selectedObjects_.clear();
+    for (ResourceHandle object : objects) {
+        if (auto mesh = MeshManager::getInstance()->getResource(object))
+            selectedObjects_.emplace_back(std::move(mesh));
+    }
+
+    selectedObject_ = selectedObjects_.empty() ? nullptr : selectedObjects_.front();
+}
 
 bool Scene::drawGUI() {
 
     if (ImGui::CollapsingHeader("Scene")) {
         ImGui::Indent();
+        auto bvhStats = bvh_.getStats();
+        ImGui::Text("Visible meshes: %u / %u", static_cast<uint32_t>(visibleMeshes_.size()), static_cast<uint32_t>(meshes_.size()));
+        ImGui::Text("BVH height: %u, area ratio: %.2f", bvhStats.height, bvhStats.areaRatio);
+
         ImGui::Text("Selected mesh: ");
         ImGui::SameLine();
 
         if (selectedObject_ != nullptr) {
             ImGui::Text(selectedObject_->getResourceName().c_str());
+            if (selectedObjects_.size() > 1) {
+                ImGui::SameLine();
+                ImGui::Text("(+%u more)", static_cast<uint32_t>(selectedObjects_.size() - 1));
+            }
             selectedObject_->drawGUI();
         }
 
@@ -28,9 +114,9 @@ bool Scene::drawGUI() {
 
 void Scene::initDescriptorSet() {
     if (sky_) {
-        VkUtils::BufferAlloc stagingBuffer = VkUtils::createBufferVMA(sky_->getTotalSize(),vk::BufferUsageFlagBits::eTransferSrc,VkUtils::stagingAllocFlagsVMA);
-        sky_->stage(stagingBuffer);
-        VkUtils::destroyBufferVMA(std::move(stagingBuffer));
+        UploadBatch batch{Engine::getInstance().getStagingRing()};
+        sky_->stage(batch);
+        batch.submitAndWait();
 
         vk::DescriptorSetAllocateInfo allocInfo{
             .descriptorPool = Engine::getInstance().getDescriptorPool(),
@@ -61,4 +147,76 @@ void Scene::initDescriptorSet() {
 void Scene::initDescriptorSetLayout() {
     skyDescriptorSetLayout_ = vk::raii::DescriptorSetLayout(VkUtils::getDevice(),skyLayoutInfo);
     isDescSetLayoutInitialized_ = true;
-}
\ No newline at end of file
+}
+
+void Scene::initBvh() {
+    Profiler::Scope scope{"Scene::initBvh"};
+
+    meshLeaves_.clear();
+    meshLeaves_.reserve(meshes_.size());
+
+    for (uint32_t i = 0; i < meshes_.size(); ++i) {
+        Transform& transform = meshes_[i]->getTransform();
+
+        if (!transformMeshes_.contains(&transform))
+            transform.attach(this);
+        transformMeshes_.emplace(&transform, i);
+
+        meshLeaves_.emplace_back(bvh_.insert(meshes_[i]->getWorldBounds(), i));
+    }
+
+    isMeshDirty_.assign(meshes_.size(), 0);
+
+    buildMeshBvhs();
+}
+
+void Scene::buildMeshBvhs() {
+    //  a mesh can be in the scene more than once, it must be built once only
+    std::vector<Mesh*> meshes{};
+    for (const auto& mesh : meshes_) {
+        if (mesh->getBvh().isEmpty() && !mesh->getVertices().empty())
+            meshes.emplace_back(mesh.get());
+    }
+
+    std::ranges::sort(meshes);
+    auto duplicates = std::ranges::unique(meshes);
+    meshes.erase(duplicates.begin(), duplicates.end());
+
+    if (meshes.empty())
+        return;
+
+    auto start = std::chrono::steady_clock::now();
+
+    //  meshes differ a lot in size, one per job balances best
+    JobSystem::getInstance().parallelFor(static_cast<uint32_t>(meshes.size()), 1, [&](uint32_t begin, uint32_t end) {
+        for (uint32_t i = begin; i < end; ++i)
+            meshes[i]->buildBvh();
+    });
+
+    auto buildTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "Built triangle BVHs of " << meshes.size() << " meshes in " << buildTime << " ms" << std::endl;
+}
+
+void Scene::releaseBvh() {
+    for (const auto& mesh : meshes_) {
+        Transform& transform = mesh->getTransform();
+        if (transformMeshes_.erase(&transform) > 0)
+            transform.detach(this);
+    }
+
+    bvh_.clear();
+    meshLeaves_.clear();
+    dirtyMeshes_.clear();
+    isMeshDirty_.clear();
+    visibleMeshes_.clear();
+}
+
+void Scene::refitBvh() {
+    //  leaves only move in the tree once the mesh leaves its enlarged bounds
+    for (uint32_t meshIndex : dirtyMeshes_) {
+        bvh_.update(meshLeaves_[meshIndex], meshes_[meshIndex]->getWorldBounds());
+        isMeshDirty_[meshIndex] = 0;
+    }
+
+    dirtyMeshes_.clear();
+}
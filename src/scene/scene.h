@@ -4,13 +4,20 @@
 
 #pragma once
 
+#include <limits>
+#include <optional>
+#include <span>
+#include <unordered_map>
 #include <vector>
 #include "mesh.h"
 #include "camera.h"
+#include "../engine/dynamicBvh.h"
 #include "../engine/iDrawGui.h"
+#include "../engine/ray.h"
+#include "../engine/observer.h"
 #include "../engine/managers/resourceManager.h"
 
-class Scene : public IDrawGui {
+class Scene : public IDrawGui, public Observer<const Transform&> {
 public:
 
     explicit Scene(const std::vector<std::shared_ptr<Mesh>>&& meshes, std::shared_ptr<Camera> camera, std::shared_ptr<Texture> sky = {nullptr})
@@ -19,21 +26,70 @@ public:
         if (!isDescSetLayoutInitialized_)
             initDescriptorSetLayout();
         initDescriptorSet();
+        initBvh();
 
         if (!meshes_.empty())
-            selectedObject_ = meshes_[0];
+            setSelectedObject(meshes_[0]);
     }
 
+    ~Scene() override;
+
+    Scene(const Scene&) = delete;
+    Scene& operator=(const Scene&) = delete;
+
     [[nodiscard]] Camera& getCamera() const { return *camera_; }
     void setCamera(std::shared_ptr<Camera> camera) { std::swap(camera_, camera);}
 
     [[nodiscard]] const std::vector<std::shared_ptr<Mesh>>& getMeshes() const { return meshes_; }
-    void setMeshes(std::vector<std::shared_ptr<Mesh>> models) { meshes_ = std::move(models); }
+    void setMeshes(std::vector<std::shared_ptr<Mesh>> models) {
+        releaseBvh();
+        meshes_ = std::move(models);
+        initBvh();
+    }
+
+    /**
+     * @brief refits the BVH for the meshes that moved since the last call
+     * @param frustumCulling if false every mesh is returned
+     * @return indices into getMeshes() of the meshes overlapping the camera's frustum, in no particular order
+     */
+    const std::vector<uint32_t>& cullMeshes(bool frustumCulling = true);
+
+    [[nodiscard]] const DynamicBvh& getBvh() const { return bvh_; }
+
+    struct RayHit {
+        std::shared_ptr<Mesh> mesh{};
+        float distance{0.0f};
+        glm::vec3 position{0.0f};
+
+        //  index of the mesh's triangle and the weights of its three vertices
+        uint32_t triangle{0};
+        glm::vec3 barycentrics{0.0f};
+        glm::vec2 texCoord{0.0f};
+    };
+
+    /**
+     * @brief finds the closest mesh triangle hit by a world space ray, meshes without a triangle BVH are skipped
+     * @param maxDistance in multiples of the ray's direction
+     */
+    std::optional<RayHit> castRay(const Ray& ray, float maxDistance = std::numeric_limits<float>::infinity());
+
+    //  marks the meshes using the transform for the next refit
+    void update(const Transform& transform) override;
 
     bool drawGUI() override;
 
-    void setSelectedObject(uint32_t objectCId) { selectedObject_ = MeshManager::getInstance()->getResource(objectCId); }
-    void setSelectedObject(std::shared_ptr<Mesh> object) { selectedObject_ = std::move(object);}
+    void setSelectedObject(ResourceHandle object) { setSelectedObjects(std::span{&object, 1}); }
+    void setSelectedObject(std::shared_ptr<Mesh> object) {
+        selectedObjects_.clear();
+        if (object)
+            selectedObjects_.emplace_back(object);
+        selectedObject_ = std::move(object);
+    }
+
+    /**
+     * @brief selects every mesh that is still alive, the first one is shown in the GUI
+     */
+    void setSelectedObjects(std::span<const ResourceHandle> objects);
 
     void setSky(std::shared_ptr<Texture> newSky) {
         sky_ = std::move(newSky);
@@ -49,11 +105,29 @@ private:
 
     void initDescriptorSet();
 
+    void initBvh();
+    void buildMeshBvhs();
+    void releaseBvh();
+    void refitBvh();
+
     std::vector<std::shared_ptr<Mesh>> meshes_{};
     std::shared_ptr<Camera> camera_{};
     std::shared_ptr<Texture> sky_{};
 
     std::shared_ptr<Mesh> selectedObject_{};
+    std::vector<std::shared_ptr<Mesh>> selectedObjects_{};
+
+    //  world space bounds of all meshes, leaf IDs are indexed like meshes_
+    DynamicBvh bvh_{};
+    std::vector<uint32_t> meshLeaves_{};
+
+    //  a mesh can be in the scene more than once, all of its leaves are refit when its transform changes
+    std::unordered_multimap<const Transform*, uint32_t> transformMeshes_{};
+    std::vector<uint32_t> dirtyMeshes_{};
+    std::vector<uint8_t> isMeshDirty_{};
+
+    std::vector<uint32_t> visibleMeshes_{};
+    std::vector<uint32_t> rayCandidates_{};
 
     vk::raii::DescriptorSet skyDescriptorSet_{nullptr};
 
@@ -3,10 +3,17 @@
 //
 
 #include "texture.h"
+#include <array>
+#include <filesystem>
 #include <iostream>
+#include <mutex>
+#include <utility>
 
 #include "Vertex.h"
 #include "../engine/engine.h"
+#include "../engine/ktxFile.h"
+#include "../engine/pixelConversion.h"
+#include "../engine/profiler.h"
 #include "../engine/utils.h"
 #include "../engine/managers/resourceManager.h"
 
@@ -15,11 +22,13 @@ std::shared_ptr<Texture> Texture::createDummy(std::string_view name,  const glm:
     vk::ImageUsageFlags usageFlags = vk::ImageUsageFlagBits::eTransferDst | vk::ImageUsageFlagBits::eSampled;
     auto dummy = TextureManager::getInstance()->registerResource(name,1,1,4,vk::Format::eB8G8R8A8Unorm, usageFlags);
 
-    memcpy(dummy->data_.data(),&color[0],sizeof(color));
+    dummy->data_.assign(&color[0], &color[0] + sizeof(color));
+    dummy->uploadSize_ = dummy->data_.size();
+    dummy->setCpuDataSize(dummy->data_.size());
 
-    VkUtils::BufferAlloc stagingBuffer = VkUtils::createBufferVMA(dummy->getTotalSize(),vk::BufferUsageFlagBits::eTransferSrc,VkUtils::stagingAllocFlagsVMA);
-    dummy->stage(stagingBuffer);
-    VkUtils::destroyBufferVMA(std::move(stagingBuffer));
+    UploadBatch batch{Engine::getInstance().getStagingRing()};
+    dummy->stage(batch);
+    batch.submitAndWait();
 
     return dummy;
 }
@@ -29,8 +38,9 @@ Texture::Texture(uint32_t width, uint32_t height, uint32_t channels, vk::Format
     ManagedResource(), width_(width), height_(height), channelCount_(channels), vkFormat_(format), imageUsageFlags_(imageUsage)
 {
     pixelSize_ = channelCount_;
-    data_.reserve(width_ * height_ * channelCount_);
-    data_.resize(width_ * height_ * channelCount_,0);
+    scanWidth_ = width_ * pixelSize_;
+
+    //  render targets never go through the CPU, createDummy fills data_ for the textures that do
     initVkImage();
 
 }
@@ -44,7 +54,7 @@ void Texture::initVkImage() {
             .height = height_,
             .depth = 1
         },
-        .mipLevels = 1,
+        .mipLevels = getMipLevelCount(),
         .arrayLayers = 1,
         .samples = vk::SampleCountFlagBits::e1,
         .tiling = vk::ImageTiling::eOptimal,
@@ -52,6 +62,14 @@ void Texture::initVkImage() {
         .sharingMode = vk::SharingMode::eExclusive
     };
 
+    //  textures from disk can be uploaded on the transfer queue, sharing them avoids queue family ownership transfers
+    std::array queueFamilies{VkUtils::getQueueFamilyIndex(VkUtils::QueueType::graphics), VkUtils::getQueueFamilyIndex(VkUtils::QueueType::transfer)};
+    if (isFromDisk_ && queueFamilies[0] != queueFamilies[1]) {
+        imageInfo.sharingMode = vk::SharingMode::eConcurrent;
+        imageInfo.queueFamilyIndexCount = static_cast<uint32_t>(queueFamilies.size());
+        imageInfo.pQueueFamilyIndices = queueFamilies.data();
+    }
+
 
     imageAlloc_ = VkUtils::createImageVMA(imageInfo);
 
@@ -73,7 +91,7 @@ void Texture::initVkImage() {
         .subresourceRange = vk::ImageSubresourceRange{
             .aspectMask = aspectFlags,
             .baseMipLevel = 0,
-            .levelCount = 1,
+            .levelCount = getMipLevelCount(),
             .baseArrayLayer = 0,
             .layerCount = 1
         },
@@ -96,7 +114,7 @@ void Texture::initVkImage() {
         .compareEnable = vk::False,
         .compareOp =   vk::CompareOp::eAlways,
         .minLod = 0.0f,
-        .maxLod = 0.0f,
+        .maxLod = static_cast<float>(getMipLevelCount()),
         .borderColor = vk::BorderColor::eIntOpaqueBlack,
         .unnormalizedCoordinates = vk::False
     };
@@ -105,16 +123,33 @@ void Texture::initVkImage() {
 }
 
 
-Texture::Texture(std::string_view fileName, bool isSrgb) : ManagedResource() {
-    //TODO: initialize only once
-    FreeImage_Initialise();
+void Texture::initFreeImage() {
+    //  FreeImage's plugin registry is global, initialize it once so that textures can be decoded from several threads
+    static std::once_flag freeImageInitFlag{};
+    std::call_once(freeImageInitFlag, [] { FreeImage_Initialise(); });
+}
 
+Texture::Texture(std::string_view fileName, bool isSrgb, bool deferDecode) : ManagedResource(), isSrgb_(isSrgb) {
     std::string correctFileName{fileName};
 
     auto extensionSeparator = correctFileName.find_last_of('.');
     fileName_ = correctFileName.substr(0,extensionSeparator);
     extension_ = correctFileName.substr(extensionSeparator, correctFileName.size() - extensionSeparator);
 
+    if (!deferDecode)
+        decode();
+}
+
+void Texture::decode() {
+    Profiler::Scope scope{"Texture::decode"};
+
+    if (useCookedTextures && loadCooked(fileName_ + ".ktx2"))
+        return;
+
+    initFreeImage();
+
+    std::string correctFileName{getFullFileName()};
+
     FREE_IMAGE_FORMAT fif = FreeImage_GetFileType(correctFileName.c_str(), 0);
     if (fif == FIF_UNKNOWN)
         fif = FreeImage_GetFIFFromFilename(correctFileName.c_str());
@@ -125,8 +160,14 @@ Texture::Texture(std::string_view fileName, bool isSrgb) : ManagedResource() {
 
         if (fif == FIF_JPEG) {
             FIBITMAP* tempBitmap = FreeImage_Load(fif,correctFileName.c_str());
-            bitmap = FreeImage_ConvertTo32Bits(tempBitmap);
-            FreeImage_Unload(tempBitmap);
+
+            //  24 bit pixels are expanded while copying the rows out, no 32 bit copy of the bitmap is needed
+            if (tempBitmap != nullptr && FreeImage_GetImageType(tempBitmap) == FIT_BITMAP && FreeImage_GetBPP(tempBitmap) == 24)
+                bitmap = tempBitmap;
+            else {
+                bitmap = FreeImage_ConvertTo32Bits(tempBitmap);
+                FreeImage_Unload(tempBitmap);
+            }
         }
         if (fif == FIF_EXR || fif == FIF_HDR) {
             FIBITMAP* tempBitmap = FreeImage_Load(fif,correctFileName.c_str());
@@ -146,28 +187,72 @@ Texture::Texture(std::string_view fileName, bool isSrgb) : ManagedResource() {
             freeImageType_ = FreeImage_GetImageType(bitmap);
 
             if (bits != nullptr && width_ != 0 && height_ != 0) {
-                pixelSize_ = FreeImage_GetBPP(bitmap) / 8;
-                scanWidth_ = FreeImage_GetPitch(bitmap);
-                channelCount_ = getChannelCount(freeImageType_,FreeImage_GetBPP(bitmap));
-
-                data_.reserve(scanWidth_ * height_);
-                data_.resize(scanWidth_ * height_,0);
-                
-                FreeImage_ConvertToRawBits(data_.data(),bitmap,scanWidth_,pixelSize_ * 8, FI_RGBA_RED_MASK, FI_RGBA_GREEN_MASK, FI_RGBA_BLUE_MASK, FALSE);
+                //  3 channel formats are rarely sampleable, 24 bit rows are expanded to BGRA when written to staging memory
+                bool isExpanded = freeImageType_ == FIT_BITMAP && FreeImage_GetBPP(bitmap) == 24;
+
+                pixelSize_ = isExpanded ? 4 : FreeImage_GetBPP(bitmap) / 8;
+                scanWidth_ = width_ * pixelSize_;
+                channelCount_ = isExpanded ? 4 : getChannelCount(freeImageType_,FreeImage_GetBPP(bitmap));
+
+                //  the bitmap is the only copy of the pixels until the upload
+                bitmap_ = std::exchange(bitmap, nullptr);
+                uploadSize_ = static_cast<vk::DeviceSize>(scanWidth_) * height_;
+                setCpuDataSize(static_cast<size_t>(FreeImage_GetPitch(bitmap_)) * height_);
                 isFromDisk_ = true;
 
                 imageUsageFlags_ = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
 
-                vkFormat_ = chooseVkFormat(isSrgb);
+                vkFormat_ = chooseVkFormat(isSrgb_);
                 initVkImage();
             }
         }
         FreeImage_Unload(bitmap);
     }
     else
-        throw std::runtime_error("ERROR! Failed to load texture " + std::string{fileName});
+        throw std::runtime_error("ERROR! Failed to load texture " + correctFileName);
+}
+
+bool Texture::loadCooked(const std::string& cookedFileName) {
+    if (!std::filesystem::exists(cookedFileName))
+        return false;
+
+    if (!Engine::getInstance().isTextureCompressionBCSupported()) {
+        std::cerr << "WARNING: BC textures aren't supported, decoding " << getFullFileName() << " instead of " << cookedFileName << std::endl;
+        return false;
+    }
+
+    auto ktx = KtxFile::open(cookedFileName);
+    if (!ktx)
+        return false;
+
+    //  an edited source wins over the cooked file until dp_texcook runs again
+    if (!ktx->isCookedFrom(getFullFileName())) {
+        std::cerr << "WARNING: " << cookedFileName << " wasn't cooked from the current " << getFullFileName() << ", decoding the source instead (run dp_texcook)" << std::endl;
+        return false;
+    }
+
+    width_ = ktx->getWidth();
+    height_ = ktx->getHeight();
+    vkFormat_ = static_cast<vk::Format>(ktx->getVkFormat());
+
+    //  levels are packed back to back in the upload, block sized offsets keep every copy aligned to the texel block
+    mipLevels_.clear();
+    uploadSize_ = 0;
+    for (uint32_t i = 0; i < ktx->getLevelCount(); ++i) {
+        auto level = ktx->getLevel(i);
+        vk::DeviceSize offset = (uploadSize_ + 15) & ~static_cast<vk::DeviceSize>(15);
+
+        uploadSize_ = offset + level.data.size();
+        mipLevels_.emplace_back(MipLevel{.offset = offset, .width = level.width, .height = level.height});
+    }
+
+    //  the levels are read straight from the mapping, nothing is copied until the upload
+    cookedFile_ = std::make_unique<KtxFile>(std::move(*ktx));
+    isFromDisk_ = true;
+    imageUsageFlags_ = vk::ImageUsageFlagBits::eSampled | vk::ImageUsageFlagBits::eTransferDst;
 
-    FreeImage_DeInitialise();
+    initVkImage();
+    return true;
 }
 
 std::string Texture::getResourceType() const {
@@ -175,36 +260,57 @@ std::string Texture::getResourceType() const {
 }
 
 void Texture::expand() {
-    #pragma omp parallel for collapse(2)
-    for (int x = 0; x < static_cast<int>(width_) ; ++x) {
-        for (int y = 0; y < static_cast<int>(height_) ; ++y) {
-
-            const uint32_t offset_pixel = y * scanWidth_ + x * pixelSize_;
+    //  block compressed texels can't be expanded one by one, the cooker filters in linear space already
+    if (!mipLevels_.empty())
+        return;
+
+    //  only 8 bit formats are gamma encoded
+    if (freeImageType_ != FIT_BITMAP)
+        return;
+
+    //  rows are contiguous, walk them in memory order, alpha is stored linearly and stays as is
+    if (bitmap_ != nullptr) {
+        uint32_t bitmapPixelSize = FreeImage_GetBPP(bitmap_) / 8;
+
+        #pragma omp parallel for
+        for (int y = 0; y < static_cast<int>(height_); ++y)
+            PixelConversion::srgbToLinear(FreeImage_GetScanLine(bitmap_, y), width_, bitmapPixelSize, bitmapPixelSize == 4);
+        return;
+    }
 
-            for (uint32_t c = 0; c < pixelSize_; ++c){
-                const uint32_t total_offset = offset_pixel + c;
+    #pragma omp parallel for
+    for (int y = 0; y < static_cast<int>(height_); ++y)
+        PixelConversion::srgbToLinear(data_.data() + y * scanWidth_, width_, pixelSize_, channelCount_ == 4);
+}
 
-                const uint8_t pixel_b = data_[total_offset];
-                float pixel_f = static_cast<float>(pixel_b) / 255.0f;
+void Texture::stage(UploadBatch& batch) {
+    auto allocation = batch.allocate(getUploadSize());
+    recordUpload(*allocation.buffer, allocation.offset, vk::PipelineStageFlagBits2::eFragmentShader, batch.getCommandBuffer());
 
-                pixel_f = Utils::expand(pixel_f);
+    auto onUploaded = [](Texture& texture) {
+        if (releaseCpuDataOnUpload)
+            texture.releaseCpuData();
+        texture.markResident();
+    };
 
-                data_[total_offset] = static_cast<uint8_t>(pixel_f * 255.0f);
-            }
-        }
+    //  resolve by handle, the texture could be freed before the upload finishes
+    if (isValid()) {
+        batch.onComplete([handle = getHandle(), onUploaded] {
+            if (Texture* texture = TextureManager::getInstance()->resolve(handle))
+                onUploaded(*texture);
+        });
     }
+    else
+        batch.onComplete([this, onUploaded] { onUploaded(*this); });
 }
 
-void Texture::stage(const VkUtils::BufferAlloc& stagingBuffer) const {
+void Texture::recordUpload(const VkUtils::BufferAlloc& stagingBuffer, vk::DeviceSize offset, vk::PipelineStageFlags2 dstStageMask, vk::raii::CommandBuffer& cmdBuf) const {
 
     if (stagingBuffer.allocationInfo.pMappedData == nullptr)
         throw std::runtime_error("ERROR: Mapped pointer points to NULL!");
 
-    size_t imageSize = width_ * height_ * pixelSize_;
-
-    memcpy(stagingBuffer.allocationInfo.pMappedData,data_.data(),imageSize);
+    writePixels(static_cast<uint8_t*>(stagingBuffer.allocationInfo.pMappedData) + offset);
 
-    auto cmdBuf = VkUtils::beginSingleTimeCommand();
     VkUtils::transitionImageLayout(
         imageAlloc_.image,
         vk::ImageLayout::eUndefined,
@@ -214,24 +320,76 @@ void Texture::stage(const VkUtils::BufferAlloc& stagingBuffer) const {
         vk::PipelineStageFlagBits2::eTransfer,
         vk::AccessFlagBits2::eTransferWrite,
         vk::ImageAspectFlagBits::eColor,
-        cmdBuf
+        cmdBuf,
+        getMipLevelCount()
     );
 
-    VkUtils::copyBufferToImage(stagingBuffer,imageAlloc_,width_,height_, cmdBuf);
+    if (mipLevels_.empty())
+        VkUtils::copyBufferToImage(stagingBuffer,imageAlloc_,width_,height_, cmdBuf, offset);
 
+    for (uint32_t i = 0; i < mipLevels_.size(); ++i)
+        VkUtils::copyBufferToImage(stagingBuffer,imageAlloc_,mipLevels_[i].width,mipLevels_[i].height, cmdBuf, offset + mipLevels_[i].offset, i);
+
+    //  without a sampling stage (transfer queue) visibility is provided by the semaphore the sampling submission waits on
     VkUtils::transitionImageLayout(
        imageAlloc_.image,
        vk::ImageLayout::eTransferDstOptimal,
        vk::ImageLayout::eShaderReadOnlyOptimal,
        vk::PipelineStageFlagBits2::eTransfer,
        vk::AccessFlagBits2::eTransferWrite,
-       vk::PipelineStageFlagBits2::eFragmentShader,
-       vk::AccessFlagBits2::eShaderRead,
+       dstStageMask,
+       dstStageMask == vk::PipelineStageFlagBits2::eNone ? vk::AccessFlagBits2::eNone : vk::AccessFlagBits2::eShaderRead,
        vk::ImageAspectFlagBits::eColor,
-       cmdBuf
+       cmdBuf,
+       getMipLevelCount()
    );
+}
+
+void Texture::writePixels(uint8_t* dst) const {
+    //  cooked textures upload all of their levels
+    if (cookedFile_) {
+        for (uint32_t i = 0; i < mipLevels_.size(); ++i) {
+            auto level = cookedFile_->getLevel(i);
+            memcpy(dst + mipLevels_[i].offset, level.data.data(), level.data.size());
+        }
+        return;
+    }
 
-    VkUtils::endSingleTimeCommand(cmdBuf,VkUtils::QueueType::graphics);
+    if (bitmap_ == nullptr) {
+        memcpy(dst, data_.data(), std::min<size_t>(data_.size(), uploadSize_));
+        return;
+    }
+
+    //  FreeImage pads rows to 4 bytes, the upload is tightly packed, rows keep FreeImage's bottom up order
+    bool isExpanded = FreeImage_GetBPP(bitmap_) == 24 && pixelSize_ == 4;
+
+    for (uint32_t y = 0; y < height_; ++y) {
+        const uint8_t* scanLine = FreeImage_GetScanLine(bitmap_, static_cast<int>(y));
+        uint8_t* row = dst + static_cast<size_t>(y) * scanWidth_;
+
+        if (isExpanded)
+            PixelConversion::expandRGBToRGBA(scanLine, row, width_);
+        else
+            memcpy(row, scanLine, scanWidth_);
+    }
+}
+
+void Texture::releaseCpuData() {
+    data_.clear();
+    data_.shrink_to_fit();
+
+    if (bitmap_ != nullptr) {
+        FreeImage_Unload(bitmap_);
+        bitmap_ = nullptr;
+    }
+    cookedFile_.reset();
+
+    setCpuDataSize(0);
+}
+
+void Texture::setCpuDataSize(size_t size) {
+    totalCpuDataSize_.fetch_add(size - cpuDataSize_, std::memory_order_relaxed);
+    cpuDataSize_ = size;
 }
 
 
@@ -284,5 +442,9 @@ int Texture::getChannelCount(FREE_IMAGE_TYPE type, uint32_t bpp) {
 
 
 Texture::~Texture() {
+    if (bindlessSlot_ != BindlessTextures::invalidIndex)
+        Engine::getInstance().getBindlessTextures().release(*this);
+
+    releaseCpuData();
     VkUtils::destroyImageVMA(std::move(imageAlloc_));
 }
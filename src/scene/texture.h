@@ -6,13 +6,19 @@
 #include <vulkan/vulkan_raii.hpp>
 #include <FreeImage.h>
 
+#include <algorithm>
+#include <atomic>
+#include <memory>
 #include <string>
 #include <glm/detail/type_vec4.hpp>
 
 #include "camera.h"
 #include "../engine/vk/vkUtils.h"
+#include "../engine/vk/uploadBatch.h"
 #include "../engine/managers/managedResource.h"
 
+class KtxFile;
+
 class Texture : public ManagedResource{
 public:
 
@@ -23,7 +29,10 @@ public:
     Texture(Texture&&) = delete;
     Texture& operator=(Texture&&) = delete;
 
-    explicit Texture(std::string_view fileName, bool isSrgb);
+    /**
+     * @param deferDecode only remember the file, decode() is called later by the texture streamer
+     */
+    explicit Texture(std::string_view fileName, bool isSrgb, bool deferDecode = false);
     Texture(uint32_t width, uint32_t height, uint32_t channels, vk::Format format, vk::ImageUsageFlags imageUsage);
 
 
@@ -31,6 +40,19 @@ public:
 
     void expand();
 
+    /**
+     * @brief loads the file passed to the constructor and creates the image, safe to call from worker threads
+     *
+     * A cooked <name>.ktx2 next to the file is preferred, its block compressed mip chain is uploaded as is.
+     * Pixels stay in the decoder's bitmap or the mapped file and are converted while being written to staging memory.
+     */
+    void decode();
+
+    /**
+     * @brief true once the image contents are uploaded and it can be sampled
+     */
+    [[nodiscard]] bool isResident() const { return isResident_.load(std::memory_order_acquire); }
+
     [[nodiscard]] std::string getResourceType() const override;
 
     [[nodiscard]] const vk::raii::ImageView & getVkImageView() const { return vkImageView_; }
@@ -39,18 +61,70 @@ public:
 
     [[nodiscard]] uint32_t getWidth() const { return width_; }
     [[nodiscard]] uint32_t getHeight() const { return height_; }
+    [[nodiscard]] uint32_t getMipLevelCount() const { return std::max(static_cast<uint32_t>(mipLevels_.size()), 1u); }
 
     friend class TextureManager;
+    friend class TextureStreamer;
+    friend class BindlessTextures;
 
     static std::shared_ptr<Texture> createDummy(std::string_view name,  const glm::vec<4, uint8_t>& color = {255, 0, 255, 255});
 
-    uint32_t getTotalSize() const {return data_.size() * sizeof(data_[0]);}
-    void stage(const VkUtils::BufferAlloc& stagingBuffer) const;
+    /**
+     * @return bytes the pixels take in staging memory, 0 if there is nothing to upload
+     */
+    [[nodiscard]] vk::DeviceSize getUploadSize() const { return uploadSize_; }
+    /**
+     * @brief records the upload into the batch, the texture becomes resident once the batch finishes
+     */
+    void stage(UploadBatch& batch);
+
+    /**
+     * @brief writes the pixels to stagingBuffer at offset and records their upload, the texture becomes resident once it executes
+     * @param dstStageMask stages that will sample the image, has to be supported by the queue the command buffer is submitted to
+     */
+    void recordUpload(const VkUtils::BufferAlloc& stagingBuffer, vk::DeviceSize offset, vk::PipelineStageFlags2 dstStageMask, vk::raii::CommandBuffer& cmdBuf) const;
+
+    void markResident() { isResident_.store(true, std::memory_order_release); }
+
+    /**
+     * @brief frees the decoded pixels once they live on the GPU
+     */
+    void releaseCpuData();
+
+    /**
+     * @return bytes of decoded pixels held in RAM by all textures
+     */
+    [[nodiscard]] static size_t getTotalCpuDataSize() { return totalCpuDataSize_.load(std::memory_order_relaxed); }
+
+    inline static bool useCookedTextures{true};
+
+    //  drop the decoded pixels as soon as an upload finishes, turn off to keep them around for expand() or readback
+    inline static bool releaseCpuDataOnUpload{true};
+
+    //  safe to call from any thread and any number of times, everything using FreeImage calls it first
+    static void initFreeImage();
 
 private:
+    struct MipLevel {
+        vk::DeviceSize offset{};
+        uint32_t width{};
+        uint32_t height{};
+    };
 
     void initVkImage();
 
+    /**
+     * @brief writes the upload layout of the pixels to dst, getUploadSize() bytes
+     */
+    void writePixels(uint8_t* dst) const;
+
+    void setCpuDataSize(size_t size);
+
+    /**
+     * @return false if there is no usable cooked file, the source is decoded instead
+     */
+    bool loadCooked(const std::string& cookedFileName);
+
     vk::Format chooseVkFormat(bool isSrgb) const;
 
     static int getChannelCount(FREE_IMAGE_TYPE type, uint32_t bpp);
@@ -61,8 +135,23 @@ private:
     uint32_t pixelSize_{};
     uint32_t scanWidth_{};
 
+    //  pixels of textures created in code, textures from disk keep theirs in bitmap_ or cookedFile_
     std::vector<uint8_t> data_;
 
+    //  decoded image, rows are converted to the upload layout while being written to staging memory
+    FIBITMAP* bitmap_{nullptr};
+
+    //  mapped cooked file, its levels are copied to staging memory as they are
+    std::unique_ptr<KtxFile> cookedFile_{};
+
+    //  offsets of the levels in the upload, only cooked textures have any
+    std::vector<MipLevel> mipLevels_{};
+
+    vk::DeviceSize uploadSize_{0};
+    size_t cpuDataSize_{0};
+
+    inline static std::atomic<size_t> totalCpuDataSize_{0};
+
     FREE_IMAGE_FORMAT freeImageFormat_{};
     FREE_IMAGE_TYPE freeImageType_{};
     vk::Format vkFormat_;
@@ -73,4 +162,11 @@ private:
     vk::raii::Sampler  vkSampler_{nullptr};
 
     vk::ImageUsageFlags imageUsageFlags_{};
+
+    bool isSrgb_{false};
+    std::atomic<bool> isResident_{false};
+    std::atomic<bool> isStreamScheduled_{false};
+
+    //  slot in the bindless texture array, only touched by BindlessTextures under its lock
+    uint32_t bindlessSlot_{~0u};
 };
\ No newline at end of file
@@ -47,6 +47,8 @@ void Transform::applyTransform() {
 
     modelMat_ = translation * rotation * scale;
     normalMat_ = glm::transpose(glm::inverse(glm::mat3(modelMat_)));
+
+    notify(*this);
 }
 
 const glm::mat4 &Transform::getModelMat() const {
@@ -6,8 +6,12 @@
 #include <glm/glm.hpp>
 
 #include "../engine/iDrawGui.h"
+#include "../engine/observer.h"
 
-class Transform : public IDrawGui {
+/**
+ * @brief notifies its observers whenever the model matrix changes
+ */
+class Transform : public IDrawGui, public Subject<const Transform&> {
 public:
 
     void translate(const glm::vec3& translation);
@@ -0,0 +1,59 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "benchFixtures.h"
+
+#include "../../engine/engine.h"
+
+void BenchScene::initEngine() {
+    if (isEngineInitialized_)
+        return;
+
+    Engine::getInstance().init();
+    isEngineInitialized_ = true;
+}
+
+Scene& BenchScene::get(const SceneGenerator::Params& params) {
+    initEngine();
+    Engine& engine = Engine::getInstance();
+
+    if (scene_ && params_ == params)
+        return *scene_;
+
+    //  rendering benchmarks end with the device idle, nothing in flight references the old scene's meshes
+    engine.setScene(nullptr);
+    scene_.reset();
+
+    scene_ = SceneGenerator{params}.generateScene();
+    params_ = params;
+    engine.setScene(scene_);
+
+    return *scene_;
+}
+
+SceneGenerator::Params BenchScene::getInstanceParams(int64_t instanceCount) {
+    return {.instanceCount = static_cast<uint32_t>(instanceCount), .subdivisions = instanceCount >= coarseInstanceCount ? 2u : 8u};
+}
+
+const std::vector<std::shared_ptr<Material>>& BenchScene::getMaterials(uint32_t count) {
+    auto [entry, isNew] = materials_.try_emplace(count);
+    if (isNew)
+        entry->second = SceneGenerator{{.materialCount = count}}.generateMaterials();
+
+    return entry->second;
+}
+
+void BenchScene::release() {
+    materials_.clear();
+
+    if (!isEngineInitialized_)
+        return;
+
+    Engine::getInstance().setScene(nullptr);
+    scene_.reset();
+    params_.reset();
+
+    Engine::getInstance().cleanup();
+    isEngineInitialized_ = false;
+}
@@ -0,0 +1,80 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <optional>
+#include <vector>
+
+#include "sceneGenerator.h"
+#include "../../engine/jobSystem.h"
+
+/**
+ * @brief the headless engine and the generated scene shared by all benchmarks that need a device
+ *
+ * Generating and uploading a scene takes far longer than measuring it, so it is kept until a benchmark asks for
+ * different parameters.
+ */
+class BenchScene {
+public:
+    /**
+     * @brief initializes the engine on first use and makes a scene with the parameters the engine's scene
+     */
+    static Scene& get(const SceneGenerator::Params& params);
+
+    /**
+     * @brief the default scene with the given number of instances
+     *
+     * Culling and recording cost per instance rather than per triangle, scenes of 100k instances and more use
+     * coarse spheres so that their CPU and GPU copies of the geometry fit into memory.
+     */
+    static SceneGenerator::Params getInstanceParams(int64_t instanceCount);
+
+    /**
+     * @brief initializes the engine on first use, for benchmarks that need the device but not a scene
+     */
+    static void initEngine();
+
+    /**
+     * @brief materials without textures that stay registered for the whole run, the engine isn't needed for them
+     *
+     * Registering and freeing thousands of materials on every attempt would take longer than the lookups measured.
+     */
+    static const std::vector<std::shared_ptr<Material>>& getMaterials(uint32_t count);
+
+    /**
+     * @brief frees the scene and cleans the engine up if it was initialized
+     */
+    static void release();
+
+private:
+    inline static std::shared_ptr<Scene> scene_{};
+    inline static std::optional<SceneGenerator::Params> params_{};
+    inline static bool isEngineInitialized_{false};
+
+    static constexpr int64_t coarseInstanceCount{100000};
+
+    inline static std::map<uint32_t, std::vector<std::shared_ptr<Material>>> materials_{};
+};
+
+/**
+ * @brief runs the job system with a given number of threads while it lives, for benchmarks measuring scaling
+ */
+class WorkerCountScope {
+public:
+    //  the calling thread takes part in the work too, one thread runs everything on it
+    explicit WorkerCountScope(uint32_t threadCount) : previousWorkerCount_(JobSystem::getInstance().getWorkerCount()) {
+        JobSystem::getInstance().resize(std::max(threadCount, 1u) - 1);
+    }
+
+    ~WorkerCountScope() { JobSystem::getInstance().resize(previousWorkerCount_); }
+
+    WorkerCountScope(const WorkerCountScope&) = delete;
+    WorkerCountScope& operator=(const WorkerCountScope&) = delete;
+
+private:
+    uint32_t previousWorkerCount_{0};
+};
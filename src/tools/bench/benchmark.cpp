@@ -0,0 +1,308 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "benchmark.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <regex>
+#include <sstream>
+#include <thread>
+
+#include "../../engine/utils.h"
+
+namespace {
+    std::string formatTime(double seconds) {
+        std::ostringstream out{};
+        out << std::fixed << std::setprecision(seconds < 1e-6 ? 1 : 2);
+
+        if (seconds < 1e-6)
+            out << seconds * 1e9 << " ns";
+        else if (seconds < 1e-3)
+            out << seconds * 1e6 << " us";
+        else if (seconds < 1.0)
+            out << seconds * 1e3 << " ms";
+        else
+            out << seconds << " s";
+
+        return out.str();
+    }
+
+    std::string formatRate(double perSecond) {
+        std::ostringstream out{};
+        out << std::fixed << std::setprecision(2);
+
+        if (perSecond >= 1e9)
+            out << perSecond / 1e9 << "G/s";
+        else if (perSecond >= 1e6)
+            out << perSecond / 1e6 << "M/s";
+        else if (perSecond >= 1e3)
+            out << perSecond / 1e3 << "k/s";
+        else
+            out << perSecond << "/s";
+
+        return out.str();
+    }
+}
+
+bool BenchmarkState::keepRunning() {
+    if (!isStarted_) {
+        isStarted_ = true;
+        resumeTiming();
+    }
+    else
+        ++iteration_;
+
+    if (iteration_ < maxIterations_)
+        return true;
+
+    pauseTiming();
+    return false;
+}
+
+void BenchmarkState::pauseTiming() {
+    if (!isRunning_)
+        return;
+
+    realTime_ += std::chrono::duration<double>(Clock::now() - realStart_).count();
+    cpuTime_ += static_cast<double>(std::clock() - cpuStart_) / CLOCKS_PER_SEC;
+    isRunning_ = false;
+}
+
+void BenchmarkState::resumeTiming() {
+    if (isRunning_)
+        return;
+
+    realStart_ = Clock::now();
+    cpuStart_ = std::clock();
+    isRunning_ = true;
+}
+
+void BenchmarkState::setCounter(std::string name, double value) {
+    auto counter = std::ranges::find(counters_, name, &std::pair<std::string, double>::first);
+    if (counter != counters_.end())
+        counter->second = value;
+    else
+        counters_.emplace_back(std::move(name), value);
+}
+
+Benchmark& Benchmark::argsProduct(const std::vector<std::vector<int64_t>>& values) {
+    std::vector<std::vector<int64_t>> combinations{{}};
+
+    for (const auto& list : values) {
+        std::vector<std::vector<int64_t>> extended{};
+        for (const auto& combination : combinations) {
+            for (int64_t value : list) {
+                extended.emplace_back(combination);
+                extended.back().emplace_back(value);
+            }
+        }
+        combinations = std::move(extended);
+    }
+
+    for (auto& combination : combinations)
+        argSets_.emplace_back(std::move(combination));
+
+    return *this;
+}
+
+std::vector<int64_t> Benchmark::range(int64_t min, int64_t max, int64_t factor) {
+    std::vector<int64_t> values{};
+
+    for (int64_t value = min; value < max; value *= std::max<int64_t>(factor, 2))
+        values.emplace_back(value);
+    values.emplace_back(max);
+
+    return values;
+}
+
+Benchmark& BenchmarkRunner::add(std::string name, Benchmark::Function function) {
+    return benchmarks_.emplace_back(std::move(name), std::move(function));
+}
+
+std::string BenchmarkRunner::getRunName(const Benchmark& benchmark, const std::vector<int64_t>& args) {
+    std::string name{benchmark.name_};
+    for (int64_t arg : args)
+        name += "/" + std::to_string(arg);
+
+    if (benchmark.useManualTime_)
+        name += "/manual_time";
+
+    return name;
+}
+
+BenchmarkRunner::Result BenchmarkRunner::runBenchmark(const Benchmark& benchmark, const std::vector<int64_t>& args, double minTime) {
+    Result result{.name = getRunName(benchmark, args)};
+
+    uint64_t iterations{1};
+    while (true) {
+        BenchmarkState state{args, iterations};
+
+        try {
+            benchmark.function_(state);
+        }
+        catch (const std::exception& e) {
+            result.error = e.what();
+            return result;
+        }
+
+        if (state.error_) {
+            result.error = state.error_;
+            return result;
+        }
+
+        //  a benchmark that returned from inside its loop is stopped here
+        state.pauseTiming();
+
+        const double measuredTime = benchmark.useManualTime_ ? state.manualTime_ : state.realTime_;
+        if (measuredTime >= minTime || iterations >= maxIterations || state.iteration_ < iterations) {
+            const uint64_t completed = std::max<uint64_t>(state.iteration_, 1);
+
+            result.iterations = completed;
+            result.realTime = measuredTime / static_cast<double>(completed);
+            result.cpuTime = state.cpuTime_ / static_cast<double>(completed);
+            result.itemsPerSecond = measuredTime > 0.0 ? static_cast<double>(state.itemsProcessed_) / measuredTime : 0.0;
+            result.bytesPerSecond = measuredTime > 0.0 ? static_cast<double>(state.bytesProcessed_) / measuredTime : 0.0;
+            result.counters = std::move(state.counters_);
+            return result;
+        }
+
+        //  aim a bit past the minimum time, growing at most tenfold as short runs predict poorly
+        double multiplier = measuredTime > 0.0 ? minTime * 1.4 / measuredTime : 10.0;
+        multiplier = std::min(multiplier, 10.0);
+
+        iterations = std::clamp<uint64_t>(static_cast<uint64_t>(static_cast<double>(iterations) * multiplier), iterations + 1, maxIterations);
+    }
+}
+
+void BenchmarkRunner::printResult(const Result& result) {
+    std::cout << std::left << std::setw(56) << result.name << std::right;
+
+    if (result.error) {
+        std::cout << " ERROR: " << *result.error << std::endl;
+        return;
+    }
+
+    std::cout << std::setw(14) << formatTime(result.realTime) << std::setw(14) << formatTime(result.cpuTime) << std::setw(12) << result.iterations;
+
+    if (result.itemsPerSecond > 0.0)
+        std::cout << "  items_per_second=" << formatRate(result.itemsPerSecond);
+    if (result.bytesPerSecond > 0.0)
+        std::cout << "  bytes_per_second=" << formatRate(result.bytesPerSecond);
+    for (const auto& [name, value] : result.counters)
+        std::cout << "  " << name << "=" << value;
+
+    std::cout << std::endl;
+}
+
+bool BenchmarkRunner::writeJson(const std::string& path, const std::vector<Result>& results) {
+    std::filesystem::path filePath{path};
+
+    std::error_code ec;
+    if (filePath.has_parent_path())
+        std::filesystem::create_directories(filePath.parent_path(), ec);
+
+    std::ofstream out(filePath, std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "WARNING: failed to create benchmark results " << path << std::endl;
+        return false;
+    }
+
+    std::time_t now = std::time(nullptr);
+    char date[32]{};
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+    out << std::setprecision(10);
+    out << "{\n";
+    out << "  \"context\": {\n";
+    out << "    \"date\": \"" << date << "\",\n";
+    out << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n";
+#ifdef NDEBUG
+    out << "    \"library_build_type\": \"release\"\n";
+#else
+    out << "    \"library_build_type\": \"debug\"\n";
+#endif
+    out << "  },\n";
+    out << "  \"benchmarks\": [";
+
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+
+        out << (i > 0 ? ",\n" : "\n") << "    {\"name\": \"" << result.name << "\", \"run_name\": \"" << result.name << "\", \"run_type\": \"iteration\"";
+
+        if (result.error)
+            out << ", \"error_occurred\": true, \"error_message\": \"" << Utils::escapeJson(*result.error) << "\"";
+        else {
+            out << ", \"iterations\": " << result.iterations << ", \"real_time\": " << result.realTime * 1e9 << ", \"cpu_time\": " << result.cpuTime * 1e9
+                << ", \"time_unit\": \"ns\"";
+
+            if (result.itemsPerSecond > 0.0)
+                out << ", \"items_per_second\": " << result.itemsPerSecond;
+            if (result.bytesPerSecond > 0.0)
+                out << ", \"bytes_per_second\": " << result.bytesPerSecond;
+            for (const auto& [name, value] : result.counters)
+                out << ", \"" << name << "\": " << value;
+        }
+
+        out << "}";
+    }
+
+    out << "\n  ]\n";
+    out << "}\n";
+
+    out.close();
+    if (!out) {
+        std::cerr << "WARNING: failed to write benchmark results " << path << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+bool BenchmarkRunner::run(const Options& options) {
+    const std::regex filter{options.filter};
+
+    std::vector<Result> results{};
+    bool isHeaderPrinted{false};
+
+    for (const Benchmark& benchmark : benchmarks_) {
+        if (benchmark.requiresDevice_ && options.skipDeviceBenchmarks)
+            continue;
+
+        //  benchmarks without arguments run once
+        std::vector<std::vector<int64_t>> argSets{benchmark.argSets_};
+        if (argSets.empty())
+            argSets.emplace_back();
+
+        for (const auto& args : argSets) {
+            std::string runName = getRunName(benchmark, args);
+            if (!std::regex_search(runName, filter))
+                continue;
+
+            if (options.listOnly) {
+                std::cout << runName << std::endl;
+                continue;
+            }
+
+            if (!isHeaderPrinted) {
+                std::cout << std::left << std::setw(56) << "Benchmark" << std::right << std::setw(14) << "Time" << std::setw(14) << "CPU"
+                          << std::setw(12) << "Iterations" << std::endl;
+                std::cout << std::string(96, '-') << std::endl;
+                isHeaderPrinted = true;
+            }
+
+            Result result = runBenchmark(benchmark, args, benchmark.minTime_.value_or(options.minTime));
+            printResult(result);
+            results.emplace_back(std::move(result));
+        }
+    }
+
+    if (options.jsonPath && !options.listOnly)
+        writeJson(*options.jsonPath, results);
+
+    return std::ranges::none_of(results, [](const Result& result) { return result.error.has_value(); });
+}
@@ -0,0 +1,205 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <deque>
+#include <functional>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief passed to a benchmark, its keepRunning() loop is what gets measured
+ *
+ * The runner calls the benchmark repeatedly with a growing iteration count until a run takes at least the minimum
+ * time, so everything before the loop is setup and runs once per attempt.
+ */
+class BenchmarkState {
+public:
+    BenchmarkState(std::vector<int64_t> args, uint64_t maxIterations) : args_(std::move(args)), maxIterations_(maxIterations) {}
+
+    /**
+     * @return false once the run's iterations are done, the first call starts the timer
+     */
+    bool keepRunning();
+
+    [[nodiscard]] int64_t getArg(uint32_t index) const { return args_.at(index); }
+    [[nodiscard]] uint64_t getIterations() const { return maxIterations_; }
+
+    //  excludes per iteration setup from the measured time
+    void pauseTiming();
+    void resumeTiming();
+
+    /**
+     * @brief adds the measured time of one iteration, only used by benchmarks registered with useManualTime()
+     */
+    void setIterationTime(double seconds) { manualTime_ += seconds; }
+
+    //  reported per second of measured time
+    void setItemsProcessed(uint64_t items) { itemsProcessed_ = items; }
+    void setBytesProcessed(uint64_t bytes) { bytesProcessed_ = bytes; }
+
+    //  reported as is
+    void setCounter(std::string name, double value);
+
+    /**
+     * @brief ends the benchmark, call it before the loop
+     */
+    void skipWithError(std::string message) { error_ = std::move(message); maxIterations_ = 0; }
+
+    friend class BenchmarkRunner;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    std::vector<int64_t> args_{};
+    uint64_t maxIterations_{0};
+    uint64_t iteration_{0};
+    bool isStarted_{false};
+    bool isRunning_{false};
+
+    Clock::time_point realStart_{};
+    std::clock_t cpuStart_{0};
+    double realTime_{0.0};
+    double cpuTime_{0.0};
+    double manualTime_{0.0};
+
+    uint64_t itemsProcessed_{0};
+    uint64_t bytesProcessed_{0};
+    std::vector<std::pair<std::string, double>> counters_{};
+
+    std::optional<std::string> error_{};
+};
+
+/**
+ * @brief a registered benchmark and the argument sets it runs with, one run per set
+ */
+class Benchmark {
+public:
+    using Function = std::function<void(BenchmarkState&)>;
+
+    Benchmark(std::string name, Function function) : name_(std::move(name)), function_(std::move(function)) {}
+
+    Benchmark& args(std::vector<int64_t> args) { argSets_.emplace_back(std::move(args)); return *this; }
+
+    /**
+     * @brief adds every combination of the values, the first list varies slowest
+     */
+    Benchmark& argsProduct(const std::vector<std::vector<int64_t>>& values);
+
+    /**
+     * @return a list from min to max multiplying by factor, for argsProduct
+     */
+    static std::vector<int64_t> range(int64_t min, int64_t max, int64_t factor = 8);
+
+    //  the benchmark measures itself with setIterationTime, e.g. a part of a frame
+    Benchmark& useManualTime() { useManualTime_ = true; return *this; }
+
+    //  the benchmark needs the engine's Vulkan device, skipped with --no-device
+    Benchmark& requiresDevice() { requiresDevice_ = true; return *this; }
+
+    //  overrides the runner's minimum time, for benchmarks whose iterations are whole frames
+    Benchmark& minTime(double seconds) { minTime_ = seconds; return *this; }
+
+    friend class BenchmarkRunner;
+
+private:
+    std::string name_{};
+    Function function_{};
+    std::vector<std::vector<int64_t>> argSets_{};
+    bool useManualTime_{false};
+    bool requiresDevice_{false};
+    std::optional<double> minTime_{};
+};
+
+/**
+ * @brief runs the registered benchmarks and prints them as a table, optionally as Google Benchmark compatible JSON
+ *
+ * The JSON has the same layout as the one written by --benchmark_format=json, so the usual compare scripts work on it.
+ */
+class BenchmarkRunner {
+public:
+    static BenchmarkRunner& getInstance(){
+        if (instance_ == nullptr)
+            instance_ = new BenchmarkRunner();
+        return *instance_;
+    }
+
+    BenchmarkRunner(const BenchmarkRunner&) = delete;
+    BenchmarkRunner& operator=(const BenchmarkRunner&) = delete;
+
+    Benchmark& add(std::string name, Benchmark::Function function);
+
+    struct Options {
+        //  regular expression matched against the full run name, e.g. "recordScene/.*"
+        std::string filter{".*"};
+        double minTime{0.5};
+        bool skipDeviceBenchmarks{false};
+        bool listOnly{false};
+        std::optional<std::string> jsonPath{};
+    };
+
+    /**
+     * @return false if any benchmark failed
+     */
+    bool run(const Options& options);
+
+private:
+    BenchmarkRunner() = default;
+
+    struct Result {
+        std::string name{};
+        uint64_t iterations{0};
+
+        //  per iteration, in seconds
+        double realTime{0.0};
+        double cpuTime{0.0};
+
+        double itemsPerSecond{0.0};
+        double bytesPerSecond{0.0};
+        std::vector<std::pair<std::string, double>> counters{};
+
+        std::optional<std::string> error{};
+    };
+
+    static std::string getRunName(const Benchmark& benchmark, const std::vector<int64_t>& args);
+
+    /**
+     * @brief grows the iteration count until a run takes at least minTime
+     */
+    static Result runBenchmark(const Benchmark& benchmark, const std::vector<int64_t>& args, double minTime);
+
+    static void printResult(const Result& result);
+    static bool writeJson(const std::string& path, const std::vector<Result>& results);
+
+    inline static BenchmarkRunner* instance_{nullptr};
+
+    //  a deque keeps the references add() returned valid
+    std::deque<Benchmark> benchmarks_{};
+
+    static constexpr uint64_t maxIterations{1'000'000'000};
+};
+
+/**
+ * @brief keeps the compiler from dropping a computation whose result is never used
+ */
+template <typename T>
+inline void doNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static const volatile void* sink{nullptr};
+    sink = &value;
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+//  registers a function void(BenchmarkState&) under its own name, the chained calls configure the runs
+#define DP_BENCHMARK(function) \
+    [[maybe_unused]] static Benchmark& function##Registration = BenchmarkRunner::getInstance().add(#function, function)
@@ -0,0 +1,49 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "benchmark.h"
+#include "benchFixtures.h"
+#include "../../engine/engine.h"
+
+//  usage: dp_bench [--filter regex] [--min-time seconds] [--json results.json] [--no-device] [--list]
+//  benchmarks needing a device render headless on a generated scene, so no display is required
+//  --json writes Google Benchmark compatible results to track the scaling curves between builds
+int main(int argc, char** argv) {
+    BenchmarkRunner::Options options{};
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+        if (arg == "--filter" && i + 1 < argc)
+            options.filter = argv[++i];
+        else if (arg == "--min-time" && i + 1 < argc)
+            options.minTime = std::stod(argv[++i]);
+        else if (arg == "--json" && i + 1 < argc)
+            options.jsonPath = argv[++i];
+        else if (arg == "--no-device")
+            options.skipDeviceBenchmarks = true;
+        else if (arg == "--list")
+            options.listOnly = true;
+        else
+            std::cerr << "WARNING: unknown argument " << arg << std::endl;
+    }
+
+    Engine::headless = true;
+    Engine::useVsync = false;
+
+    bool isSuccess{false};
+    try {
+        isSuccess = BenchmarkRunner::getInstance().run(options);
+        BenchScene::release();
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    return isSuccess ? EXIT_SUCCESS : EXIT_FAILURE;
+}
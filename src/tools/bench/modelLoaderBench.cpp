@@ -0,0 +1,114 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "benchmark.h"
+#include "benchFixtures.h"
+#include "sceneGenerator.h"
+#include "../../engine/engine.h"
+#include "../../engine/meshOptimizer.h"
+#include "../../engine/modelLoader.h"
+#include "../../engine/vk/uploadBatch.h"
+
+namespace {
+    //  relative to the working directory like the model cache, the files are written on the first run only
+    const std::string textureDirectory{"cache/bench/textures/"};
+    constexpr uint32_t textureSize{1024};
+}
+
+//  args: mesh count, subdivisions
+void convertMeshes(BenchmarkState& state) {
+    SceneGenerator generator{{.meshCount = static_cast<uint32_t>(state.getArg(0)), .materialCount = 1, .subdivisions = static_cast<uint32_t>(state.getArg(1))}};
+    std::unique_ptr<aiScene> scene = generator.generateAiScene();
+
+    uint64_t vertexCount{0};
+    for (uint32_t i = 0; i < scene->mNumMeshes; ++i)
+        vertexCount += scene->mMeshes[i]->mNumVertices;
+
+    while (state.keepRunning()) {
+        for (uint32_t i = 0; i < scene->mNumMeshes; ++i) {
+            MeshCache::MeshData meshData = ModelLoader::convertMesh(*scene->mMeshes[i]);
+            doNotOptimize(meshData);
+        }
+    }
+
+    //  vertices per second, the triangles follow from the subdivisions
+    state.setItemsProcessed(state.getIterations() * vertexCount);
+    state.setCounter("triangles", static_cast<double>(generator.getTriangleCount()) * static_cast<double>(scene->mNumMeshes));
+}
+DP_BENCHMARK(convertMeshes).argsProduct({{1, 16, 256}, {8, 64}});
+
+//  args: material count
+void convertMaterials(BenchmarkState& state) {
+    SceneGenerator generator{{.meshCount = 1, .materialCount = static_cast<uint32_t>(state.getArg(0))}};
+    std::unique_ptr<aiScene> scene = generator.generateAiScene();
+
+    while (state.keepRunning()) {
+        for (uint32_t i = 0; i < scene->mNumMaterials; ++i) {
+            MeshCache::MaterialData materialData = ModelLoader::convertMaterial(*scene->mMaterials[i]);
+            doNotOptimize(materialData);
+        }
+    }
+
+    state.setItemsProcessed(state.getIterations() * scene->mNumMaterials);
+}
+DP_BENCHMARK(convertMaterials).args({1}).args({64}).args({1024});
+
+//  args: subdivisions, the optimization every imported mesh goes through before it is cached
+void optimizeMesh(BenchmarkState& state) {
+    SceneGenerator generator{{.meshCount = 1, .materialCount = 1, .subdivisions = static_cast<uint32_t>(state.getArg(0))}};
+    const MeshCache::MeshData source = generator.generateMesh(0);
+
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        std::vector<Vertex3D> vertices{source.vertices};
+        std::vector<uint32_t> indices{source.indices};
+        std::vector<Meshlet> meshlets{};
+        state.resumeTiming();
+
+        MeshOptimizer::Report report = MeshOptimizer::optimize(vertices, indices, meshlets);
+        doNotOptimize(report);
+    }
+
+    state.setItemsProcessed(state.getIterations() * generator.getTriangleCount());
+}
+DP_BENCHMARK(optimizeMesh).args({8}).args({32}).args({128});
+
+//  args: textures, threads, every material has its own diffuse texture that is decoded, staged and uploaded
+//  like loading a model with a warm mesh cache and texture streaming off
+void loadMaterials(BenchmarkState& state) {
+    BenchScene::initEngine();
+
+    const auto textureCount = static_cast<uint32_t>(state.getArg(0));
+    SceneGenerator generator{{.materialCount = textureCount, .textureCount = textureCount}};
+    const std::vector<std::string> textureNames = generator.writeTextureFiles(textureDirectory, textureSize);
+
+    std::vector<MeshCache::MaterialData> materialData{};
+    for (uint32_t i = 0; i < textureCount; ++i) {
+        MeshCache::MaterialData data{.name = "bench_material_" + std::to_string(i), .diffuseAlbedo = glm::vec3{1.0f}, .shininess = 32.0f, .ior = 1.5f};
+        data.textureNames[static_cast<uint8_t>(Material::TextureMapSlot::diffuseMapSlot)] = textureNames[i];
+        materialData.emplace_back(std::move(data));
+    }
+
+    WorkerCountScope workers{static_cast<uint32_t>(state.getArg(1))};
+    StagingRing& stagingRing = Engine::getInstance().getStagingRing();
+
+    const bool previousStreamTextures = ModelLoader::streamTextures;
+    ModelLoader::streamTextures = false;
+
+    while (state.keepRunning()) {
+        UploadBatch uploadBatch{stagingRing};
+        std::vector<std::shared_ptr<Material>> materials = ModelLoader::loadMaterials(textureDirectory, materialData, true, uploadBatch);
+        uploadBatch.submitAndWait();
+
+        //  the textures go away with their materials, so the next iteration decodes them again
+        state.pauseTiming();
+        materials.clear();
+        state.resumeTiming();
+    }
+
+    ModelLoader::streamTextures = previousStreamTextures;
+
+    state.setItemsProcessed(state.getIterations() * textureCount);
+}
+DP_BENCHMARK(loadMaterials).argsProduct({{16, 64}, {1, 2, 4, 8}}).requiresDevice();
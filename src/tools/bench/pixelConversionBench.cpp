@@ -0,0 +1,146 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include <string>
+#include <vector>
+
+#include "benchmark.h"
+#include "../../engine/pixelConversion.h"
+
+namespace {
+    using Isa = PixelConversion::Isa;
+
+    /**
+     * @brief limits the conversions to an instruction set while it lives, skips the benchmark if the CPU lacks it
+     */
+    class MaxIsaScope {
+    public:
+        MaxIsaScope(BenchmarkState& state, int64_t isa) {
+            const auto maxIsa = static_cast<Isa>(isa);
+            if (maxIsa > PixelConversion::getSupportedIsa())
+                state.skipWithError(std::string{"the CPU doesn't support "} + PixelConversion::getIsaName(maxIsa));
+
+            PixelConversion::setMaxIsa(maxIsa);
+        }
+
+        //  back to the default, the best the CPU supports
+        ~MaxIsaScope() { PixelConversion::setMaxIsa(Isa::avx2); }
+
+        MaxIsaScope(const MaxIsaScope&) = delete;
+        MaxIsaScope& operator=(const MaxIsaScope&) = delete;
+    };
+
+    //  the same pixels for every run, all values of a byte show up
+    std::vector<uint8_t> getSourceBytes(size_t byteCount) {
+        std::vector<uint8_t> bytes(byteCount);
+        for (size_t i = 0; i < byteCount; ++i)
+            bytes[i] = static_cast<uint8_t>(i * 7 + i / 256);
+        return bytes;
+    }
+
+    std::vector<float> getSourceFloats(size_t valueCount) {
+        std::vector<float> values(valueCount);
+        for (size_t i = 0; i < valueCount; ++i)
+            values[i] = static_cast<float>((i * 7 + i / 256) % 256) / 255.0f;
+        return values;
+    }
+
+    //  a tile that fits into L2 and a texture that doesn't fit into any cache
+    const std::vector<int64_t> pixelCounts{256 * 256, 2048 * 2048};
+
+    //  scalar, SSSE3, AVX2
+    const std::vector<int64_t> isas{static_cast<int64_t>(Isa::scalar), static_cast<int64_t>(Isa::sse), static_cast<int64_t>(Isa::avx2)};
+}
+
+//  args: pixels, RGBA bytes through the lookup table, it has no vector path so it's the baseline for the float kernels
+void srgbToLinearBytes(BenchmarkState& state) {
+    const auto pixelCount = static_cast<size_t>(state.getArg(0));
+    const std::vector<uint8_t> source = getSourceBytes(pixelCount * 4);
+    std::vector<uint8_t> pixels{source};
+
+    while (state.keepRunning()) {
+        //  converting in place again and again would push every value towards 0
+        state.pauseTiming();
+        pixels = source;
+        state.resumeTiming();
+
+        PixelConversion::srgbToLinear(pixels.data(), pixelCount, 4, true);
+        doNotOptimize(pixels.data());
+    }
+
+    state.setItemsProcessed(state.getIterations() * pixelCount);
+}
+DP_BENCHMARK(srgbToLinearBytes).argsProduct({pixelCounts});
+
+//  args: instruction set, pixels, RGBA floats like the ones decoded from EXR and HDR files
+void srgbToLinearFloats(BenchmarkState& state) {
+    MaxIsaScope isaScope{state, state.getArg(0)};
+    const auto pixelCount = static_cast<size_t>(state.getArg(1));
+    const std::vector<float> source = getSourceFloats(pixelCount * 4);
+    std::vector<float> values{source};
+
+    while (state.keepRunning()) {
+        //  the scalar curve takes a cheaper branch near 0, every iteration has to start from the same values
+        state.pauseTiming();
+        values = source;
+        state.resumeTiming();
+
+        PixelConversion::srgbToLinear(values, true);
+        doNotOptimize(values.data());
+    }
+
+    state.setItemsProcessed(state.getIterations() * pixelCount);
+}
+DP_BENCHMARK(srgbToLinearFloats).argsProduct({isas, pixelCounts});
+
+//  args: instruction set, pixels, the inverse used when cooking textures
+void linearToSrgbFloats(BenchmarkState& state) {
+    MaxIsaScope isaScope{state, state.getArg(0)};
+    const auto pixelCount = static_cast<size_t>(state.getArg(1));
+    const std::vector<float> source = getSourceFloats(pixelCount * 4);
+    std::vector<float> values{source};
+
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        values = source;
+        state.resumeTiming();
+
+        PixelConversion::linearToSrgb(values, true);
+        doNotOptimize(values.data());
+    }
+
+    state.setItemsProcessed(state.getIterations() * pixelCount);
+}
+DP_BENCHMARK(linearToSrgbFloats).argsProduct({isas, pixelCounts});
+
+//  args: instruction set, pixels, BGRA <-> RGBA in place
+void swapRedBlue(BenchmarkState& state) {
+    MaxIsaScope isaScope{state, state.getArg(0)};
+    const auto pixelCount = static_cast<size_t>(state.getArg(1));
+    std::vector<uint8_t> pixels = getSourceBytes(pixelCount * 4);
+
+    while (state.keepRunning()) {
+        PixelConversion::swapRedBlue(pixels.data(), pixelCount);
+        doNotOptimize(pixels.data());
+    }
+
+    state.setItemsProcessed(state.getIterations() * pixelCount);
+}
+DP_BENCHMARK(swapRedBlue).argsProduct({isas, pixelCounts});
+
+//  args: instruction set, pixels, BGR -> RGBA, what every 24-bit image goes through while being staged
+void expandRGBToRGBA(BenchmarkState& state) {
+    MaxIsaScope isaScope{state, state.getArg(0)};
+    const auto pixelCount = static_cast<size_t>(state.getArg(1));
+    const std::vector<uint8_t> source = getSourceBytes(pixelCount * 3);
+    std::vector<uint8_t> pixels(pixelCount * 4);
+
+    while (state.keepRunning()) {
+        PixelConversion::expandRGBToRGBA(source.data(), pixels.data(), pixelCount, true);
+        doNotOptimize(pixels.data());
+    }
+
+    state.setItemsProcessed(state.getIterations() * pixelCount);
+}
+DP_BENCHMARK(expandRGBToRGBA).argsProduct({isas, pixelCounts});
@@ -0,0 +1,117 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include <vector>
+
+#include "benchmark.h"
+#include "benchFixtures.h"
+#include "../../engine/engine.h"
+#include "../../engine/vk/shaderLibrary.h"
+
+namespace {
+    enum class RecordMode : int64_t {
+        serial = 0,
+        parallel = 1,
+        indirect = 2
+    };
+
+    //  frames rendered per iteration of renderFrames, enough to fill every frame in flight
+    constexpr uint32_t framesPerIteration{8};
+
+    const std::string shaderSourceDirectory{"../shaders/"};
+}
+
+//  args: instances, record mode (0 serial, 1 secondary command buffers on the job system, 2 indirect)
+//  only the CPU time of recording the scene pass is measured, culling and the rest of the frame aren't
+void recordScene(BenchmarkState& state) {
+    BenchScene::get(BenchScene::getInstanceParams(state.getArg(0)));
+    Engine& engine = Engine::getInstance();
+
+    const auto mode = static_cast<RecordMode>(state.getArg(1));
+    engine.setDrawOptions({.indirectDraws = mode == RecordMode::indirect, .parallelRecording = mode == RecordMode::parallel});
+
+    if (mode == RecordMode::indirect && !engine.getDrawOptions().indirectDraws)
+        state.skipWithError("indirect draws aren't supported by the device");
+
+    while (state.keepRunning()) {
+        engine.renderFrames(1);
+        state.setIterationTime(engine.getLastSceneRecordTime() * 1e-6);
+    }
+
+    state.setItemsProcessed(state.getIterations() * static_cast<uint64_t>(state.getArg(0)));
+}
+DP_BENCHMARK(recordScene).argsProduct({{1000, 10000, 100000}, {0, 1, 2}}).useManualTime().requiresDevice();
+
+//  args: instances, threads recording the secondary command buffers
+void recordSceneParallel(BenchmarkState& state) {
+    BenchScene::get(BenchScene::getInstanceParams(state.getArg(0)));
+    WorkerCountScope workers{static_cast<uint32_t>(state.getArg(1))};
+    Engine& engine = Engine::getInstance();
+
+    engine.setDrawOptions({.indirectDraws = false, .parallelRecording = true});
+
+    while (state.keepRunning()) {
+        engine.renderFrames(1);
+        state.setIterationTime(engine.getLastSceneRecordTime() * 1e-6);
+    }
+
+    state.setItemsProcessed(state.getIterations() * static_cast<uint64_t>(state.getArg(0)));
+}
+DP_BENCHMARK(recordSceneParallel).argsProduct({{16384}, {1, 2, 4, 8}}).useManualTime().requiresDevice();
+
+//  args: instances, frames in flight, whole frames back to back, items are frames
+void renderFrames(BenchmarkState& state) {
+    BenchScene::get(BenchScene::getInstanceParams(state.getArg(0)));
+    Engine& engine = Engine::getInstance();
+
+    const uint32_t previousFramesInFlight = engine.getFramesInFlight();
+    engine.setFramesInFlight(static_cast<uint32_t>(state.getArg(1)));
+    engine.setDrawOptions({});
+
+    while (state.keepRunning())
+        engine.renderFrames(framesPerIteration);
+
+    engine.setFramesInFlight(previousFramesInFlight);
+
+    state.setItemsProcessed(state.getIterations() * framesPerIteration);
+    state.setCounter("cpuMs", engine.getFrameStats().cpuTime);
+    state.setCounter("gpuMs", engine.getFrameStats().gpuTime);
+}
+DP_BENCHMARK(renderFrames).argsProduct({{256, 4096, 16384}, {1, 2, 3}}).minTime(2.0).requiresDevice();
+
+//  args: 0 starts from an empty pipeline cache, 1 from the cache file saved right before, all four pipelines in parallel
+//  the shaders come from the SPIR-V cache in both cases, only the driver's compilation differs
+void createPipelines(BenchmarkState& state) {
+    BenchScene::initEngine();
+    Engine& engine = Engine::getInstance();
+    const bool loadPipelineCache = state.getArg(0) != 0;
+
+    while (state.keepRunning())
+        state.setIterationTime(engine.recreatePipelines(loadPipelineCache) * 1e-3);
+
+    state.setCounter("warm", engine.getPipelineCache().isWarm() ? 1.0 : 0.0);
+    state.setCounter("loadedKB", static_cast<double>(engine.getPipelineCache().getLoadedSize()) / 1024.0);
+}
+DP_BENCHMARK(createPipelines).args({0}).args({1}).useManualTime().requiresDevice();
+
+//  args: 0 compiles every time, 1 loads from the SPIR-V cache (after the first attempt compiled it)
+void getSpirv(BenchmarkState& state) {
+    const bool previousUseSpirvCache = ShaderLibrary::useSpirvCache;
+    ShaderLibrary::useSpirvCache = state.getArg(0) != 0;
+
+    ShaderLibrary library{shaderSourceDirectory};
+
+    while (state.keepRunning()) {
+        std::vector<uint32_t> code = library.getSpirv("shader.frag");
+        doNotOptimize(code);
+    }
+
+    ShaderLibrary::useSpirvCache = previousUseSpirvCache;
+
+    const ShaderLibrary::Stats stats = library.getStats();
+    state.setCounter("compiled", stats.compiledCount);
+    state.setCounter("cached", stats.cacheHitCount);
+    state.setCounter("precompiled", stats.precompiledCount);
+}
+DP_BENCHMARK(getSpirv).args({0}).args({1});
@@ -0,0 +1,257 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include <atomic>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "benchmark.h"
+#include "benchFixtures.h"
+#include "../../engine/managers/resourceManager.h"
+
+namespace {
+    //  lookups walk the resources with a prime stride, so neighboring lookups don't hit neighboring slots
+    constexpr uint32_t lookupStride{7919};
+
+    //  per iteration of the parallel lookups, split among the threads
+    constexpr uint32_t parallelLookupCount{16384};
+
+    //  per iteration of the register and free stress, split among the threads
+    constexpr uint32_t stressItemCount{4096};
+
+    struct LookupKeys {
+        std::vector<std::string> names{};
+        std::vector<ResourceHandle> handles{};
+    };
+
+    LookupKeys getLookupKeys(uint32_t count) {
+        LookupKeys keys{};
+        for (const auto& material : BenchScene::getMaterials(count)) {
+            keys.names.emplace_back(material->getResourceName());
+            keys.handles.emplace_back(material->getHandle());
+        }
+        return keys;
+    }
+
+    /**
+     * @brief the two maps ResourceManager used before the sharded slot map, kept as the baseline the lookups are compared with
+     *
+     * Lookups by name build a std::string key and go through both maps, like the original getResource did. The maps
+     * weren't thread safe, the parallel baseline guards them with a single shared mutex.
+     */
+    struct ReferenceRegistry {
+        std::unordered_map<uint32_t, std::weak_ptr<Material>> idToResourceMap{};
+        std::unordered_map<std::string, uint32_t> nameToIdMap{};
+        std::shared_mutex mutex;
+
+        explicit ReferenceRegistry(const std::vector<std::shared_ptr<Material>>& materials) {
+            for (const auto& material : materials) {
+                idToResourceMap[material->getCID()] = material;
+                nameToIdMap[material->getResourceName()] = material->getCID();
+            }
+        }
+
+        std::shared_ptr<Material> getResource(uint32_t resourceId) {
+            auto it = idToResourceMap.find(resourceId);
+            if (it != idToResourceMap.end())
+                return it->second.lock();
+            return nullptr;
+        }
+
+        std::shared_ptr<Material> getResource(std::string_view resourceName) {
+            auto it = nameToIdMap.find(std::string{resourceName});
+            if (it != nameToIdMap.end())
+                return getResource(it->second);
+            return nullptr;
+        }
+    };
+}
+
+//  args: registered resources
+void lookupByName(BenchmarkState& state) {
+    const LookupKeys keys = getLookupKeys(static_cast<uint32_t>(state.getArg(0)));
+    auto* manager = MaterialManager::getInstance();
+
+    uint32_t index{0};
+    while (state.keepRunning()) {
+        std::shared_ptr<Material> material = manager->getResource(std::string_view{keys.names[index]});
+        doNotOptimize(material);
+        index = static_cast<uint32_t>((index + lookupStride) % keys.names.size());
+    }
+
+    state.setItemsProcessed(state.getIterations());
+}
+DP_BENCHMARK(lookupByName).argsProduct({Benchmark::range(16, 65536, 64)});
+
+//  args: registered resources
+void lookupByHandle(BenchmarkState& state) {
+    const LookupKeys keys = getLookupKeys(static_cast<uint32_t>(state.getArg(0)));
+    auto* manager = MaterialManager::getInstance();
+
+    uint32_t index{0};
+    while (state.keepRunning()) {
+        std::shared_ptr<Material> material = manager->getResource(keys.handles[index]);
+        doNotOptimize(material);
+        index = static_cast<uint32_t>((index + lookupStride) % keys.handles.size());
+    }
+
+    state.setItemsProcessed(state.getIterations());
+}
+DP_BENCHMARK(lookupByHandle).argsProduct({Benchmark::range(16, 65536, 64)});
+
+//  args: registered resources, the baseline of lookupByName
+void lookupByNameReference(BenchmarkState& state) {
+    const auto count = static_cast<uint32_t>(state.getArg(0));
+    const LookupKeys keys = getLookupKeys(count);
+    ReferenceRegistry registry{BenchScene::getMaterials(count)};
+
+    uint32_t index{0};
+    while (state.keepRunning()) {
+        std::shared_ptr<Material> material = registry.getResource(std::string_view{keys.names[index]});
+        doNotOptimize(material);
+        index = static_cast<uint32_t>((index + lookupStride) % keys.names.size());
+    }
+
+    state.setItemsProcessed(state.getIterations());
+}
+DP_BENCHMARK(lookupByNameReference).argsProduct({Benchmark::range(16, 65536, 64)});
+
+//  args: registered resources, the baseline of lookupByHandle and resolveHandle, by CID as handles didn't exist
+void lookupByIdReference(BenchmarkState& state) {
+    const auto count = static_cast<uint32_t>(state.getArg(0));
+    const LookupKeys keys = getLookupKeys(count);
+    ReferenceRegistry registry{BenchScene::getMaterials(count)};
+
+    uint32_t index{0};
+    while (state.keepRunning()) {
+        std::shared_ptr<Material> material = registry.getResource(keys.handles[index].getIndex());
+        doNotOptimize(material);
+        index = static_cast<uint32_t>((index + lookupStride) % keys.handles.size());
+    }
+
+    state.setItemsProcessed(state.getIterations());
+}
+DP_BENCHMARK(lookupByIdReference).argsProduct({Benchmark::range(16, 65536, 64)});
+
+//  args: registered resources, the lock free path used while recording frames
+void resolveHandle(BenchmarkState& state) {
+    const LookupKeys keys = getLookupKeys(static_cast<uint32_t>(state.getArg(0)));
+    auto* manager = MaterialManager::getInstance();
+
+    uint32_t index{0};
+    while (state.keepRunning()) {
+        Material* material = manager->resolve(keys.handles[index]);
+        doNotOptimize(material);
+        index = static_cast<uint32_t>((index + lookupStride) % keys.handles.size());
+    }
+
+    state.setItemsProcessed(state.getIterations());
+}
+DP_BENCHMARK(resolveHandle).argsProduct({Benchmark::range(16, 65536, 64)});
+
+//  args: registered resources, threads
+void lookupByNameParallel(BenchmarkState& state) {
+    const LookupKeys keys = getLookupKeys(static_cast<uint32_t>(state.getArg(0)));
+    WorkerCountScope workers{static_cast<uint32_t>(state.getArg(1))};
+    auto* manager = MaterialManager::getInstance();
+
+    while (state.keepRunning()) {
+        JobSystem::getInstance().parallelFor(parallelLookupCount, 1024, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                std::shared_ptr<Material> material = manager->getResource(std::string_view{keys.names[(i * lookupStride) % keys.names.size()]});
+                doNotOptimize(material);
+            }
+        });
+    }
+
+    state.setItemsProcessed(state.getIterations() * parallelLookupCount);
+}
+DP_BENCHMARK(lookupByNameParallel).argsProduct({{1024, 65536}, {1, 2, 4, 8}});
+
+//  args: registered resources, threads, the baseline of lookupByNameParallel, every lookup takes the one shared lock
+void lookupByNameReferenceParallel(BenchmarkState& state) {
+    const auto count = static_cast<uint32_t>(state.getArg(0));
+    const LookupKeys keys = getLookupKeys(count);
+    ReferenceRegistry registry{BenchScene::getMaterials(count)};
+    WorkerCountScope workers{static_cast<uint32_t>(state.getArg(1))};
+
+    while (state.keepRunning()) {
+        JobSystem::getInstance().parallelFor(parallelLookupCount, 1024, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                std::shared_lock<std::shared_mutex> lock(registry.mutex);
+                std::shared_ptr<Material> material = registry.getResource(std::string_view{keys.names[(i * lookupStride) % keys.names.size()]});
+                doNotOptimize(material);
+            }
+        });
+    }
+
+    state.setItemsProcessed(state.getIterations() * parallelLookupCount);
+}
+DP_BENCHMARK(lookupByNameReferenceParallel).argsProduct({{1024, 65536}, {1, 2, 4, 8}});
+
+//  args: registered resources, threads
+void resolveHandleParallel(BenchmarkState& state) {
+    const LookupKeys keys = getLookupKeys(static_cast<uint32_t>(state.getArg(0)));
+    WorkerCountScope workers{static_cast<uint32_t>(state.getArg(1))};
+    auto* manager = MaterialManager::getInstance();
+
+    while (state.keepRunning()) {
+        JobSystem::getInstance().parallelFor(parallelLookupCount, 1024, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                Material* material = manager->resolve(keys.handles[(i * lookupStride) % keys.handles.size()]);
+                doNotOptimize(material);
+            }
+        });
+    }
+
+    state.setItemsProcessed(state.getIterations() * parallelLookupCount);
+}
+DP_BENCHMARK(resolveHandleParallel).argsProduct({{1024, 65536}, {1, 2, 4, 8}});
+
+//  args: registered resources, threads, every item registers a material under its own name and one under a name it
+//  shares with three other items, checks both resolve while held and that the first one's handle is stale once freed
+void registerAndFreeParallel(BenchmarkState& state) {
+    BenchScene::getMaterials(static_cast<uint32_t>(state.getArg(0)));
+    WorkerCountScope workers{static_cast<uint32_t>(state.getArg(1))};
+    auto* manager = MaterialManager::getInstance();
+
+    std::vector<std::string> uniqueNames{};
+    std::vector<std::string> sharedNames{};
+    for (uint32_t i = 0; i < stressItemCount; ++i) {
+        uniqueNames.emplace_back("registryStress_unique_" + std::to_string(i));
+        if (i % 4 == 0)
+            sharedNames.emplace_back("registryStress_shared_" + std::to_string(i / 4));
+    }
+
+    std::atomic<uint32_t> errorCount{0};
+    while (state.keepRunning()) {
+        JobSystem::getInstance().parallelFor(stressItemCount, 64, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i) {
+                //  items sharing a name are spread over the range, so different threads race on it
+                const std::string& sharedName = sharedNames[(i * lookupStride) % sharedNames.size()];
+
+                std::shared_ptr<Material> unique = manager->registerResource(uniqueNames[i]);
+                std::shared_ptr<Material> shared = manager->getOrRegisterResource(sharedName);
+                const ResourceHandle handle = unique->getHandle();
+
+                bool isValid = manager->resolve(handle) == unique.get() && manager->resolve(shared->getHandle()) == shared.get() &&
+                               manager->getResource(std::string_view{uniqueNames[i]}) == unique;
+
+                unique.reset();
+                isValid = isValid && manager->resolve(handle) == nullptr;
+
+                if (!isValid)
+                    errorCount.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    //  every item registers and frees two resources
+    state.setItemsProcessed(state.getIterations() * stressItemCount * 2);
+    state.setCounter("errors", errorCount.load());
+}
+DP_BENCHMARK(registerAndFreeParallel).argsProduct({{1024, 65536}, {1, 2, 4, 8}});
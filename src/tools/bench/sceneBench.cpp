@@ -0,0 +1,126 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include <vector>
+
+#include "benchmark.h"
+#include "benchFixtures.h"
+#include "../../scene/transform.h"
+
+namespace {
+    //  rays per iteration of castRays, a grid over the screen
+    constexpr uint32_t rayGridSize{16};
+}
+
+//  args: transforms, without observers, the matrix math alone
+void applyTransform(BenchmarkState& state) {
+    std::vector<Transform> transforms(static_cast<size_t>(state.getArg(0)));
+
+    float angle{0.0f};
+    while (state.keepRunning()) {
+        for (auto& transform : transforms)
+            transform.setRotation({angle, 2.0f * angle, 0.0f});
+
+        doNotOptimize(transforms.back().getModelMat());
+        angle += 1.0f;
+    }
+
+    state.setItemsProcessed(state.getIterations() * transforms.size());
+}
+DP_BENCHMARK(applyTransform).args({1}).args({1024}).args({65536});
+
+//  args: instances, every transform notifies the scene, which marks the mesh for the next refit
+void applyTransformObserved(BenchmarkState& state) {
+    Scene& scene = BenchScene::get(BenchScene::getInstanceParams(state.getArg(0)));
+
+    while (state.keepRunning()) {
+        for (const auto& mesh : scene.getMeshes())
+            mesh->getTransform().rotate({0.0f, 1.0f, 0.0f});
+
+        //  the refit is measured by cullScene
+        state.pauseTiming();
+        scene.cullMeshes();
+        state.resumeTiming();
+    }
+
+    state.setItemsProcessed(state.getIterations() * scene.getMeshes().size());
+}
+DP_BENCHMARK(applyTransformObserved).args({256}).args({4096}).args({16384}).requiresDevice();
+
+//  args: instances, percentage of them moved before every cull
+void cullScene(BenchmarkState& state) {
+    Scene& scene = BenchScene::get(BenchScene::getInstanceParams(state.getArg(0)));
+    const auto& meshes = scene.getMeshes();
+    const auto movedCount = static_cast<uint32_t>(meshes.size() * state.getArg(1) / 100);
+
+    //  moving back and forth keeps the grid in place however many iterations run
+    float offset{0.1f};
+    while (state.keepRunning()) {
+        state.pauseTiming();
+        for (uint32_t i = 0; i < movedCount; ++i)
+            meshes[i]->getTransform().translate({0.0f, offset, 0.0f});
+        offset = -offset;
+        state.resumeTiming();
+
+        const std::vector<uint32_t>& visibleMeshes = scene.cullMeshes();
+        doNotOptimize(visibleMeshes.size());
+    }
+
+    state.setItemsProcessed(state.getIterations() * meshes.size());
+    state.setCounter("visible", static_cast<double>(scene.cullMeshes().size()));
+}
+DP_BENCHMARK(cullScene).argsProduct({{256, 4096, 16384, 100000}, {0, 10, 100}}).requiresDevice();
+
+//  args: instances, rays through a grid over the screen against the mesh BVHs, what picking does on every click
+void castRays(BenchmarkState& state) {
+    Scene& scene = BenchScene::get(BenchScene::getInstanceParams(state.getArg(0)));
+
+    std::vector<Ray> rays{};
+    for (uint32_t y = 0; y < rayGridSize; ++y) {
+        for (uint32_t x = 0; x < rayGridSize; ++x) {
+            glm::vec2 ndc = (glm::vec2{x, y} + 0.5f) / static_cast<float>(rayGridSize) * 2.0f - 1.0f;
+            rays.emplace_back(scene.getCamera().getRay(ndc));
+        }
+    }
+
+    uint32_t hitCount{0};
+    while (state.keepRunning()) {
+        hitCount = 0;
+        for (const Ray& ray : rays)
+            hitCount += scene.castRay(ray).has_value() ? 1 : 0;
+    }
+
+    state.setItemsProcessed(state.getIterations() * rays.size());
+    state.setCounter("hitRatio", static_cast<double>(hitCount) / static_cast<double>(rays.size()));
+}
+DP_BENCHMARK(castRays).args({256}).args({4096}).args({16384}).requiresDevice();
+
+//  args: materials, copies into the engine's material data, frames pick them up when they are recorded
+void updateMaterials(BenchmarkState& state) {
+    const auto& materials = BenchScene::getMaterials(static_cast<uint32_t>(state.getArg(0)));
+
+    while (state.keepRunning()) {
+        for (const auto& material : materials)
+            material->updateUBO();
+    }
+
+    state.setItemsProcessed(state.getIterations() * materials.size());
+}
+DP_BENCHMARK(updateMaterials).args({16}).args({1024}).args({16384});
+
+//  args: materials, threads, all of them share the lock guarding the material data
+void updateMaterialsParallel(BenchmarkState& state) {
+    const auto& materials = BenchScene::getMaterials(static_cast<uint32_t>(state.getArg(0)));
+    WorkerCountScope workers{static_cast<uint32_t>(state.getArg(1))};
+
+    while (state.keepRunning()) {
+        JobSystem::getInstance().parallelFor(static_cast<uint32_t>(materials.size()), 64, [&](uint32_t begin, uint32_t end) {
+            for (uint32_t i = begin; i < end; ++i)
+                materials[i]->updateUBO();
+        });
+    }
+
+    state.setItemsProcessed(state.getIterations() * materials.size());
+}
+DP_BENCHMARK(updateMaterialsParallel).argsProduct({{1024, 16384}, {1, 2, 4, 8}});
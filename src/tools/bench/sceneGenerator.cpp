@@ -0,0 +1,301 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "sceneGenerator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <filesystem>
+#include <span>
+
+#include <assimp/material.h>
+#include <glm/gtc/constants.hpp>
+
+#include "../../engine/engine.h"
+#include "../../engine/imageWriter.h"
+#include "../../engine/managers/resourceManager.h"
+#include "../../engine/vk/uploadBatch.h"
+
+namespace {
+    //  independent random streams, so changing how one property is generated doesn't change the others
+    enum RandomStream : uint32_t {
+        wobbleFrequency,
+        wobblePhase,
+        wobbleAmplitude,
+        albedoRed,
+        albedoGreen,
+        albedoBlue,
+        shininess,
+        textureColor,
+        rotation,
+        textureNoise
+    };
+}
+
+SceneGenerator::SceneGenerator(const Params& params) : params_(params) {
+    //  every instance needs a mesh and a material, a sphere needs at least a few rings
+    params_.meshCount = std::max(params_.meshCount, 1u);
+    params_.materialCount = std::max(params_.materialCount, 1u);
+    params_.subdivisions = std::max(params_.subdivisions, 2u);
+}
+
+float SceneGenerator::random(uint32_t stream, uint32_t index) const {
+    //  PCG hash, unlike the standard distributions it gives the same numbers with every standard library
+    uint32_t state = params_.seed * 0x9E3779B9u ^ stream * 0x85EBCA6Bu ^ index * 0xC2B2AE35u;
+    state = state * 747796405u + 2891336453u;
+    uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+    word = (word >> 22u) ^ word;
+
+    return static_cast<float>(word >> 8) * (1.0f / 16777216.0f);
+}
+
+std::string SceneGenerator::nextNamePrefix() {
+    return "generated_" + std::to_string(generatedCount_++) + "/";
+}
+
+uint32_t SceneGenerator::getGridSide() const {
+    return std::max(static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<double>(params_.instanceCount)))), 1u);
+}
+
+glm::vec3 SceneGenerator::getInstancePosition(uint32_t index) const {
+    const uint32_t side = getGridSide();
+    return glm::vec3{index % side, (index / side) % side, index / (side * side)} * instanceSpacing;
+}
+
+void SceneGenerator::generateGeometry(uint32_t index, std::vector<Vertex3D>& vertices, std::vector<uint32_t>& indices) const {
+    index %= params_.meshCount;
+
+    const uint32_t rings = params_.subdivisions;
+    const uint32_t segments = 2 * rings;
+
+    //  waves running around the sphere, the normals are left radial as only their cost matters
+    const float frequency = 2.0f + std::floor(random(wobbleFrequency, index) * 5.0f);
+    const float phase = random(wobblePhase, index) * glm::two_pi<float>();
+    const float amplitude = 0.25f * random(wobbleAmplitude, index);
+
+    vertices.clear();
+    vertices.reserve((rings + 1) * (segments + 1));
+    for (uint32_t ring = 0; ring <= rings; ++ring) {
+        const float theta = glm::pi<float>() * static_cast<float>(ring) / static_cast<float>(rings);
+
+        for (uint32_t segment = 0; segment <= segments; ++segment) {
+            const float phi = glm::two_pi<float>() * static_cast<float>(segment) / static_cast<float>(segments);
+
+            const glm::vec3 direction{std::sin(theta) * std::cos(phi), std::cos(theta), std::sin(theta) * std::sin(phi)};
+            const float radius = 1.0f + amplitude * std::sin(frequency * phi + phase) * std::sin(frequency * theta);
+
+            vertices.emplace_back(Vertex3D{
+                .position = direction * radius,
+                .normal = direction,
+                .tangent = {-std::sin(phi), 0.0f, std::cos(phi)},
+                .texCoord = {static_cast<float>(segment) / static_cast<float>(segments), static_cast<float>(ring) / static_cast<float>(rings)}
+            });
+        }
+    }
+
+    //  two counter clockwise triangles per quad, the ones at the poles are degenerate like in any UV sphere
+    indices.clear();
+    indices.reserve(6 * rings * segments);
+    for (uint32_t ring = 0; ring < rings; ++ring) {
+        for (uint32_t segment = 0; segment < segments; ++segment) {
+            const uint32_t top = ring * (segments + 1) + segment;
+            const uint32_t bottom = top + segments + 1;
+
+            indices.insert(indices.end(), {top, top + 1, bottom});
+            indices.insert(indices.end(), {top + 1, bottom + 1, bottom});
+        }
+    }
+}
+
+MeshCache::MeshData SceneGenerator::generateMesh(uint32_t index) const {
+    MeshCache::MeshData meshData{
+        .name = "mesh_" + std::to_string(index % params_.meshCount),
+        .materialIndex = index % params_.materialCount
+    };
+
+    generateGeometry(index, meshData.vertices, meshData.indices);
+    return meshData;
+}
+
+std::unique_ptr<aiScene> SceneGenerator::generateAiScene() const {
+    auto scene = std::make_unique<aiScene>();
+    scene->mRootNode = new aiNode();
+
+    //  the scene frees everything below with delete[] and delete
+    scene->mNumMeshes = params_.meshCount;
+    scene->mMeshes = new aiMesh*[params_.meshCount];
+
+    std::vector<Vertex3D> vertices{};
+    std::vector<uint32_t> indices{};
+    for (uint32_t i = 0; i < params_.meshCount; ++i) {
+        generateGeometry(i, vertices, indices);
+
+        auto* mesh = new aiMesh();
+        scene->mMeshes[i] = mesh;
+
+        mesh->mName = aiString{"mesh_" + std::to_string(i)};
+        mesh->mPrimitiveTypes = aiPrimitiveType_TRIANGLE;
+        mesh->mMaterialIndex = i % params_.materialCount;
+
+        mesh->mNumVertices = static_cast<uint32_t>(vertices.size());
+        mesh->mVertices = new aiVector3D[vertices.size()];
+        mesh->mNormals = new aiVector3D[vertices.size()];
+        mesh->mTangents = new aiVector3D[vertices.size()];
+        mesh->mTextureCoords[0] = new aiVector3D[vertices.size()];
+        mesh->mNumUVComponents[0] = 2;
+
+        for (size_t j = 0; j < vertices.size(); ++j) {
+            const Vertex3D& vertex = vertices[j];
+            mesh->mVertices[j] = {vertex.position.x, vertex.position.y, vertex.position.z};
+            mesh->mNormals[j] = {vertex.normal.x, vertex.normal.y, vertex.normal.z};
+            mesh->mTangents[j] = {vertex.tangent.x, vertex.tangent.y, vertex.tangent.z};
+            mesh->mTextureCoords[0][j] = {vertex.texCoord.x, vertex.texCoord.y, 0.0f};
+        }
+
+        mesh->mNumFaces = static_cast<uint32_t>(indices.size() / 3);
+        mesh->mFaces = new aiFace[mesh->mNumFaces];
+
+        for (uint32_t j = 0; j < mesh->mNumFaces; ++j) {
+            aiFace& face = mesh->mFaces[j];
+            face.mNumIndices = 3;
+            face.mIndices = new unsigned int[3]{indices[3 * j], indices[3 * j + 1], indices[3 * j + 2]};
+        }
+    }
+
+    scene->mNumMaterials = params_.materialCount;
+    scene->mMaterials = new aiMaterial*[params_.materialCount];
+
+    for (uint32_t i = 0; i < params_.materialCount; ++i) {
+        auto* material = new aiMaterial();
+        scene->mMaterials[i] = material;
+
+        aiString name{"material_" + std::to_string(i)};
+        material->AddProperty(&name, AI_MATKEY_NAME);
+
+        aiColor3D diffuse{random(albedoRed, i), random(albedoGreen, i), random(albedoBlue, i)};
+        material->AddProperty(&diffuse, 1, AI_MATKEY_COLOR_DIFFUSE);
+
+        aiColor3D specular{0.04f, 0.04f, 0.04f};
+        material->AddProperty(&specular, 1, AI_MATKEY_COLOR_SPECULAR);
+
+        float materialShininess = 8.0f + random(shininess, i) * 120.0f;
+        material->AddProperty(&materialShininess, 1, AI_MATKEY_SHININESS);
+
+        if (params_.textureCount > 0) {
+            aiString textureName{"texture_" + std::to_string(i % params_.textureCount) + ".png"};
+            material->AddProperty(&textureName, AI_MATKEY_TEXTURE(aiTextureType_DIFFUSE, 0));
+        }
+    }
+
+    return scene;
+}
+
+std::vector<std::string> SceneGenerator::writeTextureFiles(const std::string& directory, uint32_t size) const {
+    std::filesystem::create_directories(directory);
+
+    std::vector<std::string> fileNames{};
+    std::vector<uint8_t> pixels(static_cast<size_t>(size) * size * 4);
+
+    for (uint32_t i = 0; i < params_.textureCount; ++i) {
+        std::string fileName = "texture_" + std::to_string(params_.seed) + "_" + std::to_string(i) + "_" + std::to_string(size) + ".png";
+        fileNames.emplace_back(fileName);
+
+        if (std::filesystem::exists(directory + fileName))
+            continue;
+
+        //  a gradient over the texture's color with some noise, so that the files compress about as well as photos do
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                uint8_t* pixel = &pixels[(static_cast<size_t>(y) * size + x) * 4];
+                const float gradient = 0.5f + 0.5f * static_cast<float>(x + y) / static_cast<float>(2 * size);
+
+                for (uint32_t c = 0; c < 3; ++c) {
+                    const float noise = random(textureNoise, (i * size + y) * size * 3 + x * 3 + c) - 0.5f;
+                    pixel[c] = static_cast<uint8_t>(std::clamp((random(textureColor, 3 * i + c) * gradient + 0.1f * noise) * 255.0f, 0.0f, 255.0f));
+                }
+                pixel[3] = 255;
+            }
+        }
+
+        ImageWriter::writeBgra8(directory + fileName, pixels.data(), size, size, size * 4);
+    }
+
+    return fileNames;
+}
+
+std::vector<std::shared_ptr<Material>> SceneGenerator::generateMaterials(const std::vector<std::shared_ptr<Texture>>& textures) const {
+    const std::string prefix = nextNamePrefix();
+
+    std::vector<std::shared_ptr<Material>> materials{};
+    materials.reserve(params_.materialCount);
+
+    for (uint32_t i = 0; i < params_.materialCount; ++i) {
+        auto material = MaterialManager::getInstance()->registerResource(prefix + "material_" + std::to_string(i));
+
+        material->setDiffuseAlbedo({random(albedoRed, i), random(albedoGreen, i), random(albedoBlue, i)});
+        material->setSpecularAlbedo(glm::vec3{0.04f});
+        material->setShininess(8.0f + random(shininess, i) * 120.0f);
+        material->setIor(1.5f);
+
+        if (!textures.empty())
+            material->setTexture(textures[i % textures.size()], Material::TextureMapSlot::diffuseMapSlot);
+
+        material->updateUBO();
+        materials.emplace_back(std::move(material));
+    }
+
+    return materials;
+}
+
+std::shared_ptr<Scene> SceneGenerator::generateScene() const {
+    const std::string prefix = nextNamePrefix();
+
+    std::vector<std::shared_ptr<Texture>> textures{};
+    textures.reserve(params_.textureCount);
+    for (uint32_t i = 0; i < params_.textureCount; ++i) {
+        const glm::vec<4, uint8_t> color{
+            static_cast<uint8_t>(random(textureColor, 3 * i) * 255.0f),
+            static_cast<uint8_t>(random(textureColor, 3 * i + 1) * 255.0f),
+            static_cast<uint8_t>(random(textureColor, 3 * i + 2) * 255.0f),
+            255
+        };
+        textures.emplace_back(Texture::createDummy(prefix + "texture_" + std::to_string(i), color));
+    }
+
+    std::vector<std::shared_ptr<Material>> materials = generateMaterials(textures);
+
+    std::vector<MeshCache::MeshData> geometries{};
+    geometries.reserve(params_.meshCount);
+    for (uint32_t i = 0; i < params_.meshCount; ++i)
+        geometries.emplace_back(generateMesh(i));
+
+    //  all instances are uploaded in a single batch, like the meshes of a model
+    UploadBatch uploadBatch{Engine::getInstance().getStagingRing()};
+
+    std::vector<std::shared_ptr<Mesh>> meshes{};
+    meshes.reserve(params_.instanceCount);
+    for (uint32_t i = 0; i < params_.instanceCount; ++i) {
+        const MeshCache::MeshData& geometry = geometries[i % params_.meshCount];
+
+        auto mesh = MeshManager::getInstance()->registerResource(prefix + "instance_" + std::to_string(i), std::span<const Vertex3D>{geometry.vertices},
+                                                                 std::span<const uint32_t>{geometry.indices}, materials[i % params_.materialCount]);
+
+        Transform& transform = mesh->getTransform();
+        transform.setTranslation(getInstancePosition(i));
+        transform.setRotation(glm::vec3{random(rotation, 3 * i), random(rotation, 3 * i + 1), random(rotation, 3 * i + 2)} * 360.0f);
+
+        mesh->stage(uploadBatch);
+        meshes.emplace_back(std::move(mesh));
+    }
+
+    uploadBatch.submitAndWait();
+
+    const float center = static_cast<float>(getGridSide() - 1) * instanceSpacing * 0.5f;
+    auto camera = std::make_shared<Camera>(glm::vec3{center, center, -instanceSpacing}, glm::vec3{center});
+
+    //  the sky pass always samples the scene's sky
+    auto sky = Texture::createDummy(prefix + "sky", {128, 160, 192, 255});
+
+    return std::make_shared<Scene>(std::move(meshes), std::move(camera), std::move(sky));
+}
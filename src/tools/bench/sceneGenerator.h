@@ -0,0 +1,99 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <assimp/scene.h>
+#include <glm/glm.hpp>
+
+#include "../../engine/meshCache.h"
+#include "../../scene/material.h"
+#include "../../scene/scene.h"
+#include "../../scene/texture.h"
+
+/**
+ * @brief builds deterministic scenes of any size, to measure how the engine scales instead of how it handles one model
+ *
+ * Meshes are UV spheres with a per mesh wobble so that no two of them have the same geometry. Instances are placed
+ * on a cubic grid with random rotations, each one is its own Mesh with its own copy of one of the unique geometries,
+ * as the engine has no shared geometry. Materials cycle through the textures, instances through the meshes and the
+ * materials. The same parameters always produce the same scene.
+ */
+class SceneGenerator {
+public:
+    struct Params {
+        uint32_t meshCount{16};
+        uint32_t materialCount{16};
+
+        //  1x1 textures, they cost a bindless slot and an upload each but next to no memory
+        uint32_t textureCount{16};
+        uint32_t instanceCount{256};
+
+        //  rings of every sphere, it has twice as many segments and 4 * subdivisions^2 triangles
+        uint32_t subdivisions{8};
+
+        uint32_t seed{1};
+
+        bool operator==(const Params&) const = default;
+    };
+
+    explicit SceneGenerator(const Params& params);
+
+    /**
+     * @brief the unique meshes and materials as the importer would return them, materials reference texture files that don't exist
+     */
+    [[nodiscard]] std::unique_ptr<aiScene> generateAiScene() const;
+
+    /**
+     * @brief geometry of one of the unique meshes, index is taken modulo meshCount
+     */
+    [[nodiscard]] MeshCache::MeshData generateMesh(uint32_t index) const;
+
+    /**
+     * @brief writes textureCount noisy PNGs of size x size pixels into the directory, files already there are kept
+     * @return the file names relative to the directory
+     */
+    [[nodiscard]] std::vector<std::string> writeTextureFiles(const std::string& directory, uint32_t size) const;
+
+    /**
+     * @brief registers the materials and sets their textures, without textures no engine resources are touched
+     */
+    [[nodiscard]] std::vector<std::shared_ptr<Material>> generateMaterials(const std::vector<std::shared_ptr<Texture>>& textures = {}) const;
+
+    /**
+     * @brief registers and uploads textures, materials and instances and puts them into a scene, the engine has to be initialized
+     *
+     * The camera looks from the middle of the grid's front face into it, so culling always has something to reject.
+     * The sky is a single color.
+     */
+    [[nodiscard]] std::shared_ptr<Scene> generateScene() const;
+
+    [[nodiscard]] const Params& getParams() const { return params_; }
+
+    //  triangles of one unique mesh
+    [[nodiscard]] uint32_t getTriangleCount() const { return 4 * params_.subdivisions * params_.subdivisions; }
+
+    //  distance between the centers of neighboring instances, the spheres have a radius of at most 1.25
+    static constexpr float instanceSpacing{3.0f};
+
+private:
+    void generateGeometry(uint32_t index, std::vector<Vertex3D>& vertices, std::vector<uint32_t>& indices) const;
+
+    [[nodiscard]] glm::vec3 getInstancePosition(uint32_t index) const;
+    [[nodiscard]] uint32_t getGridSide() const;
+
+    //  uniform in [0, 1), the same for the same stream and index
+    [[nodiscard]] float random(uint32_t stream, uint32_t index) const;
+
+    //  resource names have to be unique, every call gets its own prefix so that generated resources never collide
+    static std::string nextNamePrefix();
+
+    Params params_{};
+
+    inline static uint32_t generatedCount_{0};
+};
@@ -0,0 +1,136 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+#include "benchmark.h"
+#include "benchFixtures.h"
+#include "../../engine/engine.h"
+#include "../../engine/vk/uploadBatch.h"
+
+namespace {
+    constexpr int64_t kib{1024};
+    constexpr int64_t mib{1024 * 1024};
+
+    /**
+     * @brief device local buffer the uploads are copied into, like the blocks of the geometry arena
+     */
+    class DestinationBuffer {
+    public:
+        explicit DestinationBuffer(vk::DeviceSize size)
+            : buffer_(VkUtils::createBufferVMA(size, vk::BufferUsageFlagBits::eTransferDst)) {}
+
+        ~DestinationBuffer() { VkUtils::destroyBufferVMA(std::move(buffer_)); }
+
+        DestinationBuffer(const DestinationBuffer&) = delete;
+        DestinationBuffer& operator=(const DestinationBuffer&) = delete;
+
+        [[nodiscard]] const VkUtils::BufferAlloc& get() const { return buffer_; }
+
+    private:
+        VkUtils::BufferAlloc buffer_{};
+    };
+
+    std::vector<uint8_t> getSourceBytes(size_t byteCount) {
+        std::vector<uint8_t> bytes(byteCount);
+        for (size_t i = 0; i < byteCount; ++i)
+            bytes[i] = static_cast<uint8_t>(i * 7 + i / 256);
+        return bytes;
+    }
+
+    uint64_t getUploadCount(vk::DeviceSize uploadSize, vk::DeviceSize totalSize) {
+        return (totalSize + uploadSize - 1) / uploadSize;
+    }
+
+    //  upload sizes in KiB, from a material's constants to a large texture level
+    const std::vector<int64_t> uploadSizes{4, 64, 1024, 16384};
+}
+
+//  args: KiB per upload, MiB per iteration, everything staged through the ring and recorded into one batch
+//  the larger total doesn't fit into the ring, the batch then waits for older submissions and submits what it has
+void uploadBuffers(BenchmarkState& state) {
+    BenchScene::initEngine();
+    StagingRing& ring = Engine::getInstance().getStagingRing();
+
+    const auto uploadSize = static_cast<vk::DeviceSize>(state.getArg(0) * kib);
+    const auto totalSize = static_cast<vk::DeviceSize>(state.getArg(1) * mib);
+    const std::vector<uint8_t> source = getSourceBytes(totalSize);
+    DestinationBuffer destination{totalSize};
+
+    ring.waitIdle();
+    const StagingRing::Stats previousStats = ring.getStats();
+
+    while (state.keepRunning()) {
+        UploadBatch batch{ring};
+        for (vk::DeviceSize offset = 0; offset < totalSize; offset += uploadSize)
+            batch.uploadBuffer(source.data() + offset, std::min(uploadSize, totalSize - offset), destination.get(), offset);
+        batch.submitAndWait();
+    }
+
+    ring.waitIdle();
+    const StagingRing::Stats& stats = ring.getStats();
+    const auto iterations = static_cast<double>(std::max<uint64_t>(state.getIterations(), 1));
+
+    state.setItemsProcessed(state.getIterations() * getUploadCount(uploadSize, totalSize));
+    state.setBytesProcessed(state.getIterations() * totalSize);
+    state.setCounter("submissions", static_cast<double>(stats.submissions - previousStats.submissions) / iterations);
+    state.setCounter("stalls", static_cast<double>(stats.stalls - previousStats.stalls) / iterations);
+}
+DP_BENCHMARK(uploadBuffers).argsProduct({uploadSizes, {16, 256}}).requiresDevice();
+
+//  args: KiB per upload, MiB per iteration, the baseline of uploadBuffers, a staging buffer and a waited on submission per upload
+void uploadBuffersSingleTime(BenchmarkState& state) {
+    BenchScene::initEngine();
+
+    const auto uploadSize = static_cast<vk::DeviceSize>(state.getArg(0) * kib);
+    const auto totalSize = static_cast<vk::DeviceSize>(state.getArg(1) * mib);
+    const std::vector<uint8_t> source = getSourceBytes(totalSize);
+    DestinationBuffer destination{totalSize};
+
+    while (state.keepRunning()) {
+        for (vk::DeviceSize offset = 0; offset < totalSize; offset += uploadSize) {
+            const vk::DeviceSize size = std::min(uploadSize, totalSize - offset);
+
+            VkUtils::BufferAlloc staging = VkUtils::createBufferVMA(size, vk::BufferUsageFlagBits::eTransferSrc, VkUtils::stagingAllocFlagsVMA);
+            std::memcpy(staging.allocationInfo.pMappedData, source.data() + offset, size);
+
+            VkUtils::copyBuffer(staging, destination.get(), vk::BufferCopy{.srcOffset = 0, .dstOffset = offset, .size = size});
+            VkUtils::destroyBufferVMA(std::move(staging));
+        }
+    }
+
+    state.setItemsProcessed(state.getIterations() * getUploadCount(uploadSize, totalSize));
+    state.setBytesProcessed(state.getIterations() * totalSize);
+    state.setCounter("submissions", static_cast<double>(getUploadCount(uploadSize, totalSize)));
+}
+//  4 KiB uploads would mean 4096 waited on submissions per iteration
+DP_BENCHMARK(uploadBuffersSingleTime).argsProduct({{64, 1024, 16384}, {16}}).requiresDevice();
+
+//  args: instances, the geometry of a whole scene restaged in one batch, what loadModel does with the meshes it imported
+void uploadSceneMeshes(BenchmarkState& state) {
+    Scene& scene = BenchScene::get(BenchScene::getInstanceParams(state.getArg(0)));
+    StagingRing& ring = Engine::getInstance().getStagingRing();
+
+    ring.waitIdle();
+    const StagingRing::Stats previousStats = ring.getStats();
+
+    while (state.keepRunning()) {
+        UploadBatch batch{ring};
+        for (const auto& mesh : scene.getMeshes())
+            mesh->stage(batch);
+        batch.submitAndWait();
+    }
+
+    ring.waitIdle();
+    const StagingRing::Stats& stats = ring.getStats();
+    const auto iterations = static_cast<double>(std::max<uint64_t>(state.getIterations(), 1));
+
+    state.setItemsProcessed(state.getIterations() * scene.getMeshes().size());
+    state.setBytesProcessed(stats.stagedBytes - previousStats.stagedBytes);
+    state.setCounter("submissions", static_cast<double>(stats.submissions - previousStats.submissions) / iterations);
+    state.setCounter("stalls", static_cast<double>(stats.stalls - previousStats.stalls) / iterations);
+}
+DP_BENCHMARK(uploadSceneMeshes).args({256}).args({4096}).args({16384}).requiresDevice();
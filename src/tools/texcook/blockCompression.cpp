@@ -0,0 +1,387 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "blockCompression.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace {
+    using Color = std::array<float, 4>;
+
+    constexpr std::array<uint32_t, 16> bc7Weights{0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+    float squaredError(const Color& a, const Color& b, uint32_t channelCount) {
+        float error{0.0f};
+        for (uint32_t c = 0; c < channelCount; ++c)
+            error += (a[c] - b[c]) * (a[c] - b[c]);
+        return error;
+    }
+
+    Color getTexel(const uint8_t* block, uint32_t texel) {
+        const uint8_t* t = block + texel * 4;
+        return {static_cast<float>(t[0]), static_cast<float>(t[1]), static_cast<float>(t[2]), static_cast<float>(t[3])};
+    }
+
+    /**
+     * @brief fits the endpoints to the extremes of the block along its principal axis
+     */
+    void fitPrincipalAxis(const uint8_t* block, uint32_t channelCount, Color& endpoint0, Color& endpoint1) {
+        Color mean{};
+        for (uint32_t i = 0; i < 16; ++i) {
+            Color texel = getTexel(block, i);
+            for (uint32_t c = 0; c < channelCount; ++c)
+                mean[c] += texel[c] / 16.0f;
+        }
+
+        std::array<std::array<float, 4>, 4> covariance{};
+        for (uint32_t i = 0; i < 16; ++i) {
+            Color texel = getTexel(block, i);
+            for (uint32_t a = 0; a < channelCount; ++a)
+                for (uint32_t b = 0; b < channelCount; ++b)
+                    covariance[a][b] += (texel[a] - mean[a]) * (texel[b] - mean[b]);
+        }
+
+        //  power iteration converges quickly enough for 4x4 blocks
+        Color axis{1.0f, 1.0f, 1.0f, 1.0f};
+        for (uint32_t iteration = 0; iteration < 8; ++iteration) {
+            Color next{};
+            for (uint32_t a = 0; a < channelCount; ++a)
+                for (uint32_t b = 0; b < channelCount; ++b)
+                    next[a] += covariance[a][b] * axis[b];
+
+            float length = std::sqrt(squaredError(next, Color{}, channelCount));
+            if (length < 1e-6f)
+                break;
+
+            for (uint32_t c = 0; c < channelCount; ++c)
+                axis[c] = next[c] / length;
+        }
+
+        float minT{std::numeric_limits<float>::max()}, maxT{std::numeric_limits<float>::lowest()};
+        for (uint32_t i = 0; i < 16; ++i) {
+            Color texel = getTexel(block, i);
+            float t{0.0f};
+            for (uint32_t c = 0; c < channelCount; ++c)
+                t += (texel[c] - mean[c]) * axis[c];
+            minT = std::min(minT, t);
+            maxT = std::max(maxT, t);
+        }
+
+        for (uint32_t c = 0; c < channelCount; ++c) {
+            endpoint0[c] = std::clamp(mean[c] + axis[c] * minT, 0.0f, 255.0f);
+            endpoint1[c] = std::clamp(mean[c] + axis[c] * maxT, 0.0f, 255.0f);
+        }
+    }
+
+    /**
+     * @brief least squares fit of the endpoints to the texels given the interpolation factor of every texel
+     * @return false if the system is degenerate (all texels use the same factor)
+     */
+    bool refineEndpoints(const uint8_t* block, uint32_t channelCount, const std::array<float, 16>& factors, Color& endpoint0, Color& endpoint1) {
+        float a{0.0f}, b{0.0f}, c{0.0f};
+        Color x0{}, x1{};
+
+        for (uint32_t i = 0; i < 16; ++i) {
+            float t = factors[i];
+            a += (1.0f - t) * (1.0f - t);
+            b += (1.0f - t) * t;
+            c += t * t;
+
+            Color texel = getTexel(block, i);
+            for (uint32_t ch = 0; ch < channelCount; ++ch) {
+                x0[ch] += (1.0f - t) * texel[ch];
+                x1[ch] += t * texel[ch];
+            }
+        }
+
+        float determinant = a * c - b * b;
+        if (std::abs(determinant) < 1e-6f)
+            return false;
+
+        for (uint32_t ch = 0; ch < channelCount; ++ch) {
+            endpoint0[ch] = std::clamp((c * x0[ch] - b * x1[ch]) / determinant, 0.0f, 255.0f);
+            endpoint1[ch] = std::clamp((a * x1[ch] - b * x0[ch]) / determinant, 0.0f, 255.0f);
+        }
+        return true;
+    }
+
+    //====================================================
+    //  BC1
+
+    uint16_t packRGB565(const Color& color) {
+        auto r = static_cast<uint16_t>(std::lround(color[0] * 31.0f / 255.0f));
+        auto g = static_cast<uint16_t>(std::lround(color[1] * 63.0f / 255.0f));
+        auto b = static_cast<uint16_t>(std::lround(color[2] * 31.0f / 255.0f));
+        return static_cast<uint16_t>(r << 11 | g << 5 | b);
+    }
+
+    Color unpackRGB565(uint16_t packed) {
+        uint32_t r = packed >> 11 & 31, g = packed >> 5 & 63, b = packed & 31;
+        return {static_cast<float>(r << 3 | r >> 2), static_cast<float>(g << 2 | g >> 4), static_cast<float>(b << 3 | b >> 2), 255.0f};
+    }
+
+    struct BC1Result {
+        uint16_t color0{};
+        uint16_t color1{};
+        uint32_t indices{};
+        float error{};
+        std::array<float, 16> factors{};
+    };
+
+    BC1Result quantizeBC1(const uint8_t* block, const Color& endpoint0, const Color& endpoint1) {
+        BC1Result result{.color0 = packRGB565(endpoint0), .color1 = packRGB565(endpoint1)};
+
+        //  color0 > color1 selects the four color mode, equal endpoints fall into the three color mode where index 0 is color0
+        if (result.color0 < result.color1)
+            std::swap(result.color0, result.color1);
+
+        Color c0 = unpackRGB565(result.color0), c1 = unpackRGB565(result.color1);
+        std::array<Color, 4> palette{c0, c1, c0, c0};
+        std::array<float, 4> paletteFactors{0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+        for (uint32_t c = 0; c < 3; ++c) {
+            palette[2][c] = (2.0f * c0[c] + c1[c]) / 3.0f;
+            palette[3][c] = (c0[c] + 2.0f * c1[c]) / 3.0f;
+        }
+        uint32_t paletteSize = result.color0 == result.color1 ? 1 : 4;
+
+        for (uint32_t i = 0; i < 16; ++i) {
+            Color texel = getTexel(block, i);
+
+            uint32_t bestIndex{0};
+            float bestError{std::numeric_limits<float>::max()};
+            for (uint32_t p = 0; p < paletteSize; ++p) {
+                float error = squaredError(texel, palette[p], 3);
+                if (error < bestError) {
+                    bestError = error;
+                    bestIndex = p;
+                }
+            }
+
+            result.indices |= bestIndex << (2 * i);
+            result.error += bestError;
+            result.factors[i] = paletteFactors[bestIndex];
+        }
+
+        return result;
+    }
+
+    //====================================================
+    //  BC7 mode 6
+
+    struct BC7Endpoint {
+        std::array<uint32_t, 4> color{};   // 7 bits per channel
+        uint32_t pBit{};
+
+        [[nodiscard]] uint32_t expand(uint32_t channel) const { return color[channel] << 1 | pBit; }
+    };
+
+    BC7Endpoint quantizeBC7Endpoint(const Color& endpoint) {
+        BC7Endpoint best{};
+        float bestError{std::numeric_limits<float>::max()};
+
+        //  the shared p-bit is the lowest bit of every channel, pick whichever reconstructs the endpoint better
+        for (uint32_t pBit = 0; pBit < 2; ++pBit) {
+            BC7Endpoint candidate{.pBit = pBit};
+            float error{0.0f};
+            for (uint32_t c = 0; c < 4; ++c) {
+                candidate.color[c] = static_cast<uint32_t>(std::clamp(std::lround((endpoint[c] - static_cast<float>(pBit)) / 2.0f), 0l, 127l));
+                float difference = endpoint[c] - static_cast<float>(candidate.expand(c));
+                error += difference * difference;
+            }
+            if (error < bestError) {
+                bestError = error;
+                best = candidate;
+            }
+        }
+        return best;
+    }
+
+    struct BC7Result {
+        BC7Endpoint endpoint0{};
+        BC7Endpoint endpoint1{};
+        std::array<uint32_t, 16> indices{};
+        float error{};
+        std::array<float, 16> factors{};
+    };
+
+    BC7Result quantizeBC7(const uint8_t* block, const Color& endpoint0, const Color& endpoint1) {
+        BC7Result result{.endpoint0 = quantizeBC7Endpoint(endpoint0), .endpoint1 = quantizeBC7Endpoint(endpoint1)};
+
+        std::array<Color, 16> palette{};
+        for (uint32_t p = 0; p < 16; ++p) {
+            for (uint32_t c = 0; c < 4; ++c) {
+                uint32_t value = ((64 - bc7Weights[p]) * result.endpoint0.expand(c) + bc7Weights[p] * result.endpoint1.expand(c) + 32) >> 6;
+                palette[p][c] = static_cast<float>(value);
+            }
+        }
+
+        for (uint32_t i = 0; i < 16; ++i) {
+            Color texel = getTexel(block, i);
+
+            uint32_t bestIndex{0};
+            float bestError{std::numeric_limits<float>::max()};
+            for (uint32_t p = 0; p < 16; ++p) {
+                float error = squaredError(texel, palette[p], 4);
+                if (error < bestError) {
+                    bestError = error;
+                    bestIndex = p;
+                }
+            }
+
+            result.indices[i] = bestIndex;
+            result.error += bestError;
+            result.factors[i] = static_cast<float>(bc7Weights[bestIndex]) / 64.0f;
+        }
+
+        return result;
+    }
+
+    class BitWriter {
+    public:
+        explicit BitWriter(uint8_t* out) : out_(out) { std::memset(out_, 0, 16); }
+
+        void write(uint32_t value, uint32_t bitCount) {
+            for (uint32_t i = 0; i < bitCount; ++i, ++position_) {
+                if (value >> i & 1)
+                    out_[position_ / 8] |= static_cast<uint8_t>(1 << (position_ % 8));
+            }
+        }
+
+    private:
+        uint8_t* out_;
+        uint32_t position_{0};
+    };
+}
+
+std::vector<uint8_t> BlockCompression::compress(Format format, std::span<const uint8_t> rgba, uint32_t width, uint32_t height) {
+    uint32_t blocksX = (width + 3) / 4;
+    uint32_t blocksY = (height + 3) / 4;
+    uint32_t blockSize = getBlockSize(format);
+
+    std::vector<uint8_t> compressed(static_cast<size_t>(blocksX) * blocksY * blockSize);
+
+    #pragma omp parallel for
+    for (int by = 0; by < static_cast<int>(blocksY); ++by) {
+        std::array<uint8_t, 64> block{};
+
+        for (uint32_t bx = 0; bx < blocksX; ++bx) {
+            for (uint32_t y = 0; y < 4; ++y) {
+                for (uint32_t x = 0; x < 4; ++x) {
+                    uint32_t srcX = std::min(bx * 4 + x, width - 1);
+                    uint32_t srcY = std::min(static_cast<uint32_t>(by) * 4 + y, height - 1);
+                    std::memcpy(&block[(y * 4 + x) * 4], &rgba[(static_cast<size_t>(srcY) * width + srcX) * 4], 4);
+                }
+            }
+
+            uint8_t* out = &compressed[(static_cast<size_t>(by) * blocksX + bx) * blockSize];
+            switch (format) {
+                case Format::bc1: encodeBC1(block.data(), out); break;
+                case Format::bc5: encodeBC5(block.data(), out); break;
+                case Format::bc7: encodeBC7(block.data(), out); break;
+            }
+        }
+    }
+
+    return compressed;
+}
+
+void BlockCompression::encodeBC1(const uint8_t* block, uint8_t* out) {
+    Color endpoint0{}, endpoint1{};
+    fitPrincipalAxis(block, 3, endpoint0, endpoint1);
+
+    BC1Result result = quantizeBC1(block, endpoint0, endpoint1);
+
+    //  factors are relative to the ordered endpoints, refine them in the same order
+    Color ordered0 = unpackRGB565(result.color0), ordered1 = unpackRGB565(result.color1);
+    if (result.color0 != result.color1 && refineEndpoints(block, 3, result.factors, ordered0, ordered1)) {
+        BC1Result refined = quantizeBC1(block, ordered0, ordered1);
+        if (refined.error < result.error)
+            result = refined;
+    }
+
+    std::memcpy(out, &result.color0, sizeof(uint16_t));
+    std::memcpy(out + 2, &result.color1, sizeof(uint16_t));
+    std::memcpy(out + 4, &result.indices, sizeof(uint32_t));
+}
+
+void BlockCompression::encodeBC4(const uint8_t* block, uint32_t channel, uint8_t* out) {
+    uint8_t minValue{255}, maxValue{0};
+    for (uint32_t i = 0; i < 16; ++i) {
+        minValue = std::min(minValue, block[i * 4 + channel]);
+        maxValue = std::max(maxValue, block[i * 4 + channel]);
+    }
+
+    //  red0 > red1 selects the eight value mode, equal values fall into the six value mode where index 0 is red0
+    out[0] = maxValue;
+    out[1] = minValue;
+
+    std::array<int32_t, 8> palette{maxValue, minValue};
+    for (int32_t k = 1; k < 7; ++k)
+        palette[k + 1] = ((7 - k) * maxValue + k * minValue) / 7;
+
+    uint64_t indices{0};
+    if (maxValue != minValue) {
+        for (uint32_t i = 0; i < 16; ++i) {
+            int32_t value = block[i * 4 + channel];
+
+            uint64_t bestIndex{0};
+            int32_t bestError{std::numeric_limits<int32_t>::max()};
+            for (uint32_t p = 0; p < 8; ++p) {
+                int32_t error = std::abs(value - palette[p]);
+                if (error < bestError) {
+                    bestError = error;
+                    bestIndex = p;
+                }
+            }
+            indices |= bestIndex << (3 * i);
+        }
+    }
+
+    for (uint32_t i = 0; i < 6; ++i)
+        out[2 + i] = static_cast<uint8_t>(indices >> (8 * i));
+}
+
+void BlockCompression::encodeBC5(const uint8_t* block, uint8_t* out) {
+    encodeBC4(block, 0, out);
+    encodeBC4(block, 1, out + 8);
+}
+
+void BlockCompression::encodeBC7(const uint8_t* block, uint8_t* out) {
+    Color endpoint0{}, endpoint1{};
+    fitPrincipalAxis(block, 4, endpoint0, endpoint1);
+
+    BC7Result result = quantizeBC7(block, endpoint0, endpoint1);
+
+    if (refineEndpoints(block, 4, result.factors, endpoint0, endpoint1)) {
+        BC7Result refined = quantizeBC7(block, endpoint0, endpoint1);
+        if (refined.error < result.error)
+            result = refined;
+    }
+
+    //  the most significant bit of the first index is implied zero, swap the endpoints if it would be set
+    if (result.indices[0] >= 8) {
+        std::swap(result.endpoint0, result.endpoint1);
+        for (auto& index : result.indices)
+            index = 15 - index;
+    }
+
+    BitWriter writer{out};
+    writer.write(1 << 6, 7);
+
+    for (uint32_t c = 0; c < 4; ++c) {
+        writer.write(result.endpoint0.color[c], 7);
+        writer.write(result.endpoint1.color[c], 7);
+    }
+
+    writer.write(result.endpoint0.pBit, 1);
+    writer.write(result.endpoint1.pBit, 1);
+
+    writer.write(result.indices[0], 3);
+    for (uint32_t i = 1; i < 16; ++i)
+        writer.write(result.indices[i], 4);
+}
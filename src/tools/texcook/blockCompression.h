@@ -0,0 +1,42 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/**
+ * @brief BC1, BC5 and BC7 block encoders
+ *
+ * Endpoints are fitted along the principal axis of each 4x4 block and refined once with a least squares fit
+ * over the chosen indices. BC7 only uses mode 6 (single subset, RGBA endpoints with 4-bit indices), which is
+ * good enough for the offline cook and keeps the encoder small.
+ */
+class BlockCompression {
+public:
+    BlockCompression() = delete; //static class
+
+    enum class Format : uint8_t {
+        bc1,    // RGB, 8 bytes per block
+        bc5,    // RG, two BC4 channels, 16 bytes per block
+        bc7,    // RGBA, 16 bytes per block
+    };
+
+    /**
+     * @brief compresses a tightly packed RGBA8 image, partial blocks at the edges repeat the last row/column
+     */
+    static std::vector<uint8_t> compress(Format format, std::span<const uint8_t> rgba, uint32_t width, uint32_t height);
+
+    static uint32_t getBlockSize(Format format) { return format == Format::bc1 ? 8 : 16; }
+
+    //  a block is 16 RGBA8 texels in row order
+    static void encodeBC1(const uint8_t* block, uint8_t* out);
+    static void encodeBC5(const uint8_t* block, uint8_t* out);
+    static void encodeBC7(const uint8_t* block, uint8_t* out);
+
+private:
+    //  encodes one channel of the block, channel is the byte offset inside a texel
+    static void encodeBC4(const uint8_t* block, uint32_t channel, uint8_t* out);
+};
@@ -0,0 +1,45 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+#include "textureCooker.h"
+#include "../../engine/pixelConversion.h"
+
+//  usage: dp_texcook [--force] [model or directory...], cooks ../assets/models by default
+int main(int argc, char** argv) {
+    bool force{false};
+    std::vector<std::filesystem::path> paths{};
+
+    for (int i = 1; i < argc; ++i) {
+        std::string_view arg{argv[i]};
+        if (arg == "--force" || arg == "-f")
+            force = true;
+        else
+            paths.emplace_back(arg);
+    }
+
+    if (paths.empty())
+        paths.emplace_back("../assets/models");
+
+    TextureCooker cooker{force};
+
+    std::cout << "Pixel conversions run with " << PixelConversion::getIsaName(PixelConversion::getIsa()) << std::endl;
+
+    try {
+        for (const auto& path : paths)
+            cooker.cookPath(path);
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    std::cout << "Cooked " << cooker.getCookedCount() << " texture(s), " << cooker.getSkippedCount() << " up to date, "
+              << cooker.getFailedCount() << " failed" << std::endl;
+
+    return cooker.getFailedCount() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
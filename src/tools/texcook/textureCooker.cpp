@@ -0,0 +1,254 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#include "textureCooker.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <FreeImage.h>
+#include <vulkan/vulkan_core.h>
+
+#include "../../engine/ktxFile.h"
+#include "../../engine/pixelConversion.h"
+
+namespace {
+    uint8_t toUnorm8(float value) {
+        return static_cast<uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+    }
+}
+
+//  same texture types as ModelLoader::textureTypes, sRGB for everything but normals like the runtime path
+const std::array<TextureCooker::SlotTarget, 4> TextureCooker::slotTargets{
+    SlotTarget{aiTextureType_DIFFUSE, {.format = BlockCompression::Format::bc7, .isSrgb = true}},
+    SlotTarget{aiTextureType_NORMALS, {.format = BlockCompression::Format::bc5, .isNormalMap = true}},
+    SlotTarget{aiTextureType_SPECULAR, {.format = BlockCompression::Format::bc1, .isSrgb = true}},
+    SlotTarget{aiTextureType_SHININESS, {.format = BlockCompression::Format::bc1, .isSrgb = true}},
+};
+
+void TextureCooker::cookPath(const std::filesystem::path& path) {
+    if (!std::filesystem::is_directory(path)) {
+        cookModel(path);
+        return;
+    }
+
+    Assimp::Importer importer;
+
+    for (const auto& entry : std::filesystem::recursive_directory_iterator(path)) {
+        if (entry.is_regular_file() && importer.IsExtensionSupported(entry.path().extension().string()))
+            cookModel(entry.path());
+    }
+}
+
+void TextureCooker::cookModel(const std::filesystem::path& modelPath) {
+    Assimp::Importer importer;
+
+    //  only the materials are needed, skip every post process step
+    const aiScene* scene = importer.ReadFile(modelPath.string(), 0);
+    if (scene == nullptr) {
+        std::cerr << "WARNING: failed to import " << modelPath.string() << " (" << importer.GetErrorString() << ")" << std::endl;
+        return;
+    }
+
+    std::cout << "Cooking textures of " << modelPath.string() << std::endl;
+
+    for (uint32_t i = 0; i < scene->mNumMaterials; ++i) {
+        const aiMaterial& material = *scene->mMaterials[i];
+
+        for (const auto& slotTarget : slotTargets) {
+            aiString texName;
+            if (material.Get(AI_MATKEY_TEXTURE(slotTarget.textureType, 0), texName) != AI_SUCCESS)
+                continue;
+
+            std::filesystem::path sourcePath = modelPath.parent_path() / texName.C_Str();
+            std::filesystem::path cookedPath = std::filesystem::path{sourcePath}.replace_extension(".ktx2");
+
+            //  a texture bound to several slots is cooked for the first one only
+            if (!visitedTextures_.insert(sourcePath.lexically_normal()).second)
+                continue;
+
+            if (isUpToDate(sourcePath, cookedPath)) {
+                skippedCount_ += 1;
+                continue;
+            }
+
+            if (cookTexture(sourcePath, cookedPath, slotTarget.target))
+                cookedCount_ += 1;
+            else
+                failedCount_ += 1;
+        }
+    }
+}
+
+bool TextureCooker::cookTexture(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath, const Target& target) {
+    auto cookStart = std::chrono::steady_clock::now();
+
+    //  hashed before decoding, a source changing while it is being cooked makes the file stale rather than wrongly current
+    std::optional<uint64_t> sourceHash = KtxFile::hashSource(sourcePath.string());
+
+    Image image{};
+    if (!loadImage(sourcePath, image)) {
+        std::cerr << "WARNING: failed to decode " << sourcePath.string() << std::endl;
+        return false;
+    }
+
+    uint32_t width = image.width, height = image.height;
+
+    //  full mip chain down to 1x1, every level is compressed from the filtered RGBA level
+    std::vector<std::vector<uint8_t>> levels{};
+    while (true) {
+        levels.emplace_back(BlockCompression::compress(target.format, image.rgba, image.width, image.height));
+
+        if (image.width == 1 && image.height == 1)
+            break;
+
+        image = downsample(image, target);
+    }
+
+    if (!KtxFile::write(cookedPath.string(), getVkFormat(target), width, height, levels, sourceHash))
+        return false;
+
+    size_t cookedSize{0};
+    for (const auto& level : levels)
+        cookedSize += level.size();
+
+    auto cookTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - cookStart);
+    std::cout << "  " << cookedPath.filename().string() << ": " << width << "x" << height << ", " << levels.size() << " levels, "
+              << static_cast<double>(cookedSize) / (1024.0 * 1024.0) << " MB (" << static_cast<double>(width) * height * 4.0 / static_cast<double>(cookedSize)
+              << "x smaller than the RGBA base level) in " << cookTime.count() << " ms" << std::endl;
+
+    return true;
+}
+
+bool TextureCooker::loadImage(const std::filesystem::path& path, Image& image) {
+    //  FreeImage's plugin registry is global, initialize it once
+    static bool isFreeImageInitialized{false};
+    if (!isFreeImageInitialized) {
+        FreeImage_Initialise();
+        isFreeImageInitialized = true;
+    }
+
+    std::string fileName{path.string()};
+
+    FREE_IMAGE_FORMAT fif = FreeImage_GetFileType(fileName.c_str(), 0);
+    if (fif == FIF_UNKNOWN)
+        fif = FreeImage_GetFIFFromFilename(fileName.c_str());
+    if (fif == FIF_UNKNOWN)
+        return false;
+
+    FIBITMAP* sourceBitmap = FreeImage_Load(fif, fileName.c_str());
+    if (sourceBitmap == nullptr)
+        return false;
+
+    FIBITMAP* bitmap = FreeImage_ConvertTo32Bits(sourceBitmap);
+    FreeImage_Unload(sourceBitmap);
+    if (bitmap == nullptr)
+        return false;
+
+    image.width = FreeImage_GetWidth(bitmap);
+    image.height = FreeImage_GetHeight(bitmap);
+    image.rgba.resize(static_cast<size_t>(image.width) * image.height * 4);
+
+    //  keep FreeImage's bottom up row order, the runtime uploads decoded images the same way
+    size_t rowSize = static_cast<size_t>(image.width) * 4;
+    for (uint32_t y = 0; y < image.height; ++y)
+        std::memcpy(&image.rgba[y * rowSize], FreeImage_GetScanLine(bitmap, static_cast<int>(y)), rowSize);
+
+    //  FreeImage stores BGRA on little endian machines
+    if constexpr (FI_RGBA_RED == 2)
+        PixelConversion::swapRedBlue(image.rgba.data(), static_cast<size_t>(image.width) * image.height);
+
+    FreeImage_Unload(bitmap);
+    return image.width != 0 && image.height != 0;
+}
+
+TextureCooker::Image TextureCooker::downsample(const Image& image, const Target& target) {
+    Image result{
+        .width = std::max(image.width / 2, 1u),
+        .height = std::max(image.height / 2, 1u),
+    };
+    result.rgba.resize(static_cast<size_t>(result.width) * result.height * 4);
+
+    #pragma omp parallel for
+    for (int y = 0; y < static_cast<int>(result.height); ++y) {
+        //  averaged RGBA of the row, sRGB rows are converted back in one go
+        std::vector<float> row(static_cast<size_t>(result.width) * 4);
+
+        for (uint32_t x = 0; x < result.width; ++x) {
+            std::array<float, 4> sum{};
+
+            //  odd sizes clamp the footprint to the last row/column
+            for (uint32_t sy = 0; sy < 2; ++sy) {
+                for (uint32_t sx = 0; sx < 2; ++sx) {
+                    uint32_t srcX = std::min(x * 2 + sx, image.width - 1);
+                    uint32_t srcY = std::min(static_cast<uint32_t>(y) * 2 + sy, image.height - 1);
+                    const uint8_t* texel = &image.rgba[(static_cast<size_t>(srcY) * image.width + srcX) * 4];
+
+                    for (uint32_t c = 0; c < 4; ++c) {
+                        if (target.isNormalMap && c < 3)
+                            sum[c] += static_cast<float>(texel[c]) / 255.0f * 2.0f - 1.0f;
+                        else if (target.isSrgb && c < 3)
+                            sum[c] += PixelConversion::srgbToLinear(texel[c]);
+                        else
+                            sum[c] += static_cast<float>(texel[c]) / 255.0f;
+                    }
+                }
+            }
+
+            float* average = &row[x * 4];
+
+            if (target.isNormalMap) {
+                float length = std::sqrt(sum[0] * sum[0] + sum[1] * sum[1] + sum[2] * sum[2]);
+                std::array<float, 3> normal{0.0f, 0.0f, 1.0f};
+                if (length > 1e-6f)
+                    normal = {sum[0] / length, sum[1] / length, sum[2] / length};
+
+                for (uint32_t c = 0; c < 3; ++c)
+                    average[c] = normal[c] * 0.5f + 0.5f;
+            }
+            else {
+                for (uint32_t c = 0; c < 3; ++c)
+                    average[c] = sum[c] / 4.0f;
+            }
+            average[3] = sum[3] / 4.0f;
+        }
+
+        if (target.isSrgb && !target.isNormalMap)
+            PixelConversion::linearToSrgb(row, true);
+
+        uint8_t* dst = &result.rgba[static_cast<size_t>(y) * result.width * 4];
+        for (size_t i = 0; i < row.size(); ++i)
+            dst[i] = toUnorm8(row[i]);
+    }
+
+    return result;
+}
+
+uint32_t TextureCooker::getVkFormat(const Target& target) {
+    switch (target.format) {
+        case BlockCompression::Format::bc1:
+            return target.isSrgb ? VK_FORMAT_BC1_RGB_SRGB_BLOCK : VK_FORMAT_BC1_RGB_UNORM_BLOCK;
+        case BlockCompression::Format::bc5:
+            return VK_FORMAT_BC5_UNORM_BLOCK;
+        case BlockCompression::Format::bc7:
+            return target.isSrgb ? VK_FORMAT_BC7_SRGB_BLOCK : VK_FORMAT_BC7_UNORM_BLOCK;
+        default:
+            throw std::runtime_error("ERROR: Unsupported format type!");
+    }
+}
+
+bool TextureCooker::isUpToDate(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath) const {
+    if (force_)
+        return false;
+
+    //  compared by contents like at runtime, a checkout touching the source doesn't make it stale and an older
+    //  source restored from a backup does
+    auto ktx = KtxFile::open(cookedPath.string());
+    return ktx && ktx->getSourceHash().has_value() && ktx->isCookedFrom(sourcePath.string());
+}
@@ -0,0 +1,84 @@
+//
+// Created by Tonz on 18.10.2026.
+//
+
+#pragma once
+#include <array>
+#include <cstdint>
+#include <filesystem>
+#include <set>
+#include <vector>
+
+#include <assimp/material.h>
+
+#include "blockCompression.h"
+
+/**
+ * @brief converts the textures referenced by models into mip-mapped, block compressed KTX2 files
+ *
+ * The encoding is picked by the material slot a texture is bound to, the cooked file is written next to the
+ * source with a .ktx2 extension where Texture picks it up at runtime.
+ */
+class TextureCooker {
+public:
+    struct Target {
+        BlockCompression::Format format{};
+        bool isSrgb{};
+        bool isNormalMap{};
+    };
+
+    /**
+     * @param force cook textures even if the cooked file was made from the source as it is now
+     */
+    explicit TextureCooker(bool force) : force_(force) {}
+
+    /**
+     * @brief cooks the textures of every model found below path, or of the model at path
+     */
+    void cookPath(const std::filesystem::path& path);
+
+    void cookModel(const std::filesystem::path& modelPath);
+
+    /**
+     * @return false if the source couldn't be decoded or the result couldn't be written
+     */
+    static bool cookTexture(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath, const Target& target);
+
+    [[nodiscard]] uint32_t getCookedCount() const { return cookedCount_; }
+    [[nodiscard]] uint32_t getSkippedCount() const { return skippedCount_; }
+    [[nodiscard]] uint32_t getFailedCount() const { return failedCount_; }
+
+private:
+    struct SlotTarget {
+        aiTextureType textureType{};
+        Target target{};
+    };
+
+    static const std::array<SlotTarget, 4> slotTargets;
+
+    struct Image {
+        uint32_t width{};
+        uint32_t height{};
+        std::vector<uint8_t> rgba{};
+    };
+
+    static bool loadImage(const std::filesystem::path& path, Image& image);
+
+    /**
+     * @brief 2x2 box filter, averages in linear space for sRGB textures and renormalizes normal maps
+     */
+    static Image downsample(const Image& image, const Target& target);
+
+    static uint32_t getVkFormat(const Target& target);
+
+    bool isUpToDate(const std::filesystem::path& sourcePath, const std::filesystem::path& cookedPath) const;
+
+    bool force_{false};
+
+    //  textures already handled in this run, models often share them
+    std::set<std::filesystem::path> visitedTextures_{};
+
+    uint32_t cookedCount_{0};
+    uint32_t skippedCount_{0};
+    uint32_t failedCount_{0};
+};